@@ -0,0 +1,65 @@
+/*
+ * This file is part of the Ssstr string library.
+ * Copyright 2022-2023 Board of Regents of the University of Wisconsin System
+ * SPDX-License-Identifier: MIT
+ */
+
+#define SNIPPET
+#include "ss8str.h"
+#include <stdio.h>
+#undef SNIPPET
+
+#include <unity.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static size_t line_count = 0;
+static size_t line_bytes = 0;
+
+static void handle_line(ss8view line) {
+    ++line_count;
+    line_bytes += line.len;
+}
+
+void test_example_streambuf(void) {
+    FILE *fp = tmpfile();
+    for (int i = 0; i < 1000; ++i)
+        fprintf(fp, "line %d\n", i);
+    size_t const total = (size_t)ftell(fp);
+    rewind(fp);
+
+#define SNIPPET
+    ss8_streambuf sb;
+    ss8_streambuf_init(&sb);
+
+    char buf[256];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        ss8_streambuf_append_bytes(&sb, buf, n);
+        for (;;) {
+            ss8view data = ss8_streambuf_peek(&sb);
+            size_t nl = ss8_view_find_ch(data, 0, '\n');
+            if (nl == SIZE_MAX)
+                break;
+            handle_line(ss8_view_slice(data, 0, nl));
+            ss8_streambuf_consume(&sb, nl + 1);
+        }
+    }
+#undef SNIPPET
+
+    TEST_ASSERT_EQUAL_size_t(1000, line_count);
+    TEST_ASSERT_EQUAL_size_t(total - 1000, line_bytes);
+    TEST_ASSERT_EQUAL_size_t(0, ss8_streambuf_len(&sb));
+    fclose(fp);
+
+#define SNIPPET
+    ss8_streambuf_destroy(&sb);
+#undef SNIPPET
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_example_streambuf);
+    return UNITY_END();
+}
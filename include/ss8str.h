@@ -39,6 +39,73 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Search kernels use SSE2, SSSE3, or AVX2 when the compiler targets them.
+// With GCC or Clang on x86-64, the SSSE3 and AVX2 kernels are also built when
+// not targeted, and are used if the CPU supports them (checked on each call
+// with __builtin_cpu_supports()). The user-defined macros
+// SSSTR_CPU_HAS_SSSE3() and SSSTR_CPU_HAS_AVX2(), if any, decide instead,
+// whether or not the instruction set is targeted. Define
+// SSSTR_NO_RUNTIME_DISPATCH to use only the targeted kernels, or SSSTR_NO_SIMD
+// to use only the portable implementations.
+#ifndef SSSTR_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SSSTR_USE_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+#if defined(__GNUC__) && defined(__x86_64__) &&                               \
+    !defined(SSSTR_NO_RUNTIME_DISPATCH)
+#define SSSTR_RUNTIME_DISPATCH
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__) ||                                \
+    defined(SSSTR_RUNTIME_DISPATCH) // MSVC has no __SSSE3__
+#define SSSTR_USE_SSSE3
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__) || defined(SSSTR_RUNTIME_DISPATCH)
+#define SSSTR_USE_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+// SSSTR_TARGET_* mark kernels that may be built for an instruction set not
+// targeted by the compiler; SSSTR_HAVE_*() tell whether they can be called.
+// The user's SSSTR_CPU_HAS_*() take precedence, even for a targeted
+// instruction set, so that the lower tiers can be forced in any build.
+#if defined(__SSSE3__) || defined(__AVX2__) || !defined(SSSTR_USE_SSSE3)
+#define SSSTR_TARGET_SSSE3
+#ifdef SSSTR_CPU_HAS_SSSE3
+#define SSSTR_HAVE_SSSE3() SSSTR_CPU_HAS_SSSE3()
+#else
+#define SSSTR_HAVE_SSSE3() 1
+#endif
+#else
+#define SSSTR_TARGET_SSSE3 __attribute__((target("ssse3")))
+#ifdef SSSTR_CPU_HAS_SSSE3
+#define SSSTR_HAVE_SSSE3() SSSTR_CPU_HAS_SSSE3()
+#else
+#define SSSTR_HAVE_SSSE3() __builtin_cpu_supports("ssse3")
+#endif
+#endif
+#if defined(__AVX2__) || !defined(SSSTR_USE_AVX2)
+#define SSSTR_TARGET_AVX2
+#ifdef SSSTR_CPU_HAS_AVX2
+#define SSSTR_HAVE_AVX2() SSSTR_CPU_HAS_AVX2()
+#else
+#define SSSTR_HAVE_AVX2() 1
+#endif
+#else
+#define SSSTR_TARGET_AVX2 __attribute__((target("avx2")))
+#ifdef SSSTR_CPU_HAS_AVX2
+#define SSSTR_HAVE_AVX2() SSSTR_CPU_HAS_AVX2()
+#else
+#define SSSTR_HAVE_AVX2() __builtin_cpu_supports("avx2")
+#endif
+#endif
+
 // Names containing 'iNtErNaL' are internal to ssstr and should not be used by
 // user code.
 
@@ -120,16 +187,104 @@ extern "C" {
 #error All 3, or none, of the following macros must be defined: SSSTR_MALLOC, SSSTR_REALLOC, SSSTR_FREE
 #endif
 
+// Define SSSTR_MALLOC_USABLE_SIZE(ptr) to return the usable size of a block
+// allocated by SSSTR_MALLOC/SSSTR_REALLOC, so that string capacity includes
+// any slack left by the allocator. Or define SSSTR_USE_MALLOC_USABLE_SIZE to
+// use the platform's function with the default allocator (glibc
+// malloc_usable_size(), macOS malloc_size(), or Windows _msize()).
+#if defined(SSSTR_USE_MALLOC_USABLE_SIZE) && !defined(SSSTR_MALLOC_USABLE_SIZE)
+#define SSSTR_USING_DEFAULT_MALLOC_USABLE_SIZE
+#ifndef SSSTR_USING_DEFAULT_MALLOC
+#error SSSTR_MALLOC_USABLE_SIZE must be defined for custom SSSTR_MALLOC
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#define SSSTR_MALLOC_USABLE_SIZE(ptr) malloc_usable_size(ptr)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define SSSTR_MALLOC_USABLE_SIZE(ptr) malloc_size(ptr)
+#elif defined(_WIN32)
+#include <malloc.h>
+#define SSSTR_MALLOC_USABLE_SIZE(ptr) _msize(ptr)
+#else
+#error SSSTR_MALLOC_USABLE_SIZE must be defined on this platform
+#endif
+#endif
+
+// Optional sized versions of SSSTR_FREE and SSSTR_REALLOC, for allocators
+// that can make use of the size of the block (such as jemalloc's sdallocx()
+// or mimalloc's mi_free_size()). The size passed is always the size most
+// recently requested for the block, or the size reported for it by
+// SSSTR_MALLOC_USABLE_SIZE. They default to SSSTR_FREE/SSSTR_REALLOC.
+#ifndef SSSTR_FREE_SIZED
+#define SSSTR_USING_DEFAULT_FREE_SIZED
+#define SSSTR_FREE_SIZED(ptr, size) ((void)(size), SSSTR_FREE(ptr))
+#endif
+#ifndef SSSTR_REALLOC_SIZED
+#define SSSTR_USING_DEFAULT_REALLOC_SIZED
+#define SSSTR_REALLOC_SIZED(ptr, oldsize, newsize)                            \
+    ((void)(oldsize), SSSTR_REALLOC((ptr), (newsize)))
+#endif
+
 #ifdef __cplusplus
 #define SSSTR_CHARP_MALLOC(size) (char *)SSSTR_MALLOC(size)
-#define SSSTR_CHARP_REALLOC(ptr, size) (char *)SSSTR_REALLOC(ptr, size)
+#define SSSTR_CHARP_REALLOC_SIZED(ptr, oldsize, newsize)                      \
+    (char *)SSSTR_REALLOC_SIZED(ptr, oldsize, newsize)
 #define SSSTR_CHARP_MEMCHR(s, c, n) (char *)memchr((s), (c), (n))
 #else
 #define SSSTR_CHARP_MALLOC(size) SSSTR_MALLOC(size)
-#define SSSTR_CHARP_REALLOC(ptr, size) SSSTR_REALLOC(ptr, size)
+#define SSSTR_CHARP_REALLOC_SIZED(ptr, oldsize, newsize)                      \
+    SSSTR_REALLOC_SIZED(ptr, oldsize, newsize)
 #define SSSTR_CHARP_MEMCHR(s, c, n) memchr((s), (c), (n))
 #endif
 
+// Define SSSTR_USE_BUFFER_CACHE to keep freed string buffers of up to 512
+// bytes in a per-thread cache, from which later allocations are served.
+// SSSTR_BUFFER_CACHE_LIMIT(size) gives the maximum number of buffers to keep
+// in the size class of 'size' bytes. See ss8_flush_buffer_cache().
+#ifdef SSSTR_USE_BUFFER_CACHE
+#ifndef SSSTR_BUFFER_CACHE_LIMIT
+#define SSSTR_BUFFER_CACHE_LIMIT(size) 64
+#endif
+#ifndef SSSTR_THREAD_LOCAL
+#define SSSTR_USING_DEFAULT_THREAD_LOCAL
+#if defined(__cplusplus) && SSSTR_CPLUSPLUS_11
+#define SSSTR_THREAD_LOCAL thread_local
+#elif !defined(__cplusplus) && defined(__STDC_VERSION__) &&                   \
+    __STDC_VERSION__ >= 201112L
+#define SSSTR_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define SSSTR_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define SSSTR_THREAD_LOCAL __declspec(thread)
+#else
+#error SSSTR_USE_BUFFER_CACHE requires SSSTR_THREAD_LOCAL to be defined
+#endif
+#endif
+#endif
+
+// Define SSSTR_USE_ALLOCATORS to enable per-string allocators (see
+// ss8_init_with_allocator()) and arenas (see ss8_arena_init()). Without it,
+// those functions are not declared and strings carry no allocator checks.
+// Must be defined consistently across translation units that share ss8str
+// objects.
+
+// The growth policy (an ss8_growth_policy) for strings that have not been
+// given one with ss8_set_growth_policy(), and for other growing buffers.
+// SSSTR_GROWTH_PAGE_SIZE and SSSTR_GROWTH_PAGE_THRESHOLD configure
+// SS8_GROWTH_PAGED.
+#ifndef SSSTR_GROWTH_POLICY
+#define SSSTR_USING_DEFAULT_GROWTH_POLICY
+#define SSSTR_GROWTH_POLICY SS8_GROWTH_THREE_HALVES
+#endif
+#ifndef SSSTR_GROWTH_PAGE_SIZE
+#define SSSTR_USING_DEFAULT_GROWTH_PAGE_SIZE
+#define SSSTR_GROWTH_PAGE_SIZE 4096
+#endif
+#ifndef SSSTR_GROWTH_PAGE_THRESHOLD
+#define SSSTR_USING_DEFAULT_GROWTH_PAGE_THRESHOLD
+#define SSSTR_GROWTH_PAGE_THRESHOLD (128 * 1024)
+#endif
+
 // Customizable assert macro
 #ifndef SSSTR_ASSERT
 #define SSSTR_USING_DEFAULT_ASSERT
@@ -208,6 +363,28 @@ typedef union {
     char iNtErNaL_S[sizeof(struct ss8iNtErNaL_L)];
 } ss8str;
 
+#ifdef SSSTR_USE_ALLOCATORS
+// A custom allocator for the buffer of an individual ss8str; see
+// ss8_init_with_allocator(). The sizes passed to 'reallocate' and 'deallocate'
+// are those of the existing block.
+typedef struct {
+    void *(*allocate)(void *ctx, size_t size);
+    void *(*reallocate)(void *ctx, void *ptr, size_t oldsize, size_t newsize);
+    void (*deallocate)(void *ctx, void *ptr, size_t size);
+    void *ctx;
+} ss8_allocator;
+#endif
+
+// How the capacity of a string grows when it runs out; see
+// ss8_set_growth_policy().
+typedef enum {
+    SS8_GROWTH_DEFAULT = 0,  // Use SSSTR_GROWTH_POLICY
+    SS8_GROWTH_THREE_HALVES, // Grow by 1.5x
+    SS8_GROWTH_DOUBLE,       // Grow by 2x
+    SS8_GROWTH_SIZE_CLASS,   // Grow by 1.5x, then round up to a size class
+    SS8_GROWTH_PAGED         // Grow by 1.125x in whole pages once large
+} ss8_growth_policy;
+
 #if !defined(__cplusplus)
 #define SS8_STATIC_INITIALIZER                                                \
     {                                                                         \
@@ -225,6 +402,139 @@ typedef union {
     }())
 #endif
 
+// A precomputed set of bytes, for repeated character class searches. The set
+// is stored as two 16-byte tables indexed by the low nibble, so that the same
+// representation serves scalar lookup and SIMD classification with byte
+// shuffles: byte b is in the set iff bit ((b >> 4) & 7) of
+// iNtErNaL_bits[(b & 0x0f) | ((b & 0x80) >> 3)] is set.
+typedef struct {
+    unsigned char iNtErNaL_bits[32];
+} ss8_charset;
+
+// A needle preprocessed for repeated substring searches.
+typedef struct {
+    ss8str iNtErNaL_needle;
+    size_t iNtErNaL_shift[256];  // Forward bad-character shifts
+    size_t iNtErNaL_rshift[256]; // Backward bad-character shifts
+    size_t iNtErNaL_meanshift;   // Mean shifts over the needle's bytes
+    size_t iNtErNaL_rmeanshift;
+} ss8_searcher;
+
+// A set of patterns compiled into an Aho-Corasick automaton for simultaneous
+// searching.
+typedef struct {
+    ss8str iNtErNaL_patterns; // All patterns, concatenated
+    size_t *iNtErNaL_ends;    // End offset of each pattern in the above
+    size_t iNtErNaL_count;
+    size_t iNtErNaL_capacity; // Of iNtErNaL_ends
+    uint32_t *iNtErNaL_table; // Compiled automaton, or NULL
+    size_t iNtErNaL_tablesize; // Bytes allocated for iNtErNaL_table
+    uint32_t iNtErNaL_nstates;
+    uint32_t iNtErNaL_nclasses;
+    unsigned char iNtErNaL_class[256]; // Byte -> transition table column
+    ss8_charset iNtErNaL_start;        // Bytes leading out of the root
+    bool iNtErNaL_skip; // Whether to skip to iNtErNaL_start from the root
+} ss8_multisearch;
+
+// Called by ss8_multisearch_find_all() for each match; return false to stop.
+typedef bool (*ss8_multisearch_callback)(size_t pos, size_t pattern,
+                                         void *data);
+
+// A non-owning reference to 'len' bytes at 'ptr' (which is never NULL and
+// need not be null-terminated), such as a substring of an ss8str.
+typedef struct {
+    char const *ptr;
+    size_t len;
+} ss8view;
+
+// The state of an in-progress split of a string into fields separated by a
+// byte, a set of bytes, or a substring.
+typedef struct {
+    char const *iNtErNaL_pos; // Start of the next field
+    char const *iNtErNaL_end;
+    char const *iNtErNaL_delim; // Delimiter, if iNtErNaL_kind is 2
+    size_t iNtErNaL_delimlen;
+    size_t iNtErNaL_splits;      // Remaining number of splits allowed
+    ss8_charset iNtErNaL_set;    // Delimiter bytes, if iNtErNaL_kind is 1
+    char iNtErNaL_ch;            // Delimiter byte, if iNtErNaL_kind is 0
+    unsigned char iNtErNaL_kind; // 0: byte; 1: set; 2: substring
+    bool iNtErNaL_skip_empty;
+    bool iNtErNaL_done;
+} ss8_split;
+
+// A string under construction, stored as a list of chunks so that appending
+// never moves the contents already written. The first chunk is sized by the
+// first append and each following chunk doubles, up to a fixed maximum. All
+// chunks but the last are full.
+typedef struct {
+    char **iNtErNaL_chunks;
+    size_t iNtErNaL_nchunks;
+    size_t iNtErNaL_capacity;  // Of iNtErNaL_chunks
+    size_t iNtErNaL_len;       // Total length of the contents
+    size_t iNtErNaL_firstsize; // Size of the first chunk
+    size_t iNtErNaL_laststart; // Offset of the last chunk in the contents
+    size_t iNtErNaL_lastsize;  // Size of the last chunk
+} ss8_builder;
+
+struct ss8iNtErNaL_ropenode;
+
+// A string stored as a balanced tree (a treap) of short pieces, for efficient
+// editing of long strings.
+typedef struct {
+    struct ss8iNtErNaL_ropenode *iNtErNaL_root;
+    uint32_t iNtErNaL_seed; // State for generating node priorities
+} ss8_rope;
+
+// A position in an ss8_rope, for iterating over its bytes.
+typedef struct {
+    ss8_rope const *iNtErNaL_rope;
+    size_t iNtErNaL_pos;      // Position of the next byte
+    char const *iNtErNaL_ptr; // Next byte, within the current piece
+    char const *iNtErNaL_end; // End of the current piece
+} ss8_rope_cursor;
+
+// A string with a movable gap at the edit cursor, for efficient repeated
+// editing at nearby positions.
+typedef struct {
+    char *iNtErNaL_buf;
+    size_t iNtErNaL_bufsize;
+    size_t iNtErNaL_gapstart; // The cursor position
+    size_t iNtErNaL_gapend;   // Offset in buffer of the text after the cursor
+} ss8_gapbuf;
+
+// A buffer consumed from the front and appended to at the back, as when
+// parsing a stream of messages.
+typedef struct {
+    ss8str iNtErNaL_buf;
+    size_t iNtErNaL_head; // Start of the unconsumed data
+} ss8_streambuf;
+
+// A bounded FIFO queue of bytes stored in a circular buffer.
+typedef struct {
+    char *iNtErNaL_buf;
+    size_t iNtErNaL_capacity;
+    size_t iNtErNaL_head; // Offset of the first byte in the queue
+    size_t iNtErNaL_len;
+} ss8_ring;
+
+// A writable region of the buffer of an ss8_ring.
+typedef struct {
+    char *ptr;
+    size_t len;
+} ss8_ring_span;
+
+#ifdef SSSTR_USE_ALLOCATORS
+// A region from which string buffers are bump-allocated in chunks and
+// released all at once. Must not be moved while in use.
+typedef struct {
+    ss8_allocator iNtErNaL_alloc; // Allocates from this arena
+    char *iNtErNaL_chunk; // Current chunk; begins with link to previous chunk
+    size_t iNtErNaL_size; // Usable size of current chunk
+    size_t iNtErNaL_used; // Bytes used in current chunk
+    char *iNtErNaL_last;  // Most recent allocation, or NULL
+} ss8_arena;
+#endif
+
 // All public functions have their prototypes listed below, and this list is
 // parsed by the man page checking script. Internal functions (ss8iNtErNaL_*)
 // have their prototypes immediately before their definitions, to ensure that
@@ -233,6 +543,11 @@ typedef union {
 ///// BEGIN_DOCUMENTED_PROTOTYPES
 
 SSSTR_INLINE ss8str *ss8_init(ss8str *str);
+#ifdef SSSTR_USE_ALLOCATORS
+SSSTR_INLINE ss8str *ss8_init_with_allocator(ss8str *str,
+                                             ss8_allocator const *alloc);
+SSSTR_INLINE ss8_allocator const *ss8_get_allocator(ss8str const *str);
+#endif
 SSSTR_INLINE void ss8_destroy(ss8str *str);
 SSSTR_INLINE size_t ss8_len(ss8str const *str);
 SSSTR_INLINE bool ss8_is_empty(ss8str const *str);
@@ -252,6 +567,10 @@ SSSTR_INLINE void ss8_set_len(ss8str *str, size_t newlen);
 SSSTR_INLINE size_t ss8_grow_len(ss8str *str, size_t maxlen, size_t maxdelta);
 SSSTR_INLINE void ss8_set_len_to_cstrlen(ss8str *str);
 SSSTR_INLINE ss8str *ss8_shrink_to_fit(ss8str *str);
+SSSTR_INLINE ss8str *ss8_set_growth_policy(ss8str *str,
+                                           ss8_growth_policy policy);
+SSSTR_INLINE ss8_growth_policy ss8_get_growth_policy(ss8str const *str);
+SSSTR_INLINE void ss8_flush_buffer_cache(void);
 SSSTR_INLINE ss8str *ss8_clear(ss8str *str);
 SSSTR_INLINE ss8str *ss8_copy_bytes(ss8str *SSSTR_RESTRICT dest,
                                     char const *SSSTR_RESTRICT src,
@@ -322,6 +641,18 @@ SSSTR_INLINE ss8str *ss8_insert_ch(ss8str *dest, size_t pos, char ch);
 SSSTR_INLINE ss8str *ss8_cat_ch(ss8str *dest, char ch);
 SSSTR_INLINE ss8str *ss8_replace_ch(ss8str *dest, size_t pos, size_t len,
                                     char ch);
+SSSTR_INLINE ss8str *ss8_replace_all_bytes(ss8str *SSSTR_RESTRICT dest,
+                                           char const *SSSTR_RESTRICT needle,
+                                           size_t needlelen,
+                                           char const *SSSTR_RESTRICT src,
+                                           size_t srclen);
+SSSTR_INLINE ss8str *ss8_replace_all_cstr(ss8str *SSSTR_RESTRICT dest,
+                                          char const *SSSTR_RESTRICT needle,
+                                          char const *SSSTR_RESTRICT src);
+SSSTR_INLINE ss8str *ss8_replace_all(ss8str *SSSTR_RESTRICT dest,
+                                     ss8str const *SSSTR_RESTRICT needle,
+                                     ss8str const *SSSTR_RESTRICT src);
+SSSTR_INLINE ss8str *ss8_replace_all_ch(ss8str *dest, char needle, char ch);
 SSSTR_INLINE int ss8_cmp_bytes(ss8str const *lhs, char const *rhs,
                                size_t rhslen);
 SSSTR_INLINE int ss8_cmp_cstr(ss8str const *lhs, char const *rhs);
@@ -352,6 +683,23 @@ SSSTR_INLINE size_t ss8_rfind_ch(ss8str const *haystack, size_t start,
                                  char needle);
 SSSTR_INLINE size_t ss8_rfind_not_ch(ss8str const *haystack, size_t start,
                                      char needle);
+SSSTR_INLINE size_t ss8_count_bytes(ss8str const *haystack, size_t start,
+                                    char const *needle, size_t needlelen);
+SSSTR_INLINE size_t ss8_count_cstr(ss8str const *haystack, size_t start,
+                                   char const *needle);
+SSSTR_INLINE size_t ss8_count(ss8str const *haystack, size_t start,
+                              ss8str const *needle);
+SSSTR_INLINE size_t ss8_count_ch(ss8str const *haystack, size_t start,
+                                 char needle);
+SSSTR_INLINE size_t ss8_find_all_bytes(ss8str const *haystack, size_t start,
+                                       char const *needle, size_t needlelen,
+                                       size_t *positions, size_t maxcount);
+SSSTR_INLINE size_t ss8_find_all_cstr(ss8str const *haystack, size_t start,
+                                      char const *needle, size_t *positions,
+                                      size_t maxcount);
+SSSTR_INLINE size_t ss8_find_all(ss8str const *haystack, size_t start,
+                                 ss8str const *needle, size_t *positions,
+                                 size_t maxcount);
 SSSTR_INLINE size_t ss8_find_first_of_bytes(ss8str const *haystack,
                                             size_t start, char const *needles,
                                             size_t count);
@@ -384,6 +732,59 @@ SSSTR_INLINE size_t ss8_find_last_of(ss8str const *haystack, size_t start,
                                      ss8str const *needles);
 SSSTR_INLINE size_t ss8_find_last_not_of(ss8str const *haystack, size_t start,
                                          ss8str const *needles);
+SSSTR_INLINE ss8_charset *ss8_charset_init(ss8_charset *set,
+                                           ss8str const *chars);
+SSSTR_INLINE ss8_charset *ss8_charset_init_cstr(ss8_charset *set,
+                                                char const *chars);
+SSSTR_INLINE ss8_charset *ss8_charset_init_bytes(ss8_charset *set,
+                                                 char const *chars,
+                                                 size_t count);
+SSSTR_INLINE bool ss8_charset_contains(ss8_charset const *set, char ch);
+SSSTR_INLINE size_t ss8_find_first_of_set(ss8str const *haystack,
+                                          size_t start,
+                                          ss8_charset const *needles);
+SSSTR_INLINE size_t ss8_find_first_not_of_set(ss8str const *haystack,
+                                              size_t start,
+                                              ss8_charset const *needles);
+SSSTR_INLINE size_t ss8_find_last_of_set(ss8str const *haystack, size_t start,
+                                         ss8_charset const *needles);
+SSSTR_INLINE size_t ss8_find_last_not_of_set(ss8str const *haystack,
+                                             size_t start,
+                                             ss8_charset const *needles);
+SSSTR_INLINE ss8_searcher *ss8_searcher_init(ss8_searcher *searcher,
+                                             ss8str const *needle);
+SSSTR_INLINE ss8_searcher *ss8_searcher_init_cstr(ss8_searcher *searcher,
+                                                  char const *needle);
+SSSTR_INLINE ss8_searcher *ss8_searcher_init_bytes(ss8_searcher *searcher,
+                                                   char const *needle,
+                                                   size_t needlelen);
+SSSTR_INLINE void ss8_searcher_destroy(ss8_searcher *searcher);
+SSSTR_INLINE size_t ss8_searcher_find(ss8_searcher const *searcher,
+                                      ss8str const *haystack, size_t start);
+SSSTR_INLINE size_t ss8_searcher_rfind(ss8_searcher const *searcher,
+                                       ss8str const *haystack, size_t start);
+SSSTR_INLINE size_t ss8_searcher_count(ss8_searcher const *searcher,
+                                       ss8str const *haystack, size_t start);
+SSSTR_INLINE ss8_multisearch *ss8_multisearch_init(ss8_multisearch *ms);
+SSSTR_INLINE void ss8_multisearch_destroy(ss8_multisearch *ms);
+SSSTR_INLINE size_t ss8_multisearch_add(ss8_multisearch *ms,
+                                        ss8str const *pattern);
+SSSTR_INLINE size_t ss8_multisearch_add_cstr(ss8_multisearch *ms,
+                                             char const *pattern);
+SSSTR_INLINE size_t ss8_multisearch_add_bytes(ss8_multisearch *ms,
+                                              char const *pattern,
+                                              size_t patternlen);
+SSSTR_INLINE void ss8_multisearch_compile(ss8_multisearch *ms);
+SSSTR_INLINE size_t ss8_multisearch_find(ss8_multisearch const *ms,
+                                         ss8str const *haystack, size_t start,
+                                         size_t *pattern);
+SSSTR_INLINE bool ss8_multisearch_contains(ss8_multisearch const *ms,
+                                           ss8str const *haystack);
+SSSTR_INLINE size_t ss8_multisearch_find_all(ss8_multisearch const *ms,
+                                             ss8str const *haystack,
+                                             size_t start,
+                                             ss8_multisearch_callback callback,
+                                             void *data);
 SSSTR_INLINE bool ss8_starts_with_bytes(ss8str const *str, char const *prefix,
                                         size_t prefixlen);
 SSSTR_INLINE bool ss8_starts_with_cstr(ss8str const *str, char const *prefix);
@@ -423,6 +824,178 @@ SSSTR_INLINE ss8str *ss8_strip(ss8str *SSSTR_RESTRICT str,
 SSSTR_INLINE ss8str *ss8_lstrip_ch(ss8str *str, char ch);
 SSSTR_INLINE ss8str *ss8_rstrip_ch(ss8str *str, char ch);
 SSSTR_INLINE ss8str *ss8_strip_ch(ss8str *str, char ch);
+SSSTR_INLINE ss8str *ss8_lstrip_set(ss8str *str, ss8_charset const *chars);
+SSSTR_INLINE ss8str *ss8_rstrip_set(ss8str *str, ss8_charset const *chars);
+SSSTR_INLINE ss8str *ss8_strip_set(ss8str *str, ss8_charset const *chars);
+SSSTR_INLINE ss8view ss8_view(ss8str const *str);
+SSSTR_INLINE ss8view ss8_view_substr(ss8str const *str, size_t start,
+                                     size_t len);
+SSSTR_INLINE ss8view ss8_view_cstr(char const *cstr);
+SSSTR_INLINE ss8view ss8_view_bytes(char const *buf, size_t len);
+SSSTR_INLINE ss8view ss8_view_slice(ss8view view, size_t start, size_t len);
+SSSTR_INLINE ss8str *ss8_init_copy_view(ss8str *str, ss8view src);
+SSSTR_INLINE ss8str *ss8_copy_view(ss8str *dest, ss8view src);
+SSSTR_INLINE ss8str *ss8_cat_view(ss8str *dest, ss8view src);
+SSSTR_INLINE ss8str *ss8_cat_many(ss8str *dest, ss8view const *pieces,
+                                  size_t count);
+SSSTR_INLINE ss8str *ss8_join(ss8str *SSSTR_RESTRICT dest,
+                              ss8view const *pieces, size_t count,
+                              ss8str const *SSSTR_RESTRICT sep);
+SSSTR_INLINE ss8str *ss8_join_cstr(ss8str *SSSTR_RESTRICT dest,
+                                   ss8view const *pieces, size_t count,
+                                   char const *SSSTR_RESTRICT sep);
+SSSTR_INLINE ss8str *ss8_join_bytes(ss8str *SSSTR_RESTRICT dest,
+                                    ss8view const *pieces, size_t count,
+                                    char const *SSSTR_RESTRICT sep,
+                                    size_t seplen);
+SSSTR_INLINE ss8str *ss8_join_ch(ss8str *dest, ss8view const *pieces,
+                                 size_t count, char sep);
+SSSTR_INLINE int ss8_view_cmp(ss8view lhs, ss8view rhs);
+SSSTR_INLINE bool ss8_view_equals(ss8view lhs, ss8view rhs);
+SSSTR_INLINE bool ss8_view_starts_with(ss8view view, ss8view prefix);
+SSSTR_INLINE bool ss8_view_ends_with(ss8view view, ss8view suffix);
+SSSTR_INLINE size_t ss8_view_find(ss8view haystack, size_t start,
+                                  ss8view needle);
+SSSTR_INLINE size_t ss8_view_find_ch(ss8view haystack, size_t start,
+                                     char needle);
+SSSTR_INLINE size_t ss8_view_rfind(ss8view haystack, size_t start,
+                                   ss8view needle);
+SSSTR_INLINE size_t ss8_view_rfind_ch(ss8view haystack, size_t start,
+                                      char needle);
+SSSTR_INLINE ss8view ss8_view_lstrip(ss8view view, ss8view chars);
+SSSTR_INLINE ss8view ss8_view_rstrip(ss8view view, ss8view chars);
+SSSTR_INLINE ss8view ss8_view_strip(ss8view view, ss8view chars);
+SSSTR_INLINE void ss8_split_init(ss8_split *sp, ss8str const *str,
+                                 ss8str const *delim);
+SSSTR_INLINE void ss8_split_init_cstr(ss8_split *sp, ss8str const *str,
+                                      char const *delim);
+SSSTR_INLINE void ss8_split_init_bytes(ss8_split *sp, ss8str const *str,
+                                       char const *delim, size_t delimlen);
+SSSTR_INLINE void ss8_split_init_ch(ss8_split *sp, ss8str const *str,
+                                    char delim);
+SSSTR_INLINE void ss8_split_init_set(ss8_split *sp, ss8str const *str,
+                                     ss8_charset const *delims);
+SSSTR_INLINE void ss8_split_skip_empty(ss8_split *sp);
+SSSTR_INLINE void ss8_split_limit(ss8_split *sp, size_t maxsplit);
+SSSTR_INLINE bool ss8_split_next(ss8_split *sp, ss8view *field);
+SSSTR_INLINE size_t ss8_split_into_set(ss8str const *str, size_t start,
+                                       ss8_charset const *delims,
+                                       size_t *offsets, size_t maxfields);
+SSSTR_INLINE size_t ss8_split_into_bytes(ss8str const *str, size_t start,
+                                         char const *delims, size_t count,
+                                         size_t *offsets, size_t maxfields);
+SSSTR_INLINE size_t ss8_split_into_cstr(ss8str const *str, size_t start,
+                                        char const *delims, size_t *offsets,
+                                        size_t maxfields);
+SSSTR_INLINE size_t ss8_split_into(ss8str const *str, size_t start,
+                                   ss8str const *delims, size_t *offsets,
+                                   size_t maxfields);
+SSSTR_INLINE ss8_builder *ss8_builder_init(ss8_builder *b);
+SSSTR_INLINE void ss8_builder_destroy(ss8_builder *b);
+SSSTR_INLINE ss8_builder *ss8_builder_clear(ss8_builder *b);
+SSSTR_INLINE size_t ss8_builder_len(ss8_builder const *b);
+SSSTR_INLINE ss8_builder *ss8_builder_cat_bytes(ss8_builder *b,
+                                                char const *src,
+                                                size_t srclen);
+SSSTR_INLINE ss8_builder *ss8_builder_cat_cstr(ss8_builder *b,
+                                               char const *src);
+SSSTR_INLINE ss8_builder *ss8_builder_cat(ss8_builder *b, ss8str const *src);
+SSSTR_INLINE ss8_builder *ss8_builder_cat_ch(ss8_builder *b, char ch);
+SSSTR_INLINE ss8_builder *ss8_builder_cat_ch_n(ss8_builder *b, char ch,
+                                               size_t count);
+SSSTR_INLINE size_t ss8_builder_chunk_count(ss8_builder const *b);
+SSSTR_INLINE ss8view ss8_builder_chunk(ss8_builder const *b, size_t index);
+SSSTR_INLINE ss8str *ss8_builder_flatten(ss8_builder const *b,
+                                         ss8str *dest);
+SSSTR_INLINE size_t ss8_builder_fwrite(ss8_builder const *b, FILE *stream);
+SSSTR_INLINE ss8_rope *ss8_rope_init(ss8_rope *rope);
+SSSTR_INLINE void ss8_rope_destroy(ss8_rope *rope);
+SSSTR_INLINE ss8_rope *ss8_rope_clear(ss8_rope *rope);
+SSSTR_INLINE size_t ss8_rope_len(ss8_rope const *rope);
+SSSTR_INLINE ss8_rope *ss8_rope_copy_bytes(ss8_rope *rope, char const *src,
+                                           size_t srclen);
+SSSTR_INLINE ss8_rope *ss8_rope_copy_cstr(ss8_rope *rope, char const *src);
+SSSTR_INLINE ss8_rope *ss8_rope_copy(ss8_rope *rope, ss8str const *src);
+SSSTR_INLINE ss8str *ss8_rope_flatten(ss8_rope const *rope, ss8str *dest);
+SSSTR_INLINE ss8str *ss8_rope_copy_substr(ss8str *dest, ss8_rope const *rope,
+                                          size_t start, size_t len);
+SSSTR_INLINE char ss8_rope_at(ss8_rope const *rope, size_t pos);
+SSSTR_INLINE ss8_rope *ss8_rope_insert_bytes(ss8_rope *rope, size_t pos,
+                                             char const *src, size_t srclen);
+SSSTR_INLINE ss8_rope *ss8_rope_insert_cstr(ss8_rope *rope, size_t pos,
+                                            char const *src);
+SSSTR_INLINE ss8_rope *ss8_rope_insert(ss8_rope *rope, size_t pos,
+                                       ss8str const *src);
+SSSTR_INLINE ss8_rope *ss8_rope_erase(ss8_rope *rope, size_t pos, size_t len);
+SSSTR_INLINE ss8_rope_cursor *ss8_rope_cursor_init(ss8_rope_cursor *cur,
+                                                   ss8_rope const *rope,
+                                                   size_t pos);
+SSSTR_INLINE size_t ss8_rope_cursor_pos(ss8_rope_cursor const *cur);
+SSSTR_INLINE int ss8_rope_cursor_next(ss8_rope_cursor *cur);
+SSSTR_INLINE bool ss8_rope_cursor_next_chunk(ss8_rope_cursor *cur,
+                                             ss8view *chunk);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_init(ss8_gapbuf *gb);
+SSSTR_INLINE void ss8_gapbuf_destroy(ss8_gapbuf *gb);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_clear(ss8_gapbuf *gb);
+SSSTR_INLINE size_t ss8_gapbuf_len(ss8_gapbuf const *gb);
+SSSTR_INLINE size_t ss8_gapbuf_cursor(ss8_gapbuf const *gb);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_set_cursor(ss8_gapbuf *gb, size_t pos);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_copy_bytes(ss8_gapbuf *gb,
+                                               char const *src, size_t srclen);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_copy_cstr(ss8_gapbuf *gb, char const *src);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_copy(ss8_gapbuf *gb, ss8str const *src);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_insert_bytes(ss8_gapbuf *gb,
+                                                 char const *src,
+                                                 size_t srclen);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_insert_cstr(ss8_gapbuf *gb,
+                                                char const *src);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_insert(ss8_gapbuf *gb, ss8str const *src);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_insert_ch(ss8_gapbuf *gb, char ch);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_erase_before(ss8_gapbuf *gb, size_t len);
+SSSTR_INLINE ss8_gapbuf *ss8_gapbuf_erase_after(ss8_gapbuf *gb, size_t len);
+SSSTR_INLINE char ss8_gapbuf_at(ss8_gapbuf const *gb, size_t pos);
+SSSTR_INLINE ss8str *ss8_gapbuf_flatten(ss8_gapbuf const *gb, ss8str *dest);
+SSSTR_INLINE ss8_streambuf *ss8_streambuf_init(ss8_streambuf *sb);
+SSSTR_INLINE void ss8_streambuf_destroy(ss8_streambuf *sb);
+SSSTR_INLINE ss8_streambuf *ss8_streambuf_clear(ss8_streambuf *sb);
+SSSTR_INLINE size_t ss8_streambuf_len(ss8_streambuf const *sb);
+SSSTR_INLINE ss8_streambuf *ss8_streambuf_append_bytes(ss8_streambuf *sb,
+                                                       char const *src,
+                                                       size_t srclen);
+SSSTR_INLINE ss8_streambuf *ss8_streambuf_append_cstr(ss8_streambuf *sb,
+                                                      char const *src);
+SSSTR_INLINE ss8_streambuf *ss8_streambuf_append(ss8_streambuf *sb,
+                                                 ss8str const *src);
+SSSTR_INLINE ss8view ss8_streambuf_peek(ss8_streambuf const *sb);
+SSSTR_INLINE ss8_streambuf *ss8_streambuf_consume(ss8_streambuf *sb,
+                                                  size_t len);
+SSSTR_INLINE ss8_ring *ss8_ring_init(ss8_ring *ring, size_t capacity);
+SSSTR_INLINE void ss8_ring_destroy(ss8_ring *ring);
+SSSTR_INLINE ss8_ring *ss8_ring_clear(ss8_ring *ring);
+SSSTR_INLINE size_t ss8_ring_len(ss8_ring const *ring);
+SSSTR_INLINE size_t ss8_ring_capacity(ss8_ring const *ring);
+SSSTR_INLINE size_t ss8_ring_space(ss8_ring const *ring);
+SSSTR_INLINE size_t ss8_ring_read_spans(ss8_ring const *ring,
+                                        ss8view spans[2]);
+SSSTR_INLINE size_t ss8_ring_write_spans(ss8_ring *ring,
+                                         ss8_ring_span spans[2]);
+SSSTR_INLINE ss8_ring *ss8_ring_commit(ss8_ring *ring, size_t len);
+SSSTR_INLINE ss8_ring *ss8_ring_consume(ss8_ring *ring, size_t len);
+SSSTR_INLINE size_t ss8_ring_push_bytes(ss8_ring *ring, char const *src,
+                                        size_t srclen);
+SSSTR_INLINE size_t ss8_ring_push_cstr(ss8_ring *ring, char const *src);
+SSSTR_INLINE size_t ss8_ring_push(ss8_ring *ring, ss8str const *src);
+SSSTR_INLINE size_t ss8_ring_pop_bytes(ss8_ring *ring, char *dest,
+                                       size_t len);
+SSSTR_INLINE ss8str *ss8_ring_pop(ss8_ring *ring, ss8str *dest, size_t len);
+SSSTR_INLINE ss8str *ss8_ring_flatten(ss8_ring const *ring, ss8str *dest);
+#ifdef SSSTR_USE_ALLOCATORS
+SSSTR_INLINE ss8_arena *ss8_arena_init(ss8_arena *arena);
+SSSTR_INLINE void ss8_arena_destroy(ss8_arena *arena);
+SSSTR_INLINE ss8_arena *ss8_arena_clear(ss8_arena *arena);
+SSSTR_INLINE ss8_allocator const *ss8_arena_allocator(ss8_arena *arena);
+SSSTR_INLINE ss8str *ss8_init_in_arena(ss8str *str, ss8_arena *arena);
+#endif
 #if !defined(__cplusplus) || SSSTR_CPLUSPLUS_11
 SSSTR_ATTRIBUTE_VPRINTF(2)
 SSSTR_INLINE ss8str *ss8_cat_vsprintf(ss8str *SSSTR_RESTRICT dest,
@@ -454,6 +1027,13 @@ SSSTR_INLINE ss8str *ss8_cat_snprintf(ss8str *SSSTR_RESTRICT dest,
 SSSTR_ATTRIBUTE_PRINTF(3, 4)
 SSSTR_INLINE ss8str *ss8_snprintf(ss8str *SSSTR_RESTRICT dest, size_t maxlen,
                                   char const *SSSTR_RESTRICT fmt, ...);
+SSSTR_ATTRIBUTE_VPRINTF(2)
+SSSTR_INLINE ss8_builder *ss8_builder_cat_vsprintf(ss8_builder *b,
+                                                   char const *fmt,
+                                                   va_list args);
+SSSTR_ATTRIBUTE_PRINTF(2, 3)
+SSSTR_INLINE ss8_builder *ss8_builder_cat_sprintf(ss8_builder *b,
+                                                  char const *fmt, ...);
 #endif // C or SSSTR_CPLUSPLUS_11
 
 ///// END_DOCUMENTED_PROTOTYPES
@@ -462,6 +1042,282 @@ enum { ss8iNtErNaL_shortbufsiz = sizeof(ss8str) };
 enum { ss8iNtErNaL_shortcap = ss8iNtErNaL_shortbufsiz - 1 };
 #define ss8iNtErNaL_longmode ((char)-1)
 
+// Long-mode buffers whose bufsiz is at most ss8iNtErNaL_bufcache_maxsize are
+// allocated through the following functions. When SSSTR_USE_BUFFER_CACHE is
+// defined, such a buffer's allocated size is always that of the size class
+// containing its bufsiz, so that it can be recycled on free. Size classes are
+// 32, 48, 64, 96, ..., 384, 512 bytes.
+enum { ss8iNtErNaL_bufcache_minsize = 32 };
+enum { ss8iNtErNaL_bufcache_maxsize = 512 };
+enum { ss8iNtErNaL_bufcache_nclasses = 9 };
+
+#ifdef SSSTR_USE_BUFFER_CACHE
+// Singly linked free lists, with the link stored at the start of each buffer.
+typedef struct {
+    void *iNtErNaL_heads[ss8iNtErNaL_bufcache_nclasses];
+    size_t iNtErNaL_counts[ss8iNtErNaL_bufcache_nclasses];
+} ss8iNtErNaL_bufcache;
+
+#ifdef SSSTR_USE_NONSTATIC_INLINE
+extern SSSTR_THREAD_LOCAL ss8iNtErNaL_bufcache ss8iNtErNaL_the_bufcache;
+#ifdef SSSTR_DEFINE_EXTERN_INLINE
+SSSTR_THREAD_LOCAL ss8iNtErNaL_bufcache ss8iNtErNaL_the_bufcache;
+#endif
+#else
+static SSSTR_THREAD_LOCAL ss8iNtErNaL_bufcache ss8iNtErNaL_the_bufcache;
+#endif
+#endif
+
+// Return the buffer cache size class following 'classsize'.
+SSSTR_INLINE size_t ss8iNtErNaL_bufcache_next(size_t classsize);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_bufcache_next(size_t classsize) {
+    size_t const c = classsize;
+    return (c & (c - 1)) != 0 ? c / 3 * 4 : c / 2 * 3;
+}
+
+// Return the index of the buffer cache size class containing 'size' and set
+// *classsize to the size of the class; return ss8iNtErNaL_bufcache_nclasses
+// if 'size' is too large.
+SSSTR_INLINE size_t ss8iNtErNaL_bufcache_class(size_t size,
+                                               size_t *classsize);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_bufcache_class(size_t size,
+                                                   size_t *classsize) {
+    size_t c = ss8iNtErNaL_bufcache_minsize;
+    size_t i = 0;
+    while (c < size && i < ss8iNtErNaL_bufcache_nclasses) {
+        c = ss8iNtErNaL_bufcache_next(c);
+        ++i;
+    }
+    *classsize = c;
+    return i;
+}
+
+// Allocate a long-mode buffer for a bufsiz of 'bufsiz'. Return NULL on
+// failure.
+SSSTR_INLINE char *ss8iNtErNaL_alloc_buf(size_t bufsiz);
+SSSTR_INLINE_DEF char *ss8iNtErNaL_alloc_buf(size_t bufsiz) {
+#ifdef SSSTR_USE_BUFFER_CACHE
+    size_t classsize;
+    size_t const i = ss8iNtErNaL_bufcache_class(bufsiz, &classsize);
+    if (i < ss8iNtErNaL_bufcache_nclasses) {
+        ss8iNtErNaL_bufcache *cache = &ss8iNtErNaL_the_bufcache;
+        char *p = (char *)cache->iNtErNaL_heads[i];
+        if (p == NULL)
+            return SSSTR_CHARP_MALLOC(classsize);
+        memcpy(&cache->iNtErNaL_heads[i], p, sizeof(void *));
+        --cache->iNtErNaL_counts[i];
+        return p;
+    }
+#endif
+    return SSSTR_CHARP_MALLOC(bufsiz);
+}
+
+// Free the long-mode buffer 'p', whose bufsiz is 'bufsiz'.
+SSSTR_INLINE void ss8iNtErNaL_release_buf(char *p, size_t bufsiz);
+SSSTR_INLINE_DEF void ss8iNtErNaL_release_buf(char *p, size_t bufsiz) {
+#ifdef SSSTR_USE_BUFFER_CACHE
+    size_t classsize;
+    size_t const i = ss8iNtErNaL_bufcache_class(bufsiz, &classsize);
+    if (i < ss8iNtErNaL_bufcache_nclasses) {
+        ss8iNtErNaL_bufcache *cache = &ss8iNtErNaL_the_bufcache;
+        if (cache->iNtErNaL_counts[i] <
+            (size_t)(SSSTR_BUFFER_CACHE_LIMIT(classsize))) {
+            memcpy(p, &cache->iNtErNaL_heads[i], sizeof(void *));
+            cache->iNtErNaL_heads[i] = p;
+            ++cache->iNtErNaL_counts[i];
+            return;
+        }
+        SSSTR_FREE_SIZED(p, classsize);
+        return;
+    }
+#endif
+    SSSTR_FREE_SIZED(p, bufsiz);
+}
+
+// Resize the long-mode buffer 'p' from 'oldbufsiz' to 'bufsiz', preserving
+// the first 'copylen' bytes. Return NULL on failure, leaving 'p' untouched.
+SSSTR_INLINE char *ss8iNtErNaL_realloc_buf(char *p, size_t oldbufsiz,
+                                           size_t copylen, size_t bufsiz);
+SSSTR_INLINE_DEF char *ss8iNtErNaL_realloc_buf(char *p, size_t oldbufsiz,
+                                               size_t copylen, size_t bufsiz) {
+#ifdef SSSTR_USE_BUFFER_CACHE
+    size_t oldclass;
+    size_t newclass;
+    size_t const oldi = ss8iNtErNaL_bufcache_class(oldbufsiz, &oldclass);
+    size_t const newi = ss8iNtErNaL_bufcache_class(bufsiz, &newclass);
+    if (newi == oldi && newi < ss8iNtErNaL_bufcache_nclasses)
+        return p; // Already allocated at the class size.
+    if (oldi < ss8iNtErNaL_bufcache_nclasses ||
+        newi < ss8iNtErNaL_bufcache_nclasses) {
+        char *q = ss8iNtErNaL_alloc_buf(bufsiz);
+        if (q == NULL)
+            return NULL;
+        memcpy(q, p, copylen);
+        ss8iNtErNaL_release_buf(p, oldbufsiz);
+        return q;
+    }
+#else
+    (void)copylen;
+#endif
+    return SSSTR_CHARP_REALLOC_SIZED(p, oldbufsiz, bufsiz);
+}
+
+// Return the bufsiz to record for the long-mode buffer 'p', just obtained for
+// a bufsiz of 'bufsiz', including any slack reported by the allocator (or, for
+// a cached size class, the whole class).
+SSSTR_INLINE size_t ss8iNtErNaL_usable_bufsiz(char *p, size_t bufsiz);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_usable_bufsiz(char *p, size_t bufsiz) {
+#ifdef SSSTR_USE_BUFFER_CACHE
+    size_t classsize;
+    if (ss8iNtErNaL_bufcache_class(bufsiz, &classsize) <
+        ss8iNtErNaL_bufcache_nclasses)
+        return classsize; // Allocated at, and must stay in, its size class.
+#endif
+#ifdef SSSTR_MALLOC_USABLE_SIZE
+    size_t const usable = (size_t)(SSSTR_MALLOC_USABLE_SIZE(p));
+    return usable > bufsiz ? usable : bufsiz;
+#else
+    (void)p;
+    return bufsiz;
+#endif
+}
+
+// In long mode, this byte (which lies in the otherwise unused 'pad') is
+// nonzero if the string has an ss8_allocator. If it is 1, the buffer was
+// allocated by the allocator, whose address is stored in the allocated block,
+// just before the buffer. If it is ss8iNtErNaL_allocpending, the string has no
+// buffer yet and the allocator's address is stored in place of bufsiz. Such
+// strings never return to short mode.
+enum { ss8iNtErNaL_allocbyte = ss8iNtErNaL_shortbufsiz - 2 };
+enum { ss8iNtErNaL_allocpending = 2 };
+
+// In long mode, this byte (also in 'pad') holds the ss8_growth_policy given
+// by ss8_set_growth_policy(), or zero. Such strings never return to short
+// mode, either.
+enum { ss8iNtErNaL_growthbyte = ss8iNtErNaL_shortbufsiz - 3 };
+
+// A long-mode string may have no buffer: its len is then 0 and its capacity is
+// 0, so that any growth allocates. This allows a string to record an allocator
+// or growth policy (which needs long mode) before it needs any storage. Its
+// null terminator is this byte (also in 'pad'), so that no two strings share
+// storage. The ptr of such a string is set to point to this byte but is never
+// dereferenced, because it goes stale if the ss8str is relocated (e.g. by
+// ss8_move()); use ss8iNtErNaL_long_ptr() instead. Without an allocator, the
+// bufsiz of such a string is 1.
+enum { ss8iNtErNaL_nobufbyte = ss8iNtErNaL_shortbufsiz - 4 };
+
+// Return whether long-mode *str has no buffer.
+SSSTR_INLINE bool ss8iNtErNaL_lacks_buf(ss8str const *str);
+SSSTR_INLINE_DEF bool ss8iNtErNaL_lacks_buf(ss8str const *str) {
+#ifdef SSSTR_USE_ALLOCATORS
+    if (str->iNtErNaL_S[ss8iNtErNaL_allocbyte] == ss8iNtErNaL_allocpending)
+        return true;
+#endif
+    return str->iNtErNaL_L.bufsiz == 1;
+}
+
+// Set *str to the empty string in long mode with no buffer, no allocator, and
+// no growth policy.
+SSSTR_INLINE void ss8iNtErNaL_init_nobuf(ss8str *str);
+SSSTR_INLINE_DEF void ss8iNtErNaL_init_nobuf(ss8str *str) {
+    str->iNtErNaL_S[ss8iNtErNaL_nobufbyte] = '\0';
+    str->iNtErNaL_L.ptr = &str->iNtErNaL_S[ss8iNtErNaL_nobufbyte];
+    str->iNtErNaL_L.len = 0;
+    str->iNtErNaL_L.bufsiz = 1;
+    str->iNtErNaL_S[ss8iNtErNaL_allocbyte] = 0;
+    str->iNtErNaL_S[ss8iNtErNaL_growthbyte] = 0;
+    str->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1] = ss8iNtErNaL_longmode;
+}
+
+// Return the buffer of long-mode *str. For a string with no buffer, the
+// address is computed via uintptr_t so that GCC does not warn (with
+// -Warray-bounds and the like) about indexing beyond the ss8str on code paths
+// that only run for nonempty strings.
+SSSTR_INLINE char *ss8iNtErNaL_long_ptr(ss8str *str);
+SSSTR_INLINE_DEF char *ss8iNtErNaL_long_ptr(ss8str *str) {
+    if (ss8iNtErNaL_lacks_buf(str))
+        return (char *)((uintptr_t)str + ss8iNtErNaL_nobufbyte);
+    return str->iNtErNaL_L.ptr;
+}
+
+#ifdef SSSTR_USE_ALLOCATORS
+enum { ss8iNtErNaL_allochdr = sizeof(ss8_allocator const *) };
+
+// Give *str, which must have no buffer (see ss8iNtErNaL_init_nobuf()), the
+// allocator *alloc. The allocator's address is stored in place of bufsiz,
+// which must therefore be at least as large as a pointer.
+SSSTR_INLINE void ss8iNtErNaL_set_pending_allocator(
+    ss8str *str, ss8_allocator const *alloc);
+SSSTR_INLINE_DEF void
+ss8iNtErNaL_set_pending_allocator(ss8str *str, ss8_allocator const *alloc) {
+    memcpy(&str->iNtErNaL_L.bufsiz, &alloc, sizeof(alloc));
+    str->iNtErNaL_S[ss8iNtErNaL_allocbyte] = ss8iNtErNaL_allocpending;
+}
+
+// Return the allocator of long-mode *str, or NULL if it has none.
+SSSTR_INLINE ss8_allocator const *ss8iNtErNaL_allocator(ss8str const *str);
+SSSTR_INLINE_DEF ss8_allocator const *
+ss8iNtErNaL_allocator(ss8str const *str) {
+    char const allocbyte = str->iNtErNaL_S[ss8iNtErNaL_allocbyte];
+    if (allocbyte == 0)
+        return NULL;
+    ss8_allocator const *alloc;
+    if (allocbyte == ss8iNtErNaL_allocpending)
+        memcpy(&alloc, &str->iNtErNaL_L.bufsiz, sizeof(alloc));
+    else
+        memcpy(&alloc, str->iNtErNaL_L.ptr - ss8iNtErNaL_allochdr,
+               sizeof(alloc));
+    return alloc;
+}
+
+// Resize the buffer of long-mode *str, which must have an allocator, to
+// 'bufsiz' (which must exceed ss8iNtErNaL_shortbufsiz) and return it. If *str
+// has no buffer yet, it is allocated.
+SSSTR_INLINE char *ss8iNtErNaL_custom_realloc(ss8str *str, size_t bufsiz);
+SSSTR_INLINE_DEF char *ss8iNtErNaL_custom_realloc(ss8str *str,
+                                                  size_t bufsiz) {
+    ss8_allocator const *alloc = ss8iNtErNaL_allocator(str);
+    size_t const hdr = ss8iNtErNaL_allochdr;
+    if (bufsiz > SIZE_MAX - hdr)
+        SSSTR_OUT_OF_MEMORY(SIZE_MAX);
+    char *block;
+    if (str->iNtErNaL_S[ss8iNtErNaL_allocbyte] == ss8iNtErNaL_allocpending) {
+        block = (char *)alloc->allocate(alloc->ctx, hdr + bufsiz);
+        if (block == NULL)
+            SSSTR_OUT_OF_MEMORY(hdr + bufsiz);
+        memcpy(block, &alloc, sizeof(alloc));
+        block[hdr] = '\0';
+        str->iNtErNaL_S[ss8iNtErNaL_allocbyte] = 1;
+    } else {
+        block = (char *)alloc->reallocate(
+            alloc->ctx, str->iNtErNaL_L.ptr - hdr,
+            hdr + str->iNtErNaL_L.bufsiz, hdr + bufsiz);
+        if (block == NULL)
+            SSSTR_OUT_OF_MEMORY(hdr + bufsiz);
+    }
+    str->iNtErNaL_L.ptr = block + hdr;
+    str->iNtErNaL_L.bufsiz = bufsiz;
+    return block + hdr;
+}
+#endif
+
+// Deallocate the buffer, if any, of long-mode *str.
+SSSTR_INLINE void ss8iNtErNaL_free_buf(ss8str *str);
+SSSTR_INLINE_DEF void ss8iNtErNaL_free_buf(ss8str *str) {
+    if (ss8iNtErNaL_lacks_buf(str))
+        return;
+#ifdef SSSTR_USE_ALLOCATORS
+    ss8_allocator const *alloc = ss8iNtErNaL_allocator(str);
+    if (alloc != NULL) {
+        size_t const hdr = ss8iNtErNaL_allochdr;
+        alloc->deallocate(alloc->ctx, str->iNtErNaL_L.ptr - hdr,
+                          hdr + str->iNtErNaL_L.bufsiz);
+        return;
+    }
+#endif
+    ss8iNtErNaL_release_buf(str->iNtErNaL_L.ptr, str->iNtErNaL_L.bufsiz);
+}
+
 SSSTR_INLINE void ss8iNtErNaL_extra_assert_invariants(ss8str const *str);
 SSSTR_INLINE_DEF void ss8iNtErNaL_extra_assert_invariants(ss8str const *str) {
     // GCC may generate maybe-unused warnings (seen with GCC 12), which may or
@@ -482,6 +1338,14 @@ SSSTR_INLINE_DEF void ss8iNtErNaL_extra_assert_invariants(ss8str const *str) {
         SSSTR_EXTRA_ASSERT_MSG(
             "short string invariant",
             str->iNtErNaL_S[ss8iNtErNaL_shortcap - lastbyte] == '\0');
+    } else if (ss8iNtErNaL_lacks_buf(str)) {
+        SSSTR_EXTRA_ASSERT_MSG("long string invariant",
+                               str->iNtErNaL_L.len == 0);
+        SSSTR_EXTRA_ASSERT_MSG("long string invariant",
+                               str->iNtErNaL_L.ptr != NULL);
+        SSSTR_EXTRA_ASSERT_MSG("long string invariant",
+                               str->iNtErNaL_S[ss8iNtErNaL_nobufbyte] ==
+                                   '\0');
     } else {
         SSSTR_EXTRA_ASSERT_MSG("long string invariant",
                                str->iNtErNaL_L.bufsiz >
@@ -506,6 +1370,30 @@ SSSTR_INLINE_DEF ss8str *ss8_init(ss8str *str) {
     return str;
 }
 
+#ifdef SSSTR_USE_ALLOCATORS
+// Initialize the uninitialized *str to the empty string, with its buffer
+// allocated by *alloc (which must outlive *str), and return 'str'.
+SSSTR_INLINE_DEF ss8str *ss8_init_with_allocator(ss8str *str,
+                                                 ss8_allocator const *alloc) {
+    SSSTR_EXTRA_ASSERT(str != NULL);
+    SSSTR_EXTRA_ASSERT(alloc != NULL);
+    // Start in long mode, so that the allocator can be recorded, but without
+    // a buffer until one is needed.
+    ss8iNtErNaL_init_nobuf(str);
+    ss8iNtErNaL_set_pending_allocator(str, alloc);
+    return str;
+}
+
+// Return the allocator used by *str, or NULL if it uses the default.
+SSSTR_INLINE_DEF ss8_allocator const *ss8_get_allocator(ss8str const *str) {
+    SSSTR_EXTRA_ASSERT(str != NULL);
+    ss8iNtErNaL_extra_assert_invariants(str);
+    if (str->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1] != ss8iNtErNaL_longmode)
+        return NULL;
+    return ss8iNtErNaL_allocator(str);
+}
+#endif
+
 // Called when we make str invalid
 SSSTR_INLINE void ss8iNtErNaL_deinit(ss8str *str);
 SSSTR_INLINE_DEF void ss8iNtErNaL_deinit(ss8str *str) {
@@ -527,7 +1415,7 @@ SSSTR_INLINE_DEF void ss8_destroy(ss8str *str) {
     if (lastbyte == ss8iNtErNaL_longmode) {
         SSSTR_ASSERT_MSG("must not already be destroyed",
                          str->iNtErNaL_L.ptr != NULL);
-        SSSTR_FREE(str->iNtErNaL_L.ptr);
+        ss8iNtErNaL_free_buf(str);
     }
     ss8iNtErNaL_deinit(str);
 }
@@ -570,6 +1458,10 @@ SSSTR_INLINE_DEF size_t ss8iNtErNaL_bufsize(ss8str const *str) {
     char const lastbyte = str->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1];
     if (lastbyte != ss8iNtErNaL_longmode)
         return ss8iNtErNaL_shortbufsiz;
+#ifdef SSSTR_USE_ALLOCATORS
+    if (str->iNtErNaL_S[ss8iNtErNaL_allocbyte] == ss8iNtErNaL_allocpending)
+        return 1;
+#endif
     return str->iNtErNaL_L.bufsiz;
 }
 
@@ -587,7 +1479,7 @@ SSSTR_INLINE_DEF char *ss8_mutable_cstr(ss8str *str) {
     char const lastbyte = str->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1];
     if (lastbyte != ss8iNtErNaL_longmode)
         return str->iNtErNaL_S;
-    return str->iNtErNaL_L.ptr;
+    return ss8iNtErNaL_long_ptr(str);
 }
 
 // Return a non-owning const pointer to the C string held by *str.
@@ -651,9 +1543,11 @@ SSSTR_INLINE char *ss8iNtErNaL_reserve_impl(ss8str *str, size_t cap);
 SSSTR_INLINE_DEF char *ss8iNtErNaL_reserve_impl(ss8str *str, size_t cap) {
     if (cap == SIZE_MAX) // bufsiz would overflow
         SSSTR_OUT_OF_MEMORY(0);
+    if (cap < ss8iNtErNaL_shortbufsiz) // Only when *str has no buffer
+        cap = ss8iNtErNaL_shortbufsiz;
     char const lastbyte = str->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1];
     if (lastbyte != ss8iNtErNaL_longmode) {
-        char *p = SSSTR_CHARP_MALLOC(cap + 1);
+        char *p = ss8iNtErNaL_alloc_buf(cap + 1);
         if (p == NULL)
             SSSTR_OUT_OF_MEMORY(cap + 1);
         size_t const len = (size_t)(ss8iNtErNaL_shortcap - lastbyte);
@@ -662,19 +1556,27 @@ SSSTR_INLINE_DEF char *ss8iNtErNaL_reserve_impl(ss8str *str, size_t cap) {
 
         str->iNtErNaL_L.ptr = p;
         str->iNtErNaL_L.len = len;
-        str->iNtErNaL_L.bufsiz = cap + 1;
+        str->iNtErNaL_L.bufsiz = ss8iNtErNaL_usable_bufsiz(p, cap + 1);
+        str->iNtErNaL_S[ss8iNtErNaL_allocbyte] = 0;
+        str->iNtErNaL_S[ss8iNtErNaL_growthbyte] = 0;
         str->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1] = ss8iNtErNaL_longmode;
+#ifdef SSSTR_USE_ALLOCATORS
+    } else if (str->iNtErNaL_S[ss8iNtErNaL_allocbyte] != 0) {
+        return ss8iNtErNaL_custom_realloc(str, cap + 1);
+#endif
     } else {
         char *p = str->iNtErNaL_L.ptr;
         if (str->iNtErNaL_L.len > 0) {
-            p = SSSTR_CHARP_REALLOC(p, cap + 1);
+            p = ss8iNtErNaL_realloc_buf(p, str->iNtErNaL_L.bufsiz,
+                                        str->iNtErNaL_L.len + 1, cap + 1);
             if (p == NULL)
                 SSSTR_OUT_OF_MEMORY(cap + 1);
         } else {
             // When we don't need to copy the data, free+malloc is likely
             // faster (https://stackoverflow.com/a/39562813) (TODO: benchmark).
-            SSSTR_FREE(p);
-            p = SSSTR_CHARP_MALLOC(cap + 1);
+            if (!ss8iNtErNaL_lacks_buf(str))
+                ss8iNtErNaL_release_buf(p, str->iNtErNaL_L.bufsiz);
+            p = ss8iNtErNaL_alloc_buf(cap + 1);
             if (p == NULL) {
                 str->iNtErNaL_S[0] = '\0'; // longjmp() safety.
                 str->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1] =
@@ -683,7 +1585,7 @@ SSSTR_INLINE_DEF char *ss8iNtErNaL_reserve_impl(ss8str *str, size_t cap) {
             }
             p[0] = '\0';
         }
-        str->iNtErNaL_L.bufsiz = cap + 1;
+        str->iNtErNaL_L.bufsiz = ss8iNtErNaL_usable_bufsiz(p, cap + 1);
         str->iNtErNaL_L.ptr = p;
     }
     return str->iNtErNaL_L.ptr;
@@ -727,13 +1629,78 @@ SSSTR_INLINE_DEF size_t ss8iNtErNaL_three_halves(size_t s, size_t max) {
     return half <= max / 3 ? half * 3 : max;
 }
 
+// Round 's' up to a multiple of 'step', clamped to [0, max], without
+// overflow.
+SSSTR_INLINE size_t ss8iNtErNaL_round_up(size_t s, size_t step, size_t max);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_round_up(size_t s, size_t step,
+                                             size_t max) {
+    size_t const rem = s % step;
+    if (rem == 0)
+        return s <= max ? s : max;
+    return s <= max - (step - rem) ? s + (step - rem) : max;
+}
+
+// Round the buffer size 's' up to a size class, as used by typical
+// allocators: 4 classes per doubling, and multiples of 16 up to 128. Clamped
+// to [0, max].
+SSSTR_INLINE size_t ss8iNtErNaL_size_class(size_t s, size_t max);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_size_class(size_t s, size_t max) {
+    size_t step = 16;
+    while (step <= SIZE_MAX / 16 && s > step * 8)
+        step *= 2;
+    return ss8iNtErNaL_round_up(s, step, max);
+}
+
+// Return the capacity to grow to from 'cap' under growth policy 'policy'.
+// Must be cap < mincap.
+SSSTR_INLINE size_t ss8iNtErNaL_growcap_policy(ss8_growth_policy policy,
+                                               size_t cap, size_t mincap);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_growcap_policy(ss8_growth_policy policy,
+                                                   size_t cap,
+                                                   size_t mincap) {
+    size_t const maxcap = SIZE_MAX - 1; // Room for null terminator.
+    if (policy == SS8_GROWTH_DEFAULT)
+        policy = SSSTR_GROWTH_POLICY;
+    size_t newcap;
+    switch (policy) {
+    case SS8_GROWTH_DOUBLE:
+        newcap = cap <= maxcap / 2 ? cap * 2 : maxcap;
+        break;
+    case SS8_GROWTH_SIZE_CLASS:
+        newcap = ss8iNtErNaL_three_halves(cap, maxcap);
+        if (newcap < mincap)
+            newcap = mincap;
+        // Round the buffer size, not the capacity.
+        return ss8iNtErNaL_size_class(newcap + 1, SIZE_MAX) - 1;
+    case SS8_GROWTH_PAGED:
+        if (cap < (size_t)(SSSTR_GROWTH_PAGE_THRESHOLD)) {
+            newcap = ss8iNtErNaL_three_halves(cap, maxcap);
+            break;
+        }
+        newcap = cap <= maxcap - cap / 8 ? cap + cap / 8 : maxcap;
+        if (newcap < mincap)
+            newcap = mincap;
+        return ss8iNtErNaL_round_up(newcap + 1,
+                                    (size_t)(SSSTR_GROWTH_PAGE_SIZE),
+                                    SIZE_MAX) -
+               1;
+    default:
+        newcap = ss8iNtErNaL_three_halves(cap, maxcap);
+        break;
+    }
+    return newcap < mincap ? mincap : newcap;
+}
+
 // Increase the length of *str by no more than 'maxdelta' to an automatically
 // chosen length of no more than 'maxlen', leaving the extended portion
 // uninitialized, and return the change in length.
 SSSTR_INLINE_DEF size_t ss8_grow_len(ss8str *str, size_t maxlen,
                                      size_t maxdelta) {
     size_t const len = ss8_len(str);
-    size_t newlen = ss8iNtErNaL_three_halves(len, SIZE_MAX);
+    size_t newlen = len < SIZE_MAX - 1
+                        ? ss8iNtErNaL_growcap_policy(
+                              ss8_get_growth_policy(str), len, len + 1)
+                        : len;
 
     size_t const cap = ss8_capacity(str);
     if (newlen < cap)
@@ -767,26 +1734,114 @@ SSSTR_INLINE_DEF ss8str *ss8_shrink_to_fit(ss8str *str) {
     ss8iNtErNaL_extra_assert_invariants(str);
 
     char *lastbyte = &str->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1];
-    if (*lastbyte != ss8iNtErNaL_longmode)
+    if (*lastbyte != ss8iNtErNaL_longmode || ss8iNtErNaL_lacks_buf(str))
         return str;
 
     size_t const len = str->iNtErNaL_L.len;
-    if (len < ss8iNtErNaL_shortbufsiz) {
+    bool const keeplong = str->iNtErNaL_S[ss8iNtErNaL_allocbyte] != 0 ||
+                          str->iNtErNaL_S[ss8iNtErNaL_growthbyte] != 0;
+    if (len == 0 && keeplong) {
+        // Release the buffer, keeping the allocator and growth policy.
+        char const growth = str->iNtErNaL_S[ss8iNtErNaL_growthbyte];
+#ifdef SSSTR_USE_ALLOCATORS
+        ss8_allocator const *alloc = ss8iNtErNaL_allocator(str);
+#endif
+        ss8iNtErNaL_free_buf(str);
+        ss8iNtErNaL_init_nobuf(str);
+        str->iNtErNaL_S[ss8iNtErNaL_growthbyte] = growth;
+#ifdef SSSTR_USE_ALLOCATORS
+        if (alloc != NULL)
+            ss8iNtErNaL_set_pending_allocator(str, alloc);
+#endif
+        return str;
+    }
+    if (len < ss8iNtErNaL_shortbufsiz && !keeplong) {
         char *p = str->iNtErNaL_L.ptr;
+        size_t const bufsiz = str->iNtErNaL_L.bufsiz;
         // Use fixed len so that compiler can inline memcpy().
         memcpy(str->iNtErNaL_S, p, ss8iNtErNaL_shortbufsiz);
-        SSSTR_FREE(p);
+        ss8iNtErNaL_release_buf(p, bufsiz);
         *lastbyte = (char)(ss8iNtErNaL_shortcap - len);
-    } else if (len + 1 < str->iNtErNaL_L.bufsiz) {
-        char *p = SSSTR_CHARP_REALLOC(str->iNtErNaL_L.ptr, len + 1);
-        if (p == NULL)
-            SSSTR_OUT_OF_MEMORY(len + 1);
-        str->iNtErNaL_L.ptr = p;
-        str->iNtErNaL_L.bufsiz = len + 1;
+        return str;
+    }
+
+    // Stay in long mode, which requires bufsiz > shortbufsiz.
+    size_t const bufsiz =
+        len < ss8iNtErNaL_shortbufsiz ? ss8iNtErNaL_shortbufsiz + 1 : len + 1;
+    if (bufsiz >= str->iNtErNaL_L.bufsiz)
+        return str;
+#ifdef SSSTR_USE_ALLOCATORS
+    if (str->iNtErNaL_S[ss8iNtErNaL_allocbyte] != 0) {
+        ss8iNtErNaL_custom_realloc(str, bufsiz);
+        return str;
+    }
+#endif
+    char *p = ss8iNtErNaL_realloc_buf(str->iNtErNaL_L.ptr,
+                                      str->iNtErNaL_L.bufsiz, len + 1, bufsiz);
+    if (p == NULL)
+        SSSTR_OUT_OF_MEMORY(bufsiz);
+    str->iNtErNaL_L.ptr = p;
+    str->iNtErNaL_L.bufsiz = bufsiz;
+    return str;
+}
+
+// Set the growth policy of *str to 'policy' and return 'str'.
+SSSTR_INLINE_DEF ss8str *ss8_set_growth_policy(ss8str *str,
+                                               ss8_growth_policy policy) {
+    SSSTR_EXTRA_ASSERT(str != NULL);
+    SSSTR_ASSERT((int)policy >= 0 && (int)policy <= (int)SS8_GROWTH_PAGED);
+    ss8iNtErNaL_extra_assert_invariants(str);
+
+    char const lastbyte = str->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1];
+    if (lastbyte != ss8iNtErNaL_longmode) {
+        // Switch to long mode, so that the policy can be recorded. An empty
+        // string needs no buffer for that; otherwise, move the contents to
+        // the smallest buffer that long mode allows.
+        if (policy == SS8_GROWTH_DEFAULT)
+            return str;
+        if (lastbyte == ss8iNtErNaL_shortcap)
+            ss8iNtErNaL_init_nobuf(str);
+        else
+            ss8iNtErNaL_reserve_impl(str, ss8iNtErNaL_shortbufsiz);
+    } else if (policy == SS8_GROWTH_DEFAULT && ss8iNtErNaL_lacks_buf(str) &&
+               str->iNtErNaL_S[ss8iNtErNaL_allocbyte] == 0) {
+        // Nothing left to record, so return to short mode.
+        ss8_init(str);
+        return str;
     }
+    str->iNtErNaL_S[ss8iNtErNaL_growthbyte] = (char)policy;
     return str;
 }
 
+// Return the growth policy set for *str, or SS8_GROWTH_DEFAULT if none.
+SSSTR_INLINE_DEF ss8_growth_policy ss8_get_growth_policy(ss8str const *str) {
+    SSSTR_EXTRA_ASSERT(str != NULL);
+    ss8iNtErNaL_extra_assert_invariants(str);
+    if (str->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1] != ss8iNtErNaL_longmode)
+        return SS8_GROWTH_DEFAULT;
+    return (ss8_growth_policy)str->iNtErNaL_S[ss8iNtErNaL_growthbyte];
+}
+
+// Free the string buffers held in the calling thread's buffer cache.
+SSSTR_INLINE_DEF void ss8_flush_buffer_cache(void) {
+#ifdef SSSTR_USE_BUFFER_CACHE
+    ss8iNtErNaL_bufcache *cache = &ss8iNtErNaL_the_bufcache;
+    size_t classsize = ss8iNtErNaL_bufcache_minsize;
+    for (size_t i = 0; i < ss8iNtErNaL_bufcache_nclasses; ++i) {
+        void *p = cache->iNtErNaL_heads[i];
+        while (p != NULL) {
+            void *next;
+            memcpy(&next, p, sizeof(void *));
+            SSSTR_FREE_SIZED(p, classsize);
+            p = next;
+        }
+        cache->iNtErNaL_heads[i] = NULL;
+        cache->iNtErNaL_counts[i] = 0;
+        classsize = ss8iNtErNaL_bufcache_next(classsize);
+    }
+#endif
+}
+
 // Set *ss8 to the empty string and return 'str'.
 SSSTR_INLINE_DEF ss8str *ss8_clear(ss8str *str) {
     SSSTR_EXTRA_ASSERT(str != NULL);
@@ -797,7 +1852,7 @@ SSSTR_INLINE_DEF ss8str *ss8_clear(ss8str *str) {
         str->iNtErNaL_S[0] = '\0';
         *lastbyte = ss8iNtErNaL_shortcap;
     } else {
-        str->iNtErNaL_L.ptr[0] = '\0';
+        ss8iNtErNaL_long_ptr(str)[0] = '\0';
         str->iNtErNaL_L.len = 0;
     }
     return str;
@@ -839,8 +1894,7 @@ SSSTR_INLINE_DEF ss8str *ss8_copy_bytes(ss8str *SSSTR_RESTRICT dest,
     SSSTR_EXTRA_ASSERT(src != NULL);
     ss8iNtErNaL_extra_assert_no_overlap(dest, src, srclen);
 
-    ss8_reserve(ss8_clear(dest), srclen);
-    char *p = ss8_mutable_cstr(dest);
+    char *p = ss8iNtErNaL_reserve(ss8_clear(dest), srclen);
     memcpy(p, src, srclen);
     p[srclen] = '\0';
     ss8iNtErNaL_setlen(dest, srclen);
@@ -894,8 +1948,7 @@ SSSTR_INLINE_DEF ss8str *ss8_copy_ch_n(ss8str *dest, char ch, size_t count) {
     // TODO Short-string case (guaranteed capacity) can be optimized by fixed
     // memset().
 
-    ss8_reserve(ss8_clear(dest), count);
-    char *p = ss8_mutable_cstr(dest);
+    char *p = ss8iNtErNaL_reserve(ss8_clear(dest), count);
     memset(p, ch, count);
     p[count] = '\0';
     ss8iNtErNaL_setlen(dest, count);
@@ -1033,7 +2086,7 @@ SSSTR_INLINE_DEF ss8str *ss8_move(ss8str *SSSTR_RESTRICT dest,
     ss8_swap(dest, src);
 #else
     if (dest->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1] == ss8iNtErNaL_longmode)
-        SSSTR_FREE(dest->iNtErNaL_L.ptr);
+        ss8iNtErNaL_free_buf(dest);
     memcpy(dest, src, sizeof(ss8str));
     if (src->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1] == ss8iNtErNaL_longmode)
         ss8_init(src);
@@ -1130,23 +2183,23 @@ SSSTR_INLINE_DEF size_t ss8iNtErNaL_add_sizes(size_t s, size_t t) {
     return r;
 }
 
-// Must be cap < mincap.
+// Must be cap < mincap. Uses the default growth policy.
 SSSTR_INLINE size_t ss8iNtErNaL_growcap(size_t cap, size_t mincap);
 SSSTR_INLINE_DEF size_t ss8iNtErNaL_growcap(size_t cap, size_t mincap) {
-    size_t const maxcap = SIZE_MAX - 1; // Room for null terminator.
-    size_t const newcap = ss8iNtErNaL_three_halves(cap, maxcap);
-    if (newcap < mincap)
-        return mincap;
-    return newcap;
+    return ss8iNtErNaL_growcap_policy(SS8_GROWTH_DEFAULT, cap, mincap);
 }
 
-SSSTR_INLINE void ss8iNtErNaL_grow(ss8str *str, size_t mincap);
-SSSTR_INLINE_DEF void ss8iNtErNaL_grow(ss8str *str, size_t mincap) {
+// Ensure that *str has capacity of at least 'mincap', growing the buffer
+// according to the growth policy; return the buffer.
+SSSTR_INLINE char *ss8iNtErNaL_grow(ss8str *str, size_t mincap);
+SSSTR_INLINE_DEF char *ss8iNtErNaL_grow(ss8str *str, size_t mincap) {
     size_t const cap = ss8_capacity(str);
     if (mincap > cap) {
-        size_t const newcap = ss8iNtErNaL_growcap(cap, mincap);
-        ss8iNtErNaL_reserve_impl(str, newcap);
+        size_t const newcap = ss8iNtErNaL_growcap_policy(
+            ss8_get_growth_policy(str), cap, mincap);
+        return ss8iNtErNaL_reserve_impl(str, newcap);
     }
+    return ss8_mutable_cstr(str);
 }
 
 // Insert the 'srclen' bytes at 'src' at position 'pos' of *dest, shifting the
@@ -1162,8 +2215,7 @@ SSSTR_INLINE_DEF ss8str *ss8_insert_bytes(ss8str *SSSTR_RESTRICT dest,
     SSSTR_ASSERT(pos <= destlen);
     size_t const newlen = ss8iNtErNaL_add_sizes(destlen, srclen);
 
-    ss8iNtErNaL_grow(dest, newlen);
-    char *p = ss8_mutable_cstr(dest) + pos;
+    char *p = ss8iNtErNaL_grow(dest, newlen) + pos;
     memmove(p + srclen, p, destlen - pos + 1);
     memcpy(p, src, srclen);
     ss8iNtErNaL_setlen(dest, newlen);
@@ -1238,8 +2290,7 @@ SSSTR_INLINE_DEF ss8str *ss8_replace_bytes(ss8str *SSSTR_RESTRICT dest,
         len = destlen - pos;
     size_t const newlen = ss8iNtErNaL_add_sizes(destlen - len, srclen);
 
-    ss8iNtErNaL_grow(dest, newlen);
-    char *p = ss8_mutable_cstr(dest) + pos;
+    char *p = ss8iNtErNaL_grow(dest, newlen) + pos;
     memmove(p + srclen, p + len, destlen - pos - len + 1);
     memcpy(p, src, srclen);
     ss8iNtErNaL_setlen(dest, newlen);
@@ -1273,8 +2324,7 @@ SSSTR_INLINE_DEF ss8str *ss8_insert_ch_n(ss8str *dest, size_t pos, char ch,
     SSSTR_ASSERT(pos <= destlen);
     size_t const newlen = ss8iNtErNaL_add_sizes(destlen, count);
 
-    ss8iNtErNaL_grow(dest, newlen);
-    char *p = ss8_mutable_cstr(dest) + pos;
+    char *p = ss8iNtErNaL_grow(dest, newlen) + pos;
     memmove(p + count, p, destlen - pos + 1);
     memset(p, ch, count);
     ss8iNtErNaL_setlen(dest, newlen);
@@ -1298,8 +2348,7 @@ SSSTR_INLINE_DEF ss8str *ss8_replace_ch_n(ss8str *dest, size_t pos, size_t len,
         len = destlen - pos;
     size_t const newlen = ss8iNtErNaL_add_sizes(destlen - len, count);
 
-    ss8iNtErNaL_grow(dest, newlen);
-    char *p = ss8_mutable_cstr(dest) + pos;
+    char *p = ss8iNtErNaL_grow(dest, newlen) + pos;
     memmove(p + count, p + len, destlen - pos - len + 1);
     memset(p, ch, count);
     ss8iNtErNaL_setlen(dest, newlen);
@@ -1399,6 +2448,385 @@ SSSTR_INLINE_DEF bool ss8_equals_ch(ss8str const *lhs, char rhs) {
     return ss8_len(lhs) == 1 && ss8_cstr(lhs)[0] == rhs;
 }
 
+#ifdef SSSTR_USE_SSE2
+// Return the index of the lowest set bit of 'mask', which must be nonzero.
+SSSTR_INLINE unsigned ss8iNtErNaL_ctz(unsigned mask);
+SSSTR_INLINE_DEF unsigned ss8iNtErNaL_ctz(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+// Return the index of the highest set bit of 'mask', which must be nonzero.
+SSSTR_INLINE unsigned ss8iNtErNaL_bsr(unsigned mask);
+SSSTR_INLINE_DEF unsigned ss8iNtErNaL_bsr(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return (unsigned)index;
+#else
+    return 31u - (unsigned)__builtin_clz(mask);
+#endif
+}
+#endif
+
+// Find the critical factorization of the 'nlen' bytes at 'n' (nlen >= 1) for
+// the Two-Way algorithm (Crochemore & Perrin, 1991), or, if 'backward', of the
+// same bytes in reverse order. Return the start of the right half and set
+// *period to the period of the right half.
+SSSTR_INLINE size_t ss8iNtErNaL_critical_factorization(unsigned char const *n,
+                                                       size_t nlen,
+                                                       bool backward,
+                                                       size_t *period);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_critical_factorization(
+    unsigned char const *n, size_t nlen, bool backward, size_t *period) {
+    // Compute the maximal suffix under each of the two orderings of the
+    // alphabet; the longer of the two is a critical factorization. Suffix
+    // starts are tracked as (index - 1) so that SIZE_MAX stands for -1.
+    size_t ms[2], per[2];
+    for (int rev = 0; rev < 2; ++rev) {
+        size_t m = SIZE_MAX; // Last index of left half
+        size_t j = 0;        // Index of current candidate suffix
+        size_t k = 1;        // Offset into current period
+        size_t p = 1;        // Current period
+        while (j + k < nlen) {
+            unsigned char const a =
+                backward ? n[nlen - 1 - (j + k)] : n[j + k];
+            unsigned char const b =
+                backward ? n[nlen - 1 - (m + k)] : n[m + k];
+            if (a == b) {
+                if (k == p) {
+                    j += p;
+                    k = 1;
+                } else {
+                    ++k;
+                }
+            } else if ((a < b) != (rev != 0)) {
+                j += k;
+                k = 1;
+                p = j - m;
+            } else {
+                m = j++;
+                k = p = 1;
+            }
+        }
+        ms[rev] = m;
+        per[rev] = p;
+    }
+    int const r = ms[1] + 1 < ms[0] + 1 ? 0 : 1;
+    *period = per[r];
+    return ms[r] + 1;
+}
+
+// Two-Way substring search, which runs in time linear in hlen + nlen and
+// constant space. Requires 1 <= nlen; returns NULL if nlen > hlen.
+SSSTR_INLINE char const *ss8iNtErNaL_twoway(char const *h, size_t hlen,
+                                            char const *n, size_t nlen);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_twoway(char const *h, size_t hlen,
+                                                char const *n, size_t nlen) {
+    if (nlen > hlen)
+        return NULL;
+    unsigned char const *hh = (unsigned char const *)h;
+    unsigned char const *nn = (unsigned char const *)n;
+    size_t period;
+    size_t const suffix =
+        ss8iNtErNaL_critical_factorization(nn, nlen, false, &period);
+    size_t const last = hlen - nlen; // Last possible match position
+
+    if (memcmp(n, n + period, suffix) == 0) {
+        // Periodic needle: after a full match of the right half, a shift by
+        // the period preserves a known prefix ('memory') of the match.
+        size_t memory = 0;
+        for (size_t j = 0; j <= last;) {
+            size_t i = suffix > memory ? suffix : memory;
+            while (i < nlen && nn[i] == hh[i + j])
+                ++i;
+            if (i < nlen) {
+                j += i - suffix + 1;
+                memory = 0;
+                continue;
+            }
+            i = suffix;
+            while (i > memory && nn[i - 1] == hh[i - 1 + j])
+                --i;
+            if (i <= memory)
+                return h + j;
+            j += period;
+            memory = nlen - period;
+        }
+    } else {
+        // The halves do not overlap in any period, so the shift after a
+        // right-half match can be maximal.
+        size_t const shift =
+            (suffix > nlen - suffix ? suffix : nlen - suffix) + 1;
+        for (size_t j = 0; j <= last;) {
+            size_t i = suffix;
+            while (i < nlen && nn[i] == hh[i + j])
+                ++i;
+            if (i < nlen) {
+                j += i - suffix + 1;
+                continue;
+            }
+            i = suffix;
+            while (i > 0 && nn[i - 1] == hh[i - 1 + j])
+                --i;
+            if (i == 0)
+                return h + j;
+            j += shift;
+        }
+    }
+    return NULL;
+}
+
+// Mirror image of ss8iNtErNaL_twoway(), returning the last match. This runs
+// Two-Way on the haystack and needle read backward, using the critical
+// factorization of the reversed needle.
+SSSTR_INLINE char const *ss8iNtErNaL_rtwoway(char const *h, size_t hlen,
+                                             char const *n, size_t nlen);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_rtwoway(char const *h, size_t hlen,
+                                                 char const *n, size_t nlen) {
+    if (nlen > hlen)
+        return NULL;
+    // Byte x of the reversed haystack (needle) is *(hh - x) (*(nn - x)).
+    unsigned char const *hh = (unsigned char const *)h + hlen - 1;
+    unsigned char const *nn = (unsigned char const *)n + nlen - 1;
+    size_t period;
+    size_t const suffix = ss8iNtErNaL_critical_factorization(
+        (unsigned char const *)n, nlen, true, &period);
+    size_t const last = hlen - nlen; // Last possible match position
+
+    if (memcmp(n + nlen - suffix, n + nlen - period - suffix, suffix) == 0) {
+        size_t memory = 0;
+        for (size_t j = 0; j <= last;) {
+            size_t i = suffix > memory ? suffix : memory;
+            while (i < nlen && *(nn - i) == *(hh - (i + j)))
+                ++i;
+            if (i < nlen) {
+                j += i - suffix + 1;
+                memory = 0;
+                continue;
+            }
+            i = suffix;
+            while (i > memory && *(nn - (i - 1)) == *(hh - (i - 1 + j)))
+                --i;
+            if (i <= memory)
+                return h + (last - j);
+            j += period;
+            memory = nlen - period;
+        }
+    } else {
+        size_t const shift =
+            (suffix > nlen - suffix ? suffix : nlen - suffix) + 1;
+        for (size_t j = 0; j <= last;) {
+            size_t i = suffix;
+            while (i < nlen && *(nn - i) == *(hh - (i + j)))
+                ++i;
+            if (i < nlen) {
+                j += i - suffix + 1;
+                continue;
+            }
+            i = suffix;
+            while (i > 0 && *(nn - (i - 1)) == *(hh - (i - 1 + j)))
+                --i;
+            if (i == 0)
+                return h + (last - j);
+            j += shift;
+        }
+    }
+    return NULL;
+}
+
+// The substring search kernels below take a haystack of 'hlen' bytes at 'h'
+// and a needle of 'nlen' bytes at 'n', and return a pointer to the first match
+// or NULL. They require 2 <= nlen <= hlen.
+//
+// The kernels filter candidate positions by the first and last bytes of the
+// needle, which is fast on typical text but quadratic in the worst case (e.g.,
+// "aaa...ab" in "aaa...a"). To bound the work, they count the bytes spent
+// verifying rejected candidates and switch to ss8iNtErNaL_twoway() for the
+// rest of the haystack once this exceeds the number of bytes scanned so far
+// plus a fixed slack.
+enum { ss8iNtErNaL_memmem_slack = 1024 };
+
+SSSTR_INLINE char const *ss8iNtErNaL_memmem_scalar(char const *h, size_t hlen,
+                                                   char const *n, size_t nlen);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_memmem_scalar(char const *h,
+                                                       size_t hlen,
+                                                       char const *n,
+                                                       size_t nlen) {
+    char const last = n[nlen - 1];
+    char const *end = h + hlen - nlen + 1;
+    size_t wasted = 0;
+    for (char const *p = h; p < end; ++p) {
+        p = SSSTR_CHARP_MEMCHR(p, n[0], (size_t)(end - p));
+        if (p == NULL)
+            return NULL;
+        // Checking the last byte first avoids most calls to memcmp() when
+        // the first byte is common in the haystack.
+        if (p[nlen - 1] != last)
+            continue;
+        if (memcmp(p + 1, n + 1, nlen - 2) == 0)
+            return p;
+        wasted += nlen;
+        if (wasted > (size_t)(p - h) + ss8iNtErNaL_memmem_slack)
+            return ss8iNtErNaL_twoway(p + 1, (size_t)(h + hlen - p - 1), n,
+                                      nlen);
+    }
+    return NULL;
+}
+
+// Horspool search, advancing by skip[last byte of window] after each window.
+// Used without SIMD when the needle's skip table promises long shifts.
+SSSTR_INLINE char const *
+ss8iNtErNaL_memmem_horspool(char const *h, size_t hlen, char const *n,
+                            size_t nlen, size_t const *skip);
+SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_memmem_horspool(char const *h, size_t hlen, char const *n,
+                            size_t nlen, size_t const *skip) {
+    char const last = n[nlen - 1];
+    char const *end = h + hlen - nlen + 1;
+    size_t wasted = 0;
+    for (char const *p = h; p < end; p += skip[(unsigned char)p[nlen - 1]]) {
+        if (p[nlen - 1] != last)
+            continue;
+        if (memcmp(p, n, nlen - 1) == 0)
+            return p;
+        wasted += nlen;
+        if (wasted > (size_t)(p - h) + ss8iNtErNaL_memmem_slack)
+            return ss8iNtErNaL_twoway(p + 1, (size_t)(h + hlen - p - 1), n,
+                                      nlen);
+    }
+    return NULL;
+}
+
+#ifdef SSSTR_USE_SSE2
+// Compare the first and last bytes of the needle against 16 candidate
+// positions at a time, and call memcmp() only where both match.
+SSSTR_INLINE char const *ss8iNtErNaL_memmem_sse2(char const *h, size_t hlen,
+                                                 char const *n, size_t nlen,
+                                                 size_t const *skip);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_memmem_sse2(char const *h,
+                                                     size_t hlen,
+                                                     char const *n,
+                                                     size_t nlen,
+                                                     size_t const *skip) {
+    char const *p = h;
+    size_t wasted = 0;
+    if (hlen - nlen >= 15) {
+        __m128i const first = _mm_set1_epi8(n[0]);
+        __m128i const last = _mm_set1_epi8(n[nlen - 1]);
+        // Last block start for which the load at p + nlen - 1 is in range.
+        char const *const blockend = h + (hlen - nlen - 15);
+        while (p <= blockend) {
+            __m128i const f = _mm_loadu_si128((__m128i const *)p);
+            __m128i const l =
+                _mm_loadu_si128((__m128i const *)(p + nlen - 1));
+            unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(
+                _mm_cmpeq_epi8(f, first), _mm_cmpeq_epi8(l, last)));
+            while (mask != 0) {
+                char const *c = p + ss8iNtErNaL_ctz(mask);
+                if (memcmp(c + 1, n + 1, nlen - 2) == 0)
+                    return c;
+                wasted += nlen;
+                if (wasted > (size_t)(c - h) + ss8iNtErNaL_memmem_slack)
+                    return ss8iNtErNaL_twoway(
+                        c + 1, (size_t)(h + hlen - c - 1), n, nlen);
+                mask &= mask - 1;
+            }
+            // No match starts in [p, p + 16); a skip table lets us advance
+            // by the Horspool shift for the window at p + 15.
+            p += skip != NULL ? 15 + skip[(unsigned char)p[nlen + 14]] : 16;
+        }
+    }
+    if ((size_t)(h + hlen - p) < nlen)
+        return NULL;
+    return ss8iNtErNaL_memmem_scalar(p, (size_t)(h + hlen - p), n, nlen);
+}
+#endif
+
+#ifdef SSSTR_USE_AVX2
+// Like ss8iNtErNaL_memmem_sse2(), but 32 positions at a time.
+SSSTR_TARGET_AVX2 SSSTR_INLINE char const *
+ss8iNtErNaL_memmem_avx2(char const *h, size_t hlen, char const *n, size_t nlen,
+                        size_t const *skip);
+SSSTR_TARGET_AVX2 SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_memmem_avx2(char const *h, size_t hlen, char const *n, size_t nlen,
+                        size_t const *skip) {
+    char const *p = h;
+    size_t wasted = 0;
+    if (hlen - nlen >= 31) {
+        __m256i const first = _mm256_set1_epi8(n[0]);
+        __m256i const last = _mm256_set1_epi8(n[nlen - 1]);
+        char const *const blockend = h + (hlen - nlen - 31);
+        while (p <= blockend) {
+            __m256i const f = _mm256_loadu_si256((__m256i const *)p);
+            __m256i const l =
+                _mm256_loadu_si256((__m256i const *)(p + nlen - 1));
+            unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(
+                _mm256_cmpeq_epi8(f, first), _mm256_cmpeq_epi8(l, last)));
+            while (mask != 0) {
+                char const *c = p + ss8iNtErNaL_ctz(mask);
+                if (memcmp(c + 1, n + 1, nlen - 2) == 0)
+                    return c;
+                wasted += nlen;
+                if (wasted > (size_t)(c - h) + ss8iNtErNaL_memmem_slack)
+                    return ss8iNtErNaL_twoway(
+                        c + 1, (size_t)(h + hlen - c - 1), n, nlen);
+                mask &= mask - 1;
+            }
+            p += skip != NULL ? 31 + skip[(unsigned char)p[nlen + 30]] : 32;
+        }
+    }
+    if ((size_t)(h + hlen - p) < nlen)
+        return NULL;
+    return ss8iNtErNaL_memmem_sse2(p, (size_t)(h + hlen - p), n, nlen, skip);
+}
+#endif
+
+// Return a pointer to the first occurrence of the 'nlen' bytes at 'n' in the
+// 'hlen' bytes at 'h', or NULL if not found. If not NULL, 'skip' is the
+// needle's Horspool shift table, indexed by the window's last byte, which is
+// used to skip ahead after each rejected window or block of windows.
+SSSTR_INLINE char const *ss8iNtErNaL_memmem_skip(char const *h, size_t hlen,
+                                                 char const *n, size_t nlen,
+                                                 size_t const *skip);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_memmem_skip(char const *h,
+                                                     size_t hlen,
+                                                     char const *n,
+                                                     size_t nlen,
+                                                     size_t const *skip) {
+    if (nlen == 0)
+        return h;
+    if (nlen > hlen)
+        return NULL;
+    if (nlen == 1)
+        return SSSTR_CHARP_MEMCHR(h, n[0], hlen);
+#ifdef SSSTR_USE_AVX2
+    if (SSSTR_HAVE_AVX2())
+        return ss8iNtErNaL_memmem_avx2(h, hlen, n, nlen, skip);
+#endif
+#ifdef SSSTR_USE_SSE2
+    return ss8iNtErNaL_memmem_sse2(h, hlen, n, nlen, skip);
+#else
+    if (skip != NULL)
+        return ss8iNtErNaL_memmem_horspool(h, hlen, n, nlen, skip);
+    return ss8iNtErNaL_memmem_scalar(h, hlen, n, nlen);
+#endif
+}
+
+// Return a pointer to the first occurrence of the 'nlen' bytes at 'n' in the
+// 'hlen' bytes at 'h', or NULL if not found.
+SSSTR_INLINE char const *ss8iNtErNaL_memmem(char const *h, size_t hlen,
+                                            char const *n, size_t nlen);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_memmem(char const *h, size_t hlen,
+                                                char const *n, size_t nlen) {
+    return ss8iNtErNaL_memmem_skip(h, hlen, n, nlen, NULL);
+}
+
 // Return the first position at which the 'needlelen' bytes at 'needle' appears
 // in *haystack, starting the search at 'start'. Return SIZE_MAX if not found.
 SSSTR_INLINE_DEF size_t ss8_find_bytes(ss8str const *haystack, size_t start,
@@ -1408,18 +2836,9 @@ SSSTR_INLINE_DEF size_t ss8_find_bytes(ss8str const *haystack, size_t start,
     char const *h = ss8_cstr(haystack);
     size_t const haystacklen = ss8_len(haystack);
     SSSTR_ASSERT(start <= haystacklen);
-    if (needlelen == 0)
-        return start;
-    char const *begin = h + start;
-    char const *end = h + haystacklen - needlelen + 1;
-    for (char const *p = begin; p < end; ++p) {
-        p = SSSTR_CHARP_MEMCHR(p, needle[0], (size_t)(end - p));
-        if (p == NULL)
-            return SIZE_MAX;
-        if (memcmp(p, needle, needlelen) == 0)
-            return (size_t)(p - h);
-    }
-    return SIZE_MAX;
+    char const *p = ss8iNtErNaL_memmem(h + start, haystacklen - start, needle,
+                                       needlelen);
+    return p != NULL ? (size_t)(p - h) : SIZE_MAX;
 }
 
 // Return the first position at which the null-terminated string at 'needle'
@@ -1465,43 +2884,377 @@ SSSTR_INLINE_DEF size_t ss8_find_not_ch(ss8str const *haystack, size_t start,
     return SIZE_MAX;
 }
 
-// Return the last position at which the 'needlelen' bytes at 'needle' appears
-// in *haystack, starting the backward search at 'start'. Return SIZE_MAX if
-// not found.
-SSSTR_INLINE_DEF size_t ss8_rfind_bytes(ss8str const *haystack, size_t start,
-                                        char const *needle, size_t needlelen) {
-    SSSTR_EXTRA_ASSERT(needle != NULL);
-
-    char const *h = ss8_cstr(haystack);
-    size_t const haystacklen = ss8_len(haystack);
-    if (needlelen > haystacklen)
-        return SIZE_MAX;
-    SSSTR_ASSERT(start <= haystacklen);
-    if (needlelen == 0)
-        return start;
-    char const *end = h + haystacklen - needlelen + 1;
-    char const *rbegin = h + start;
-    if (rbegin >= end)
-        rbegin = end - 1;
-    // Avoid 'rend = h - 1' because GCC -Warray-bounds will flag it.
-
-    for (char const *p = rbegin; p >= h; --p) {
-        // Pay the price of a function call only when first byte matches.
-        if (*p != needle[0])
-            continue;
-        if (memcmp(p, needle, needlelen) == 0)
-            return (size_t)(p - h);
+// Return a pointer to the last occurrence of 'c' in the 'n' bytes at 's', or
+// NULL if not found.
+SSSTR_INLINE char const *ss8iNtErNaL_memrchr_scalar(char const *s, char c,
+                                                    size_t n);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_memrchr_scalar(char const *s, char c,
+                                                        size_t n) {
+#if defined(__GLIBC__) && defined(_GNU_SOURCE)
+    return (char const *)memrchr(s, c, n);
+#else
+    for (char const *p = s + n; p > s;) {
+        if (*--p == c)
+            return p;
     }
-    return SIZE_MAX;
+    return NULL;
+#endif
 }
 
-// Return the last position at which the null-terminated string at 'needle'
-// appears in *haystack, starting the backward search at 'start'. Return
-// SIZE_MAX if not found.
-SSSTR_INLINE_DEF size_t ss8_rfind_cstr(ss8str const *haystack, size_t start,
-                                       char const *needle) {
-    SSSTR_EXTRA_ASSERT(needle != NULL);
-    return ss8_rfind_bytes(haystack, start, needle, strlen(needle));
+#ifdef SSSTR_USE_SSE2
+SSSTR_INLINE char const *ss8iNtErNaL_memrchr_sse2(char const *s, char c,
+                                                  size_t n);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_memrchr_sse2(char const *s, char c,
+                                                      size_t n) {
+    __m128i const v = _mm_set1_epi8(c);
+    char const *p = s + n;
+    while ((size_t)(p - s) >= 16) {
+        p -= 16;
+        unsigned const mask = (unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const *)p), v));
+        if (mask != 0)
+            return p + ss8iNtErNaL_bsr(mask);
+    }
+    while (p > s) {
+        if (*--p == c)
+            return p;
+    }
+    return NULL;
+}
+#endif
+
+#ifdef SSSTR_USE_AVX2
+SSSTR_TARGET_AVX2 SSSTR_INLINE char const *
+ss8iNtErNaL_memrchr_avx2(char const *s, char c, size_t n);
+SSSTR_TARGET_AVX2 SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_memrchr_avx2(char const *s, char c, size_t n) {
+    __m256i const v = _mm256_set1_epi8(c);
+    char const *p = s + n;
+    while ((size_t)(p - s) >= 32) {
+        p -= 32;
+        unsigned const mask = (unsigned)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i const *)p), v));
+        if (mask != 0)
+            return p + ss8iNtErNaL_bsr(mask);
+    }
+    return ss8iNtErNaL_memrchr_sse2(s, c, (size_t)(p - s));
+}
+#endif
+
+SSSTR_INLINE char const *ss8iNtErNaL_memrchr(char const *s, char c, size_t n);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_memrchr(char const *s, char c,
+                                                 size_t n) {
+#ifdef SSSTR_USE_AVX2
+    if (SSSTR_HAVE_AVX2())
+        return ss8iNtErNaL_memrchr_avx2(s, c, n);
+#endif
+#ifdef SSSTR_USE_SSE2
+    return ss8iNtErNaL_memrchr_sse2(s, c, n);
+#else
+    return ss8iNtErNaL_memrchr_scalar(s, c, n);
+#endif
+}
+
+// Return the number of occurrences of 'c' in the 'n' bytes at 's'.
+SSSTR_INLINE size_t ss8iNtErNaL_memcount_scalar(char const *s, char c,
+                                                size_t n);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_memcount_scalar(char const *s, char c,
+                                                    size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i)
+        count += s[i] == c;
+    return count;
+}
+
+// The vectorized counting kernels subtract each block's comparison mask
+// (0xff, or -1, for each matching byte) from per-byte counters, which are
+// summed with psadbw before they can overflow (every 255 blocks).
+
+#ifdef SSSTR_USE_SSE2
+SSSTR_INLINE size_t ss8iNtErNaL_memcount_sse2(char const *s, char c,
+                                              size_t n);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_memcount_sse2(char const *s, char c,
+                                                  size_t n) {
+    __m128i const v = _mm_set1_epi8(c);
+    __m128i const zero = _mm_setzero_si128();
+    __m128i total = zero;
+    char const *p = s;
+    size_t blocks = n / 16;
+    while (blocks > 0) {
+        size_t const batch = blocks < 255 ? blocks : 255;
+        blocks -= batch;
+        __m128i counters = zero;
+        for (size_t i = 0; i < batch; ++i, p += 16) {
+            counters = _mm_sub_epi8(
+                counters,
+                _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const *)p), v));
+        }
+        total = _mm_add_epi64(total, _mm_sad_epu8(counters, zero));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, total);
+    return (size_t)(lanes[0] + lanes[1]) +
+           ss8iNtErNaL_memcount_scalar(p, c, (size_t)(s + n - p));
+}
+#endif
+
+#ifdef SSSTR_USE_AVX2
+SSSTR_TARGET_AVX2 SSSTR_INLINE size_t
+ss8iNtErNaL_memcount_avx2(char const *s, char c, size_t n);
+SSSTR_TARGET_AVX2 SSSTR_INLINE_DEF size_t
+ss8iNtErNaL_memcount_avx2(char const *s, char c, size_t n) {
+    __m256i const v = _mm256_set1_epi8(c);
+    __m256i const zero = _mm256_setzero_si256();
+    __m256i total = zero;
+    char const *p = s;
+    size_t blocks = n / 32;
+    while (blocks > 0) {
+        size_t const batch = blocks < 255 ? blocks : 255;
+        blocks -= batch;
+        __m256i counters = zero;
+        for (size_t i = 0; i < batch; ++i, p += 32) {
+            counters = _mm256_sub_epi8(
+                counters,
+                _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i const *)p), v));
+        }
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(counters, zero));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, total);
+    return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+           ss8iNtErNaL_memcount_sse2(p, c, (size_t)(s + n - p));
+}
+#endif
+
+SSSTR_INLINE size_t ss8iNtErNaL_memcount(char const *s, char c, size_t n);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_memcount(char const *s, char c,
+                                             size_t n) {
+#ifdef SSSTR_USE_AVX2
+    if (SSSTR_HAVE_AVX2())
+        return ss8iNtErNaL_memcount_avx2(s, c, n);
+#endif
+#ifdef SSSTR_USE_SSE2
+    return ss8iNtErNaL_memcount_sse2(s, c, n);
+#else
+    return ss8iNtErNaL_memcount_scalar(s, c, n);
+#endif
+}
+
+// The reverse substring search kernels are like the forward ones (see
+// ss8iNtErNaL_memmem()) but return the last match. They require
+// 2 <= nlen <= hlen. Like the forward kernels, they switch to
+// ss8iNtErNaL_rtwoway() for the rest of the haystack once the bytes spent
+// verifying rejected candidates exceed the bytes scanned (from the end) so far
+// plus ss8iNtErNaL_memmem_slack.
+
+SSSTR_INLINE char const *ss8iNtErNaL_rmemmem_scalar(char const *h,
+                                                    size_t hlen,
+                                                    char const *n,
+                                                    size_t nlen);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_rmemmem_scalar(char const *h,
+                                                        size_t hlen,
+                                                        char const *n,
+                                                        size_t nlen) {
+    char const last = n[nlen - 1];
+    char const *const top = h + hlen - nlen + 1;
+    size_t wasted = 0;
+    // Candidate match positions are [h, end).
+    for (char const *end = top; end > h;) {
+        char const *p = ss8iNtErNaL_memrchr(h, n[0], (size_t)(end - h));
+        if (p == NULL)
+            return NULL;
+        if (p[nlen - 1] == last) {
+            if (memcmp(p + 1, n + 1, nlen - 2) == 0)
+                return p;
+            wasted += nlen;
+            if (wasted > (size_t)(top - p) + ss8iNtErNaL_memmem_slack)
+                return ss8iNtErNaL_rtwoway(h, (size_t)(p - h) + nlen - 1, n,
+                                           nlen);
+        }
+        end = p;
+    }
+    return NULL;
+}
+
+// Mirror image of ss8iNtErNaL_memmem_horspool(), advancing backward by
+// skip[first byte of window].
+SSSTR_INLINE char const *
+ss8iNtErNaL_rmemmem_horspool(char const *h, size_t hlen, char const *n,
+                             size_t nlen, size_t const *skip);
+SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_rmemmem_horspool(char const *h, size_t hlen, char const *n,
+                             size_t nlen, size_t const *skip) {
+    size_t const top = hlen - nlen + 1;
+    size_t wasted = 0;
+    for (size_t pos = hlen - nlen;;) {
+        char const *p = h + pos;
+        if (p[0] == n[0]) {
+            if (memcmp(p + 1, n + 1, nlen - 1) == 0)
+                return p;
+            wasted += nlen;
+            if (wasted > top - pos + ss8iNtErNaL_memmem_slack)
+                return ss8iNtErNaL_rtwoway(h, pos + nlen - 1, n, nlen);
+        }
+        size_t const back = skip[(unsigned char)p[0]];
+        if (back > pos)
+            return NULL;
+        pos -= back;
+    }
+}
+
+#ifdef SSSTR_USE_SSE2
+SSSTR_INLINE char const *ss8iNtErNaL_rmemmem_sse2(char const *h, size_t hlen,
+                                                  char const *n, size_t nlen,
+                                                  size_t const *skip);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_rmemmem_sse2(char const *h,
+                                                      size_t hlen,
+                                                      char const *n,
+                                                      size_t nlen,
+                                                      size_t const *skip) {
+    __m128i const first = _mm_set1_epi8(n[0]);
+    __m128i const last = _mm_set1_epi8(n[nlen - 1]);
+    // Candidate match positions not yet examined are [h, p).
+    char const *const top = h + (hlen - nlen + 1);
+    char const *p = top;
+    size_t wasted = 0;
+    while ((size_t)(p - h) >= 16) {
+        p -= 16;
+        __m128i const f = _mm_loadu_si128((__m128i const *)p);
+        __m128i const l = _mm_loadu_si128((__m128i const *)(p + nlen - 1));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(f, first), _mm_cmpeq_epi8(l, last)));
+        while (mask != 0) {
+            unsigned const i = ss8iNtErNaL_bsr(mask);
+            if (memcmp(p + i + 1, n + 1, nlen - 2) == 0)
+                return p + i;
+            wasted += nlen;
+            if (wasted > (size_t)(top - p - i) + ss8iNtErNaL_memmem_slack)
+                return ss8iNtErNaL_rtwoway(h, (size_t)(p - h) + i + nlen - 1,
+                                           n, nlen);
+            mask &= ~(1u << i);
+        }
+        // No match starts in [p, p + 16); a skip table lets us move back by
+        // the (mirrored) Horspool shift for the window at p.
+        if (skip != NULL) {
+            size_t const back = skip[(unsigned char)*p] - 1;
+            p = back < (size_t)(p - h) ? p - back : h;
+        }
+    }
+    if (p == h)
+        return NULL;
+    return ss8iNtErNaL_rmemmem_scalar(h, (size_t)(p - h) + nlen - 1, n, nlen);
+}
+#endif
+
+#ifdef SSSTR_USE_AVX2
+SSSTR_TARGET_AVX2 SSSTR_INLINE char const *
+ss8iNtErNaL_rmemmem_avx2(char const *h, size_t hlen, char const *n,
+                         size_t nlen, size_t const *skip);
+SSSTR_TARGET_AVX2 SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_rmemmem_avx2(char const *h, size_t hlen, char const *n,
+                         size_t nlen, size_t const *skip) {
+    __m256i const first = _mm256_set1_epi8(n[0]);
+    __m256i const last = _mm256_set1_epi8(n[nlen - 1]);
+    char const *const top = h + (hlen - nlen + 1);
+    char const *p = top;
+    size_t wasted = 0;
+    while ((size_t)(p - h) >= 32) {
+        p -= 32;
+        __m256i const f = _mm256_loadu_si256((__m256i const *)p);
+        __m256i const l =
+            _mm256_loadu_si256((__m256i const *)(p + nlen - 1));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(f, first), _mm256_cmpeq_epi8(l, last)));
+        while (mask != 0) {
+            unsigned const i = ss8iNtErNaL_bsr(mask);
+            if (memcmp(p + i + 1, n + 1, nlen - 2) == 0)
+                return p + i;
+            wasted += nlen;
+            if (wasted > (size_t)(top - p - i) + ss8iNtErNaL_memmem_slack)
+                return ss8iNtErNaL_rtwoway(h, (size_t)(p - h) + i + nlen - 1,
+                                           n, nlen);
+            mask &= ~(1u << i);
+        }
+        if (skip != NULL) {
+            size_t const back = skip[(unsigned char)*p] - 1;
+            p = back < (size_t)(p - h) ? p - back : h;
+        }
+    }
+    if (p == h)
+        return NULL;
+    return ss8iNtErNaL_rmemmem_sse2(h, (size_t)(p - h) + nlen - 1, n, nlen,
+                                    skip);
+}
+#endif
+
+// Return a pointer to the last occurrence of the 'nlen' bytes at 'n' in the
+// 'hlen' bytes at 'h', or NULL if not found. If not NULL, 'skip' is the
+// needle's mirrored Horspool shift table, indexed by the window's first byte.
+SSSTR_INLINE char const *ss8iNtErNaL_rmemmem_skip(char const *h, size_t hlen,
+                                                  char const *n, size_t nlen,
+                                                  size_t const *skip);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_rmemmem_skip(char const *h,
+                                                      size_t hlen,
+                                                      char const *n,
+                                                      size_t nlen,
+                                                      size_t const *skip) {
+    if (nlen == 0)
+        return h + hlen;
+    if (nlen > hlen)
+        return NULL;
+    if (nlen == 1)
+        return ss8iNtErNaL_memrchr(h, n[0], hlen);
+#ifdef SSSTR_USE_AVX2
+    if (SSSTR_HAVE_AVX2())
+        return ss8iNtErNaL_rmemmem_avx2(h, hlen, n, nlen, skip);
+#endif
+#ifdef SSSTR_USE_SSE2
+    return ss8iNtErNaL_rmemmem_sse2(h, hlen, n, nlen, skip);
+#else
+    if (skip != NULL)
+        return ss8iNtErNaL_rmemmem_horspool(h, hlen, n, nlen, skip);
+    return ss8iNtErNaL_rmemmem_scalar(h, hlen, n, nlen);
+#endif
+}
+
+// Return a pointer to the last occurrence of the 'nlen' bytes at 'n' in the
+// 'hlen' bytes at 'h', or NULL if not found.
+SSSTR_INLINE char const *ss8iNtErNaL_rmemmem(char const *h, size_t hlen,
+                                             char const *n, size_t nlen);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_rmemmem(char const *h, size_t hlen,
+                                                 char const *n, size_t nlen) {
+    return ss8iNtErNaL_rmemmem_skip(h, hlen, n, nlen, NULL);
+}
+
+// Return the last position at which the 'needlelen' bytes at 'needle' appears
+// in *haystack, starting the backward search at 'start'. Return SIZE_MAX if
+// not found.
+SSSTR_INLINE_DEF size_t ss8_rfind_bytes(ss8str const *haystack, size_t start,
+                                        char const *needle, size_t needlelen) {
+    SSSTR_EXTRA_ASSERT(needle != NULL);
+
+    char const *h = ss8_cstr(haystack);
+    size_t const haystacklen = ss8_len(haystack);
+    if (needlelen > haystacklen)
+        return SIZE_MAX;
+    SSSTR_ASSERT(start <= haystacklen);
+    if (needlelen == 0)
+        return start;
+    size_t lastpos = haystacklen - needlelen;
+    if (start < lastpos)
+        lastpos = start;
+    char const *p =
+        ss8iNtErNaL_rmemmem(h, lastpos + needlelen, needle, needlelen);
+    return p != NULL ? (size_t)(p - h) : SIZE_MAX;
+}
+
+// Return the last position at which the null-terminated string at 'needle'
+// appears in *haystack, starting the backward search at 'start'. Return
+// SIZE_MAX if not found.
+SSSTR_INLINE_DEF size_t ss8_rfind_cstr(ss8str const *haystack, size_t start,
+                                       char const *needle) {
+    SSSTR_EXTRA_ASSERT(needle != NULL);
+    return ss8_rfind_bytes(haystack, start, needle, strlen(needle));
 }
 
 // Return the last position at which *needle appears in *haystack, starting the
@@ -1519,19 +3272,9 @@ SSSTR_INLINE_DEF size_t ss8_rfind_ch(ss8str const *haystack, size_t start,
     char const *h = ss8_cstr(haystack);
     size_t const haystacklen = ss8_len(haystack);
     SSSTR_ASSERT(start <= haystacklen);
-    if (haystacklen == 0)
-        return SIZE_MAX;
-    char const *end = h + haystacklen - 1 + 1;
-    char const *rbegin = h + start;
-    if (rbegin >= end)
-        rbegin = end - 1;
-    char const *rend = h - 1;
-
-    for (char const *p = rbegin; p > rend; --p) {
-        if (*p == needle)
-            return (size_t)(p - h);
-    }
-    return SIZE_MAX;
+    size_t const n = start < haystacklen ? start + 1 : haystacklen;
+    char const *p = ss8iNtErNaL_memrchr(h, needle, n);
+    return p != NULL ? (size_t)(p - h) : SIZE_MAX;
 }
 
 // Return the last position at which a character other than 'needle' appears in
@@ -1555,6 +3298,550 @@ SSSTR_INLINE_DEF size_t ss8_rfind_not_ch(ss8str const *haystack, size_t start,
     return SIZE_MAX;
 }
 
+// Return the number of non-overlapping occurrences of the 'needlelen' bytes at
+// 'needle' in *haystack, starting the search at 'start'.
+SSSTR_INLINE_DEF size_t ss8_count_bytes(ss8str const *haystack, size_t start,
+                                        char const *needle,
+                                        size_t needlelen) {
+    SSSTR_EXTRA_ASSERT(needle != NULL);
+
+    char const *h = ss8_cstr(haystack);
+    size_t const haystacklen = ss8_len(haystack);
+    SSSTR_ASSERT(start <= haystacklen);
+    if (needlelen == 0)
+        return haystacklen - start + 1;
+    if (needlelen == 1)
+        return ss8iNtErNaL_memcount(h + start, needle[0], haystacklen - start);
+    char const *const end = h + haystacklen;
+    size_t count = 0;
+    for (char const *p = h + start;; p += needlelen, ++count) {
+        p = ss8iNtErNaL_memmem(p, (size_t)(end - p), needle, needlelen);
+        if (p == NULL)
+            return count;
+    }
+}
+
+// Return the number of non-overlapping occurrences of the null-terminated
+// string at 'needle' in *haystack, starting the search at 'start'.
+SSSTR_INLINE_DEF size_t ss8_count_cstr(ss8str const *haystack, size_t start,
+                                       char const *needle) {
+    SSSTR_EXTRA_ASSERT(needle != NULL);
+    return ss8_count_bytes(haystack, start, needle, strlen(needle));
+}
+
+// Return the number of non-overlapping occurrences of *needle in *haystack,
+// starting the search at 'start'.
+SSSTR_INLINE_DEF size_t ss8_count(ss8str const *haystack, size_t start,
+                                  ss8str const *needle) {
+    return ss8_count_bytes(haystack, start, ss8_cstr(needle), ss8_len(needle));
+}
+
+// Return the number of occurrences of the character 'needle' in *haystack,
+// starting the search at 'start'.
+SSSTR_INLINE_DEF size_t ss8_count_ch(ss8str const *haystack, size_t start,
+                                     char needle) {
+    char const *h = ss8_cstr(haystack);
+    size_t const haystacklen = ss8_len(haystack);
+    SSSTR_ASSERT(start <= haystacklen);
+    return ss8iNtErNaL_memcount(h + start, needle, haystacklen - start);
+}
+
+// Store in 'positions' the positions of up to 'maxcount' non-overlapping
+// occurrences of the 'needlelen' bytes at 'needle' in *haystack, starting the
+// search at 'start'. Return the number of positions stored.
+SSSTR_INLINE_DEF size_t ss8_find_all_bytes(ss8str const *haystack,
+                                           size_t start, char const *needle,
+                                           size_t needlelen, size_t *positions,
+                                           size_t maxcount) {
+    SSSTR_EXTRA_ASSERT(needle != NULL);
+    SSSTR_EXTRA_ASSERT(positions != NULL || maxcount == 0);
+
+    char const *h = ss8_cstr(haystack);
+    size_t const haystacklen = ss8_len(haystack);
+    SSSTR_ASSERT(start <= haystacklen);
+    char const *const end = h + haystacklen;
+    char const *p = h + start;
+    size_t count = 0;
+    while (count < maxcount) {
+        char const *m =
+            ss8iNtErNaL_memmem(p, (size_t)(end - p), needle, needlelen);
+        if (m == NULL)
+            break;
+        positions[count++] = (size_t)(m - h);
+        if (m == end) // Empty needle at end.
+            break;
+        p = m + (needlelen > 0 ? needlelen : 1);
+    }
+    return count;
+}
+
+// Store in 'positions' the positions of up to 'maxcount' non-overlapping
+// occurrences of the null-terminated string at 'needle' in *haystack, starting
+// the search at 'start'. Return the number of positions stored.
+SSSTR_INLINE_DEF size_t ss8_find_all_cstr(ss8str const *haystack,
+                                          size_t start, char const *needle,
+                                          size_t *positions,
+                                          size_t maxcount) {
+    SSSTR_EXTRA_ASSERT(needle != NULL);
+    return ss8_find_all_bytes(haystack, start, needle, strlen(needle),
+                              positions, maxcount);
+}
+
+// Store in 'positions' the positions of up to 'maxcount' non-overlapping
+// occurrences of *needle in *haystack, starting the search at 'start'. Return
+// the number of positions stored.
+SSSTR_INLINE_DEF size_t ss8_find_all(ss8str const *haystack, size_t start,
+                                     ss8str const *needle, size_t *positions,
+                                     size_t maxcount) {
+    return ss8_find_all_bytes(haystack, start, ss8_cstr(needle),
+                              ss8_len(needle), positions, maxcount);
+}
+
+// Number of match offsets remembered by the counting scan of
+// ss8_replace_all_bytes(), so that the rewriting pass need not search for them
+// again.
+enum { ss8iNtErNaL_replace_all_memo = 64 };
+
+// Copy the bytes [r, end) to 'w', replacing the first (up to) 'count'
+// non-overlapping occurrences of the 'nlen' bytes at 'n' with the 'srclen'
+// bytes at 'src', and return the end of the written bytes. The first 'nmemo'
+// occurrences are already known to be at the given offsets from 'r'. The
+// destination may overlap the source as long as 'w' never passes the unread
+// source bytes. An empty needle matches before every byte and at the end.
+SSSTR_INLINE char *
+ss8iNtErNaL_replace_all_pass(char *w, char const *r, char const *end,
+                             size_t const *memo, size_t nmemo, size_t count,
+                             char const *n, size_t nlen, char const *src,
+                             size_t srclen);
+SSSTR_INLINE_DEF char *
+ss8iNtErNaL_replace_all_pass(char *w, char const *r, char const *end,
+                             size_t const *memo, size_t nmemo, size_t count,
+                             char const *n, size_t nlen, char const *src,
+                             size_t srclen) {
+    char const *const base = r;
+    for (size_t i = 0; i < count; ++i) {
+        char const *m =
+            i < nmemo ? base + memo[i]
+                      : ss8iNtErNaL_memmem(r, (size_t)(end - r), n, nlen);
+        if (m == NULL)
+            break;
+        memmove(w, r, (size_t)(m - r));
+        w += m - r;
+        memcpy(w, src, srclen);
+        w += srclen;
+        r = m + nlen;
+        if (nlen == 0 && r < end)
+            *w++ = *r++;
+    }
+    memmove(w, r, (size_t)(end - r));
+    return w + (end - r);
+}
+
+// Replace every non-overlapping occurrence, from left to right, of the
+// 'needlelen' bytes at 'needle' in *dest with the 'srclen' bytes at 'src';
+// return 'dest'.
+SSSTR_INLINE_DEF ss8str *
+ss8_replace_all_bytes(ss8str *SSSTR_RESTRICT dest,
+                      char const *SSSTR_RESTRICT needle, size_t needlelen,
+                      char const *SSSTR_RESTRICT src, size_t srclen) {
+    SSSTR_EXTRA_ASSERT(needle != NULL);
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    ss8iNtErNaL_extra_assert_no_overlap(dest, needle, needlelen);
+    ss8iNtErNaL_extra_assert_no_overlap(dest, src, srclen);
+
+    size_t const destlen = ss8_len(dest);
+    if (needlelen > 0 && srclen <= needlelen) {
+        // Not growing: rewrite in place in a single pass; the write position
+        // never passes the read position.
+        char *p = ss8_mutable_cstr(dest);
+        char *w = ss8iNtErNaL_replace_all_pass(p, p, p + destlen, NULL, 0,
+                                               SIZE_MAX, needle, needlelen,
+                                               src, srclen);
+        size_t const newlen = (size_t)(w - p);
+        if (newlen < destlen) {
+            p[newlen] = '\0';
+            ss8iNtErNaL_setlen(dest, newlen);
+        }
+        return dest;
+    }
+    if (srclen == 0) // Both empty.
+        return dest;
+
+    // Growing: count the matches to compute the final length.
+    size_t memo[ss8iNtErNaL_replace_all_memo];
+    size_t nmemo = 0;
+    size_t count = 0;
+    if (needlelen == 0) {
+        count = ss8iNtErNaL_add_sizes(destlen, 1);
+    } else {
+        char const *const h = ss8_cstr(dest);
+        char const *const end = h + destlen;
+        for (char const *m = h;; m += needlelen, ++count) {
+            m = ss8iNtErNaL_memmem(m, (size_t)(end - m), needle, needlelen);
+            if (m == NULL)
+                break;
+            if (nmemo < ss8iNtErNaL_replace_all_memo)
+                memo[nmemo++] = (size_t)(m - h);
+        }
+        if (count == 0)
+            return dest;
+    }
+
+    size_t const growth = srclen - needlelen;
+    if (count > (SIZE_MAX - destlen) / growth)
+        SSSTR_SIZE_OVERFLOW();
+    size_t const newlen = destlen + count * growth;
+    char *p = ss8iNtErNaL_grow(dest, newlen);
+    // Move the original string to the end of the buffer and rewrite it
+    // forward from the beginning, preserving left-to-right match semantics;
+    // the write position catches up with the read position by 'growth' bytes
+    // per replacement, which the move set aside.
+    memmove(p + (newlen - destlen), p, destlen);
+    ss8iNtErNaL_replace_all_pass(p, p + (newlen - destlen), p + newlen, memo,
+                                 nmemo, count, needle, needlelen, src,
+                                 srclen);
+    p[newlen] = '\0';
+    ss8iNtErNaL_setlen(dest, newlen);
+    return dest;
+}
+
+// Replace every non-overlapping occurrence, from left to right, of the
+// null-terminated string at 'needle' in *dest with the null-terminated string
+// at 'src'; return 'dest'.
+SSSTR_INLINE_DEF ss8str *
+ss8_replace_all_cstr(ss8str *SSSTR_RESTRICT dest,
+                     char const *SSSTR_RESTRICT needle,
+                     char const *SSSTR_RESTRICT src) {
+    SSSTR_EXTRA_ASSERT(needle != NULL);
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    return ss8_replace_all_bytes(dest, needle, strlen(needle), src,
+                                 strlen(src));
+}
+
+// Replace every non-overlapping occurrence, from left to right, of *needle in
+// *dest with *src; return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_replace_all(ss8str *SSSTR_RESTRICT dest,
+                                         ss8str const *SSSTR_RESTRICT needle,
+                                         ss8str const *SSSTR_RESTRICT src) {
+    return ss8_replace_all_bytes(dest, ss8_cstr(needle), ss8_len(needle),
+                                 ss8_cstr(src), ss8_len(src));
+}
+
+// Replace every occurrence of the character 'needle' in *dest with 'ch';
+// return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_replace_all_ch(ss8str *dest, char needle,
+                                            char ch) {
+    char *p = ss8_mutable_cstr(dest);
+    size_t const len = ss8_len(dest);
+    // Unconditional stores let the compiler vectorize this loop.
+    for (size_t i = 0; i < len; ++i)
+        p[i] = p[i] == needle ? ch : p[i];
+    return dest;
+}
+
+// Set *set to contain the 'count' bytes at 'chars' and return 'set'.
+SSSTR_INLINE_DEF ss8_charset *ss8_charset_init_bytes(ss8_charset *set,
+                                                     char const *chars,
+                                                     size_t count) {
+    SSSTR_EXTRA_ASSERT(set != NULL);
+    SSSTR_EXTRA_ASSERT(chars != NULL);
+    memset(set->iNtErNaL_bits, 0, sizeof(set->iNtErNaL_bits));
+    for (size_t i = 0; i < count; ++i) {
+        unsigned char const b = (unsigned char)chars[i];
+        set->iNtErNaL_bits[(b & 0x0f) | ((b & 0x80) >> 3)] |=
+            (unsigned char)(1u << ((b >> 4) & 7));
+    }
+    return set;
+}
+
+// Set *set to contain the characters of the null-terminated string at 'chars'
+// and return 'set'.
+SSSTR_INLINE_DEF ss8_charset *ss8_charset_init_cstr(ss8_charset *set,
+                                                    char const *chars) {
+    SSSTR_EXTRA_ASSERT(chars != NULL);
+    return ss8_charset_init_bytes(set, chars, strlen(chars));
+}
+
+// Set *set to contain the characters of *chars and return 'set'.
+SSSTR_INLINE_DEF ss8_charset *ss8_charset_init(ss8_charset *set,
+                                               ss8str const *chars) {
+    return ss8_charset_init_bytes(set, ss8_cstr(chars), ss8_len(chars));
+}
+
+// Return whether 'ch' is in *set.
+SSSTR_INLINE_DEF bool ss8_charset_contains(ss8_charset const *set, char ch) {
+    SSSTR_EXTRA_ASSERT(set != NULL);
+    unsigned char const b = (unsigned char)ch;
+    unsigned char const row =
+        set->iNtErNaL_bits[(b & 0x0f) | ((b & 0x80) >> 3)];
+    return (row >> ((b >> 4) & 7)) & 1;
+}
+
+// The character class kernels below return a pointer to the first (or, for
+// rfind, last) byte in [begin, end) whose membership in *set equals 'member',
+// or NULL if there is none.
+
+SSSTR_INLINE char const *
+ss8iNtErNaL_charset_find_scalar(ss8_charset const *set, char const *begin,
+                                char const *end, bool member);
+SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_charset_find_scalar(ss8_charset const *set, char const *begin,
+                                char const *end, bool member) {
+    for (char const *p = begin; p < end; ++p) {
+        if (ss8_charset_contains(set, *p) == member)
+            return p;
+    }
+    return NULL;
+}
+
+SSSTR_INLINE char const *
+ss8iNtErNaL_charset_rfind_scalar(ss8_charset const *set, char const *begin,
+                                 char const *end, bool member);
+SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_charset_rfind_scalar(ss8_charset const *set, char const *begin,
+                                 char const *end, bool member) {
+    for (char const *p = end; p > begin;) {
+        if (ss8_charset_contains(set, *--p) == member)
+            return p;
+    }
+    return NULL;
+}
+
+#ifdef SSSTR_USE_SSSE3
+// Return a 16-bit mask of the bytes of 'x' that are in the set given by the
+// two halves ('lo' and 'hi') of the set's table.
+SSSTR_TARGET_SSSE3 SSSTR_INLINE unsigned
+ss8iNtErNaL_charset_mask_ssse3(__m128i lo, __m128i hi, __m128i x);
+SSSTR_TARGET_SSSE3 SSSTR_INLINE_DEF unsigned
+ss8iNtErNaL_charset_mask_ssse3(__m128i lo, __m128i hi, __m128i x) {
+    __m128i const bitpos = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2,
+                                         4, 8, 16, 32, 64, -128);
+    // Shuffle yields zero where the index has its high bit set, so each
+    // lookup only hits for bytes belonging to its half of the table.
+    __m128i const row = _mm_or_si128(
+        _mm_shuffle_epi8(lo, x),
+        _mm_shuffle_epi8(hi, _mm_xor_si128(x, _mm_set1_epi8(-128))));
+    __m128i const hinibble =
+        _mm_and_si128(_mm_srli_epi16(x, 4), _mm_set1_epi8(0x0f));
+    __m128i const bit = _mm_shuffle_epi8(bitpos, hinibble);
+    return (unsigned)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit));
+}
+
+SSSTR_TARGET_SSSE3 SSSTR_INLINE char const *
+ss8iNtErNaL_charset_find_ssse3(ss8_charset const *set, char const *begin,
+                               char const *end, bool member);
+SSSTR_TARGET_SSSE3 SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_charset_find_ssse3(ss8_charset const *set, char const *begin,
+                               char const *end, bool member) {
+    __m128i const lo = _mm_loadu_si128((__m128i const *)set->iNtErNaL_bits);
+    __m128i const hi =
+        _mm_loadu_si128((__m128i const *)(set->iNtErNaL_bits + 16));
+    unsigned const flip = member ? 0 : 0xffff;
+    char const *p = begin;
+    for (; end - p >= 16; p += 16) {
+        __m128i const x = _mm_loadu_si128((__m128i const *)p);
+        unsigned const mask = ss8iNtErNaL_charset_mask_ssse3(lo, hi, x) ^ flip;
+        if (mask != 0)
+            return p + ss8iNtErNaL_ctz(mask);
+    }
+    return ss8iNtErNaL_charset_find_scalar(set, p, end, member);
+}
+
+SSSTR_TARGET_SSSE3 SSSTR_INLINE char const *
+ss8iNtErNaL_charset_rfind_ssse3(ss8_charset const *set, char const *begin,
+                                char const *end, bool member);
+SSSTR_TARGET_SSSE3 SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_charset_rfind_ssse3(ss8_charset const *set, char const *begin,
+                                char const *end, bool member) {
+    __m128i const lo = _mm_loadu_si128((__m128i const *)set->iNtErNaL_bits);
+    __m128i const hi =
+        _mm_loadu_si128((__m128i const *)(set->iNtErNaL_bits + 16));
+    unsigned const flip = member ? 0 : 0xffff;
+    char const *p = end;
+    while (p - begin >= 16) {
+        p -= 16;
+        __m128i const x = _mm_loadu_si128((__m128i const *)p);
+        unsigned const mask = ss8iNtErNaL_charset_mask_ssse3(lo, hi, x) ^ flip;
+        if (mask != 0)
+            return p + ss8iNtErNaL_bsr(mask);
+    }
+    return ss8iNtErNaL_charset_rfind_scalar(set, begin, p, member);
+}
+#endif
+
+#ifdef SSSTR_USE_AVX2
+// Like ss8iNtErNaL_charset_mask_ssse3(), but for 32 bytes; 'lo' and 'hi'
+// must hold the table halves in both 128-bit lanes.
+SSSTR_TARGET_AVX2 SSSTR_INLINE unsigned
+ss8iNtErNaL_charset_mask_avx2(__m256i lo, __m256i hi, __m256i x);
+SSSTR_TARGET_AVX2 SSSTR_INLINE_DEF unsigned
+ss8iNtErNaL_charset_mask_avx2(__m256i lo, __m256i hi, __m256i x) {
+    __m256i const bitpos = _mm256_setr_epi8(
+        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4,
+        8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    __m256i const row = _mm256_or_si256(
+        _mm256_shuffle_epi8(lo, x),
+        _mm256_shuffle_epi8(hi, _mm256_xor_si256(x, _mm256_set1_epi8(-128))));
+    __m256i const hinibble =
+        _mm256_and_si256(_mm256_srli_epi16(x, 4), _mm256_set1_epi8(0x0f));
+    __m256i const bit = _mm256_shuffle_epi8(bitpos, hinibble);
+    return (unsigned)_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit));
+}
+
+SSSTR_TARGET_AVX2 SSSTR_INLINE char const *
+ss8iNtErNaL_charset_find_avx2(ss8_charset const *set, char const *begin,
+                              char const *end, bool member);
+SSSTR_TARGET_AVX2 SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_charset_find_avx2(ss8_charset const *set, char const *begin,
+                              char const *end, bool member) {
+    __m256i const lo = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((__m128i const *)set->iNtErNaL_bits));
+    __m256i const hi = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((__m128i const *)(set->iNtErNaL_bits + 16)));
+    unsigned const flip = member ? 0 : 0xffffffff;
+    char const *p = begin;
+    for (; end - p >= 32; p += 32) {
+        __m256i const x = _mm256_loadu_si256((__m256i const *)p);
+        unsigned const mask = ss8iNtErNaL_charset_mask_avx2(lo, hi, x) ^ flip;
+        if (mask != 0)
+            return p + ss8iNtErNaL_ctz(mask);
+    }
+    return ss8iNtErNaL_charset_find_ssse3(set, p, end, member);
+}
+
+SSSTR_TARGET_AVX2 SSSTR_INLINE char const *
+ss8iNtErNaL_charset_rfind_avx2(ss8_charset const *set, char const *begin,
+                               char const *end, bool member);
+SSSTR_TARGET_AVX2 SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_charset_rfind_avx2(ss8_charset const *set, char const *begin,
+                               char const *end, bool member) {
+    __m256i const lo = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((__m128i const *)set->iNtErNaL_bits));
+    __m256i const hi = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((__m128i const *)(set->iNtErNaL_bits + 16)));
+    unsigned const flip = member ? 0 : 0xffffffff;
+    char const *p = end;
+    while (p - begin >= 32) {
+        p -= 32;
+        __m256i const x = _mm256_loadu_si256((__m256i const *)p);
+        unsigned const mask = ss8iNtErNaL_charset_mask_avx2(lo, hi, x) ^ flip;
+        if (mask != 0)
+            return p + ss8iNtErNaL_bsr(mask);
+    }
+    return ss8iNtErNaL_charset_rfind_ssse3(set, begin, p, member);
+}
+#endif
+
+SSSTR_INLINE char const *
+ss8iNtErNaL_charset_find(ss8_charset const *set, char const *begin,
+                         char const *end, bool member);
+SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_charset_find(ss8_charset const *set, char const *begin,
+                         char const *end, bool member) {
+#ifdef SSSTR_USE_AVX2
+    if (SSSTR_HAVE_AVX2())
+        return ss8iNtErNaL_charset_find_avx2(set, begin, end, member);
+#endif
+#ifdef SSSTR_USE_SSSE3
+    if (SSSTR_HAVE_SSSE3())
+        return ss8iNtErNaL_charset_find_ssse3(set, begin, end, member);
+#endif
+    return ss8iNtErNaL_charset_find_scalar(set, begin, end, member);
+}
+
+SSSTR_INLINE char const *
+ss8iNtErNaL_charset_rfind(ss8_charset const *set, char const *begin,
+                          char const *end, bool member);
+SSSTR_INLINE_DEF char const *
+ss8iNtErNaL_charset_rfind(ss8_charset const *set, char const *begin,
+                          char const *end, bool member) {
+#ifdef SSSTR_USE_AVX2
+    if (SSSTR_HAVE_AVX2())
+        return ss8iNtErNaL_charset_rfind_avx2(set, begin, end, member);
+#endif
+#ifdef SSSTR_USE_SSSE3
+    if (SSSTR_HAVE_SSSE3())
+        return ss8iNtErNaL_charset_rfind_ssse3(set, begin, end, member);
+#endif
+    return ss8iNtErNaL_charset_rfind_scalar(set, begin, end, member);
+}
+
+// Search forward in *haystack from 'start' for a byte whose membership in
+// *set equals 'member'.
+SSSTR_INLINE size_t ss8iNtErNaL_find_charset(ss8str const *haystack,
+                                             size_t start,
+                                             ss8_charset const *set,
+                                             bool member);
+SSSTR_INLINE_DEF size_t
+ss8iNtErNaL_find_charset(ss8str const *haystack, size_t start,
+                         ss8_charset const *set, bool member) {
+    char const *h = ss8_cstr(haystack);
+    size_t const haystacklen = ss8_len(haystack);
+    SSSTR_ASSERT(start <= haystacklen);
+    char const *p =
+        ss8iNtErNaL_charset_find(set, h + start, h + haystacklen, member);
+    return p != NULL ? (size_t)(p - h) : SIZE_MAX;
+}
+
+// Search backward in *haystack from 'start' for a byte whose membership in
+// *set equals 'member'.
+SSSTR_INLINE size_t ss8iNtErNaL_rfind_charset(ss8str const *haystack,
+                                              size_t start,
+                                              ss8_charset const *set,
+                                              bool member);
+SSSTR_INLINE_DEF size_t
+ss8iNtErNaL_rfind_charset(ss8str const *haystack, size_t start,
+                          ss8_charset const *set, bool member) {
+    char const *h = ss8_cstr(haystack);
+    size_t const haystacklen = ss8_len(haystack);
+    SSSTR_ASSERT(start <= haystacklen);
+    size_t const n = start < haystacklen ? start + 1 : haystacklen;
+    char const *p = ss8iNtErNaL_charset_rfind(set, h, h + n, member);
+    return p != NULL ? (size_t)(p - h) : SIZE_MAX;
+}
+
+// Return the first position at which any one of the characters in *needles
+// appears in *haystack, starting the search at 'start'. Return SIZE_MAX if not
+// found.
+SSSTR_INLINE_DEF size_t ss8_find_first_of_set(ss8str const *haystack,
+                                              size_t start,
+                                              ss8_charset const *needles) {
+    SSSTR_EXTRA_ASSERT(needles != NULL);
+    return ss8iNtErNaL_find_charset(haystack, start, needles, true);
+}
+
+// Return the first position at which a character that is not in *needles
+// appears in *haystack, starting the search at 'start'. Return SIZE_MAX if not
+// found.
+SSSTR_INLINE_DEF size_t ss8_find_first_not_of_set(ss8str const *haystack,
+                                                  size_t start,
+                                                  ss8_charset const *needles) {
+    SSSTR_EXTRA_ASSERT(needles != NULL);
+    return ss8iNtErNaL_find_charset(haystack, start, needles, false);
+}
+
+// Return the last position at which any one of the characters in *needles
+// appears in *haystack, starting the backward search at 'start'. Return
+// SIZE_MAX if not found.
+SSSTR_INLINE_DEF size_t ss8_find_last_of_set(ss8str const *haystack,
+                                             size_t start,
+                                             ss8_charset const *needles) {
+    SSSTR_EXTRA_ASSERT(needles != NULL);
+    return ss8iNtErNaL_rfind_charset(haystack, start, needles, true);
+}
+
+// Return the last position at which a character that is not in *needles
+// appears in *haystack, starting the backward search at 'start'. Return
+// SIZE_MAX if not found.
+SSSTR_INLINE_DEF size_t ss8_find_last_not_of_set(ss8str const *haystack,
+                                                 size_t start,
+                                                 ss8_charset const *needles) {
+    SSSTR_EXTRA_ASSERT(needles != NULL);
+    return ss8iNtErNaL_rfind_charset(haystack, start, needles, false);
+}
+
 // Return the first position at which any one of the 'count' characters at
 // 'needles' appears in *haystack, starting the search at 'start'. Return
 // SIZE_MAX if not found.
@@ -1563,20 +3850,11 @@ SSSTR_INLINE_DEF size_t ss8_find_first_of_bytes(ss8str const *haystack,
                                                 char const *needles,
                                                 size_t count) {
     SSSTR_EXTRA_ASSERT(needles != NULL);
-
-    char const *h = ss8_cstr(haystack);
-    size_t const haystacklen = ss8_len(haystack);
-    SSSTR_ASSERT(start <= haystacklen);
-    char const *begin = h + start;
-    char const *end = h + haystacklen;
-    for (char const *p = begin; p < end; ++p) {
-        // TODO: Clang can inline memchr() when needles is a literal but GCC
-        // and MSVC appear not to. Would it be faster if we use a plain loop
-        // when needles is short?
-        if (SSSTR_CHARP_MEMCHR(needles, *p, count))
-            return (size_t)(p - h);
-    }
-    return SIZE_MAX;
+    if (count == 1)
+        return ss8_find_ch(haystack, start, needles[0]);
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, needles, count);
+    return ss8_find_first_of_set(haystack, start, &set);
 }
 
 // Return the first position at which a character that is not one of the
@@ -1587,17 +3865,9 @@ SSSTR_INLINE_DEF size_t ss8_find_first_not_of_bytes(ss8str const *haystack,
                                                     char const *needles,
                                                     size_t count) {
     SSSTR_EXTRA_ASSERT(needles != NULL);
-
-    char const *h = ss8_cstr(haystack);
-    size_t const haystacklen = ss8_len(haystack);
-    SSSTR_ASSERT(start <= haystacklen);
-    char const *begin = h + start;
-    char const *end = h + haystacklen;
-    for (char const *p = begin; p < end; ++p) {
-        if (!SSSTR_CHARP_MEMCHR(needles, *p, count))
-            return (size_t)(p - h);
-    }
-    return SIZE_MAX;
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, needles, count);
+    return ss8_find_first_not_of_set(haystack, start, &set);
 }
 
 // Return the last position at which any one of the 'count' characters at
@@ -1608,21 +3878,11 @@ SSSTR_INLINE_DEF size_t ss8_find_last_of_bytes(ss8str const *haystack,
                                                char const *needles,
                                                size_t count) {
     SSSTR_EXTRA_ASSERT(needles != NULL);
-
-    char const *h = ss8_cstr(haystack);
-    size_t const haystacklen = ss8_len(haystack);
-    char const *end = h + haystacklen;
-    SSSTR_ASSERT(start <= haystacklen);
-    char const *rbegin = h + start;
-    if (rbegin >= end)
-        rbegin = end - 1;
-    char const *rend = h - 1;
-
-    for (char const *p = rbegin; p > rend; --p) {
-        if (SSSTR_CHARP_MEMCHR(needles, *p, count))
-            return (size_t)(p - h);
-    }
-    return SIZE_MAX;
+    if (count == 1)
+        return ss8_rfind_ch(haystack, start, needles[0]);
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, needles, count);
+    return ss8_find_last_of_set(haystack, start, &set);
 }
 
 // Return the last position at which a character that is not one of the
@@ -1633,21 +3893,9 @@ SSSTR_INLINE_DEF size_t ss8_find_last_not_of_bytes(ss8str const *haystack,
                                                    char const *needles,
                                                    size_t count) {
     SSSTR_EXTRA_ASSERT(needles != NULL);
-
-    char const *h = ss8_cstr(haystack);
-    size_t const haystacklen = ss8_len(haystack);
-    char const *end = h + haystacklen;
-    SSSTR_ASSERT(start <= haystacklen);
-    char const *rbegin = h + start;
-    if (rbegin >= end)
-        rbegin = end - 1;
-    char const *rend = h - 1;
-
-    for (char const *p = rbegin; p > rend; --p) {
-        if (!SSSTR_CHARP_MEMCHR(needles, *p, count))
-            return (size_t)(p - h);
-    }
-    return SIZE_MAX;
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, needles, count);
+    return ss8_find_last_not_of_set(haystack, start, &set);
 }
 
 // Return the first position at which any one of the characters in the
@@ -1730,6 +3978,526 @@ SSSTR_INLINE_DEF size_t ss8_find_last_not_of(ss8str const *haystack,
                                       ss8_len(needles));
 }
 
+// The skip tables are only used if the mean shift, taken over the bytes of the
+// needle itself (as a stand-in for the haystack's byte distribution), is at
+// least this long. Shorter shifts lose to the first/last-byte filter, whose
+// blocks do not depend on each other; the wider the blocks, the longer the
+// shifts need to be to pay for the table lookup.
+enum {
+    ss8iNtErNaL_searcher_minshift = 16,
+    ss8iNtErNaL_searcher_minshift_avx2 = 64
+};
+
+// Return 'shift' if shifts averaging 'meanshift' are worth taking with the
+// search kernel in use, otherwise NULL.
+SSSTR_INLINE size_t const *ss8iNtErNaL_searcher_skip(size_t const *shift,
+                                                     size_t meanshift);
+SSSTR_INLINE_DEF size_t const *
+ss8iNtErNaL_searcher_skip(size_t const *shift, size_t meanshift) {
+    size_t minshift = ss8iNtErNaL_searcher_minshift;
+#ifdef SSSTR_USE_AVX2
+    if (SSSTR_HAVE_AVX2())
+        minshift = ss8iNtErNaL_searcher_minshift_avx2;
+#endif
+    return meanshift >= minshift ? shift : NULL;
+}
+
+SSSTR_INLINE void ss8iNtErNaL_searcher_prepare(ss8_searcher *searcher);
+SSSTR_INLINE_DEF void ss8iNtErNaL_searcher_prepare(ss8_searcher *searcher) {
+    unsigned char const *n =
+        (unsigned char const *)ss8_cstr(&searcher->iNtErNaL_needle);
+    size_t const nlen = ss8_len(&searcher->iNtErNaL_needle);
+    for (size_t c = 0; c < 256; ++c) {
+        searcher->iNtErNaL_shift[c] = nlen;
+        searcher->iNtErNaL_rshift[c] = nlen;
+    }
+    // Forward: distance from the last occurrence (excluding the final byte)
+    // to the end of the needle.
+    for (size_t i = 0; i + 1 < nlen; ++i)
+        searcher->iNtErNaL_shift[n[i]] = nlen - 1 - i;
+    // Backward: distance from the start of the needle to the first occurrence
+    // (excluding the initial byte).
+    for (size_t i = nlen; i > 1; --i)
+        searcher->iNtErNaL_rshift[n[i - 1]] = i - 1;
+
+    size_t sum = 0, rsum = 0;
+    for (size_t i = 0; i < nlen; ++i) {
+        sum += searcher->iNtErNaL_shift[n[i]];
+        rsum += searcher->iNtErNaL_rshift[n[i]];
+    }
+    searcher->iNtErNaL_meanshift = nlen > 1 ? sum / nlen : 0;
+    searcher->iNtErNaL_rmeanshift = nlen > 1 ? rsum / nlen : 0;
+}
+
+// Initialize *searcher to search for the 'needlelen' bytes at 'needle' and
+// return 'searcher'.
+SSSTR_INLINE_DEF ss8_searcher *ss8_searcher_init_bytes(ss8_searcher *searcher,
+                                                       char const *needle,
+                                                       size_t needlelen) {
+    SSSTR_EXTRA_ASSERT(searcher != NULL);
+    SSSTR_EXTRA_ASSERT(needle != NULL);
+    ss8_init_copy_bytes(&searcher->iNtErNaL_needle, needle, needlelen);
+    ss8iNtErNaL_searcher_prepare(searcher);
+    return searcher;
+}
+
+// Initialize *searcher to search for the null-terminated string at 'needle'
+// and return 'searcher'.
+SSSTR_INLINE_DEF ss8_searcher *ss8_searcher_init_cstr(ss8_searcher *searcher,
+                                                      char const *needle) {
+    SSSTR_EXTRA_ASSERT(needle != NULL);
+    return ss8_searcher_init_bytes(searcher, needle, strlen(needle));
+}
+
+// Initialize *searcher to search for *needle and return 'searcher'.
+SSSTR_INLINE_DEF ss8_searcher *ss8_searcher_init(ss8_searcher *searcher,
+                                                 ss8str const *needle) {
+    return ss8_searcher_init_bytes(searcher, ss8_cstr(needle),
+                                   ss8_len(needle));
+}
+
+// Destroy *searcher, deallocating any associated dynamic storage.
+SSSTR_INLINE_DEF void ss8_searcher_destroy(ss8_searcher *searcher) {
+    SSSTR_EXTRA_ASSERT(searcher != NULL);
+    ss8_destroy(&searcher->iNtErNaL_needle);
+}
+
+// Return the first position at which the needle of *searcher appears in
+// *haystack, starting the search at 'start'. Return SIZE_MAX if not found.
+SSSTR_INLINE_DEF size_t ss8_searcher_find(ss8_searcher const *searcher,
+                                          ss8str const *haystack,
+                                          size_t start) {
+    SSSTR_EXTRA_ASSERT(searcher != NULL);
+    char const *h = ss8_cstr(haystack);
+    size_t const haystacklen = ss8_len(haystack);
+    SSSTR_ASSERT(start <= haystacklen);
+    char const *p = ss8iNtErNaL_memmem_skip(
+        h + start, haystacklen - start, ss8_cstr(&searcher->iNtErNaL_needle),
+        ss8_len(&searcher->iNtErNaL_needle),
+        ss8iNtErNaL_searcher_skip(searcher->iNtErNaL_shift,
+                                  searcher->iNtErNaL_meanshift));
+    return p != NULL ? (size_t)(p - h) : SIZE_MAX;
+}
+
+// Return the last position at which the needle of *searcher appears in
+// *haystack, starting the backward search at 'start'. Return SIZE_MAX if not
+// found.
+SSSTR_INLINE_DEF size_t ss8_searcher_rfind(ss8_searcher const *searcher,
+                                           ss8str const *haystack,
+                                           size_t start) {
+    SSSTR_EXTRA_ASSERT(searcher != NULL);
+    char const *h = ss8_cstr(haystack);
+    size_t const haystacklen = ss8_len(haystack);
+    size_t const needlelen = ss8_len(&searcher->iNtErNaL_needle);
+    if (needlelen > haystacklen)
+        return SIZE_MAX;
+    SSSTR_ASSERT(start <= haystacklen);
+    if (needlelen == 0)
+        return start;
+    size_t lastpos = haystacklen - needlelen;
+    if (start < lastpos)
+        lastpos = start;
+    char const *p = ss8iNtErNaL_rmemmem_skip(
+        h, lastpos + needlelen, ss8_cstr(&searcher->iNtErNaL_needle),
+        needlelen,
+        ss8iNtErNaL_searcher_skip(searcher->iNtErNaL_rshift,
+                                  searcher->iNtErNaL_rmeanshift));
+    return p != NULL ? (size_t)(p - h) : SIZE_MAX;
+}
+
+// Return the number of non-overlapping occurrences of the needle of *searcher
+// in *haystack, starting the search at 'start'. An empty needle is counted at
+// every position from 'start' to the end of *haystack, inclusive.
+SSSTR_INLINE_DEF size_t ss8_searcher_count(ss8_searcher const *searcher,
+                                           ss8str const *haystack,
+                                           size_t start) {
+    SSSTR_EXTRA_ASSERT(searcher != NULL);
+    char const *h = ss8_cstr(haystack);
+    size_t const haystacklen = ss8_len(haystack);
+    SSSTR_ASSERT(start <= haystacklen);
+    size_t const needlelen = ss8_len(&searcher->iNtErNaL_needle);
+    if (needlelen == 0)
+        return haystacklen - start + 1;
+    char const *n = ss8_cstr(&searcher->iNtErNaL_needle);
+    size_t const *skip = ss8iNtErNaL_searcher_skip(
+        searcher->iNtErNaL_shift, searcher->iNtErNaL_meanshift);
+    char const *end = h + haystacklen;
+    size_t count = 0;
+    for (char const *p = h + start;; ++count) {
+        p = ss8iNtErNaL_memmem_skip(p, (size_t)(end - p), n, needlelen, skip);
+        if (p == NULL)
+            return count;
+        p += needlelen;
+    }
+}
+
+// Initialize *ms as an empty pattern set and return 'ms'.
+SSSTR_INLINE_DEF ss8_multisearch *ss8_multisearch_init(ss8_multisearch *ms) {
+    SSSTR_EXTRA_ASSERT(ms != NULL);
+    ss8_init(&ms->iNtErNaL_patterns);
+    ms->iNtErNaL_ends = NULL;
+    ms->iNtErNaL_count = 0;
+    ms->iNtErNaL_capacity = 0;
+    ms->iNtErNaL_table = NULL;
+    ms->iNtErNaL_tablesize = 0;
+    ms->iNtErNaL_nstates = 0;
+    ms->iNtErNaL_nclasses = 0;
+    memset(ms->iNtErNaL_class, 0, sizeof(ms->iNtErNaL_class));
+    memset(&ms->iNtErNaL_start, 0, sizeof(ms->iNtErNaL_start));
+    ms->iNtErNaL_skip = false;
+    return ms;
+}
+
+// Destroy *ms, deallocating any associated dynamic storage.
+SSSTR_INLINE_DEF void ss8_multisearch_destroy(ss8_multisearch *ms) {
+    SSSTR_EXTRA_ASSERT(ms != NULL);
+    ss8_destroy(&ms->iNtErNaL_patterns);
+    if (ms->iNtErNaL_ends != NULL)
+        SSSTR_FREE_SIZED(ms->iNtErNaL_ends,
+                         ms->iNtErNaL_capacity * sizeof(size_t));
+    if (ms->iNtErNaL_table != NULL)
+        SSSTR_FREE_SIZED(ms->iNtErNaL_table, ms->iNtErNaL_tablesize);
+}
+
+// Add the 'patternlen' bytes at 'pattern' to the patterns of *ms and return
+// the index of the new pattern. *ms must be compiled again before searching.
+SSSTR_INLINE_DEF size_t ss8_multisearch_add_bytes(ss8_multisearch *ms,
+                                                  char const *pattern,
+                                                  size_t patternlen) {
+    SSSTR_EXTRA_ASSERT(ms != NULL);
+    SSSTR_EXTRA_ASSERT(pattern != NULL);
+    if (ms->iNtErNaL_table != NULL) {
+        SSSTR_FREE_SIZED(ms->iNtErNaL_table, ms->iNtErNaL_tablesize);
+        ms->iNtErNaL_table = NULL;
+    }
+    if (ms->iNtErNaL_count == ms->iNtErNaL_capacity) {
+        size_t const cap =
+            ms->iNtErNaL_capacity > 0 ? 2 * ms->iNtErNaL_capacity : 8;
+        if (cap > SIZE_MAX / sizeof(size_t))
+            SSSTR_SIZE_OVERFLOW();
+        size_t *ends =
+            ms->iNtErNaL_ends == NULL
+                ? (size_t *)SSSTR_MALLOC(cap * sizeof(size_t))
+                : (size_t *)SSSTR_REALLOC_SIZED(
+                      ms->iNtErNaL_ends,
+                      ms->iNtErNaL_capacity * sizeof(size_t),
+                      cap * sizeof(size_t));
+        if (ends == NULL)
+            SSSTR_OUT_OF_MEMORY(cap * sizeof(size_t));
+        ms->iNtErNaL_ends = ends;
+        ms->iNtErNaL_capacity = cap;
+    }
+    ss8_cat_bytes(&ms->iNtErNaL_patterns, pattern, patternlen);
+    ms->iNtErNaL_ends[ms->iNtErNaL_count] = ss8_len(&ms->iNtErNaL_patterns);
+    return ms->iNtErNaL_count++;
+}
+
+// Add the null-terminated string at 'pattern' to the patterns of *ms and
+// return the index of the new pattern.
+SSSTR_INLINE_DEF size_t ss8_multisearch_add_cstr(ss8_multisearch *ms,
+                                                 char const *pattern) {
+    SSSTR_EXTRA_ASSERT(pattern != NULL);
+    return ss8_multisearch_add_bytes(ms, pattern, strlen(pattern));
+}
+
+// Add *pattern to the patterns of *ms and return the index of the new
+// pattern.
+SSSTR_INLINE_DEF size_t ss8_multisearch_add(ss8_multisearch *ms,
+                                            ss8str const *pattern) {
+    return ss8_multisearch_add_bytes(ms, ss8_cstr(pattern), ss8_len(pattern));
+}
+
+// From the root, the automaton skips (with the vectorized character set
+// search) to the next byte that can start a match, but only if there are at
+// most this many such bytes; otherwise the skip rarely gets far.
+enum { ss8iNtErNaL_multisearch_maxstart = 32 };
+
+// Build the automaton for the current patterns of *ms. The table holds, for
+// each of the 'nstates' states, a row of 'nclasses' transitions followed by
+// the first state on the state's suffix chain that completes a pattern (or
+// UINT32_MAX). Transitions are stored as the offset of the target row, so
+// that each step of the search is a single dependent load. Three more arrays,
+// indexed by state, follow the rows: the next state on the suffix chain that
+// completes a pattern, the pattern completed at the state itself, and the
+// state's depth (the length of the pattern prefix that it stands for).
+SSSTR_INLINE_DEF void ss8_multisearch_compile(ss8_multisearch *ms) {
+    SSSTR_EXTRA_ASSERT(ms != NULL);
+    if (ms->iNtErNaL_table != NULL) {
+        SSSTR_FREE_SIZED(ms->iNtErNaL_table, ms->iNtErNaL_tablesize);
+        ms->iNtErNaL_table = NULL;
+    }
+    unsigned char const *pats =
+        (unsigned char const *)ss8_cstr(&ms->iNtErNaL_patterns);
+    size_t const total = ss8_len(&ms->iNtErNaL_patterns);
+    size_t const count = ms->iNtErNaL_count;
+    size_t const *ends = ms->iNtErNaL_ends;
+
+    // Bytes that appear in no pattern all behave alike and share a class.
+    bool seen[256] = {false};
+    for (size_t i = 0; i < total; ++i)
+        seen[pats[i]] = true;
+    unsigned nclasses = 0;
+    for (unsigned b = 0; b < 256; ++b) {
+        if (seen[b])
+            ms->iNtErNaL_class[b] = (unsigned char)nclasses++;
+    }
+    for (unsigned b = 0; b < 256; ++b) {
+        if (!seen[b])
+            ms->iNtErNaL_class[b] = (unsigned char)nclasses;
+    }
+    if (nclasses < 256)
+        ++nclasses;
+    size_t const k = nclasses;
+    size_t const w = k + 1; // Row width
+
+    size_t const maxstates = total + 1;
+    if (count >= UINT32_MAX || maxstates >= UINT32_MAX / w ||
+        maxstates > SIZE_MAX / sizeof(uint32_t) / (w + 3))
+        SSSTR_SIZE_OVERFLOW();
+    size_t const bytes = maxstates * (w + 3) * sizeof(uint32_t);
+    uint32_t *table = (uint32_t *)SSSTR_MALLOC(bytes);
+    if (table == NULL)
+        SSSTR_OUT_OF_MEMORY(bytes);
+    uint32_t *queue = (uint32_t *)SSSTR_MALLOC(maxstates * sizeof(uint32_t));
+    if (queue == NULL) {
+        SSSTR_FREE_SIZED(table, bytes);
+        SSSTR_OUT_OF_MEMORY(maxstates * sizeof(uint32_t));
+    }
+    uint32_t *rows = table;
+    uint32_t *next = rows + maxstates * w;
+    uint32_t *pat = next + maxstates;
+    uint32_t *depth = pat + maxstates;
+    memset(rows, 0, maxstates * w * sizeof(uint32_t));
+    for (size_t st = 0; st < maxstates; ++st)
+        pat[st] = UINT32_MAX;
+
+    // Build the trie, with transitions as state numbers for now. No edge
+    // leads to the root, so 0 marks a missing edge.
+    uint32_t nstates = 1;
+    depth[0] = 0;
+    for (size_t i = 0, begin = 0; i < count; begin = ends[i++]) {
+        uint32_t st = 0;
+        for (size_t j = begin; j < ends[i]; ++j) {
+            uint32_t *t = &rows[st * w + ms->iNtErNaL_class[pats[j]]];
+            if (*t == 0) {
+                depth[nstates] = depth[st] + 1;
+                *t = nstates++;
+            }
+            st = *t;
+        }
+        if (pat[st] == UINT32_MAX)
+            pat[st] = (uint32_t)i;
+    }
+
+    // In breadth-first order, find each state's failure link (stored in
+    // 'next' until the state is dequeued) and fill in its missing edges from
+    // the failure state, whose row is already complete.
+    size_t qhead = 0, qtail = 0;
+    queue[qtail++] = 0;
+    next[0] = 0;
+    while (qhead < qtail) {
+        uint32_t const st = queue[qhead++];
+        uint32_t const fail = next[st];
+        for (size_t c = 0; c < k; ++c) {
+            uint32_t const t = rows[st * w + c];
+            if (t != 0) {
+                next[t] = st == 0 ? 0 : rows[fail * w + c];
+                queue[qtail++] = t;
+            } else if (st != 0) {
+                rows[st * w + c] = rows[fail * w + c];
+            }
+        }
+        uint32_t const chain = st == 0 ? UINT32_MAX : rows[fail * w + k];
+        rows[st * w + k] = pat[st] != UINT32_MAX ? st : chain;
+        next[st] = chain;
+    }
+    SSSTR_FREE_SIZED(queue, maxstates * sizeof(uint32_t));
+
+    char starts[256];
+    size_t nstarts = 0;
+    for (unsigned b = 0; b < 256; ++b) {
+        if (rows[ms->iNtErNaL_class[b]] != 0)
+            starts[nstarts++] = (char)b;
+    }
+    ss8_charset_init_bytes(&ms->iNtErNaL_start, starts, nstarts);
+    // With an empty pattern, every position is a match and we cannot skip.
+    ms->iNtErNaL_skip = rows[k] == UINT32_MAX &&
+                        nstarts <= ss8iNtErNaL_multisearch_maxstart;
+
+    for (size_t st = 0; st < nstates; ++st) {
+        for (size_t c = 0; c < k; ++c)
+            rows[st * w + c] *= (uint32_t)w;
+    }
+
+    // Drop the rows of states that were not needed.
+    size_t tablesize = bytes;
+    if (nstates < maxstates) {
+        memmove(rows + nstates * w, next, nstates * sizeof(uint32_t));
+        memmove(rows + nstates * (w + 1), pat, nstates * sizeof(uint32_t));
+        memmove(rows + nstates * (w + 2), depth, nstates * sizeof(uint32_t));
+        size_t const shrunksize = nstates * (w + 3) * sizeof(uint32_t);
+        uint32_t *shrunk =
+            (uint32_t *)SSSTR_REALLOC_SIZED(table, bytes, shrunksize);
+        if (shrunk != NULL) {
+            table = shrunk;
+            tablesize = shrunksize;
+        }
+    }
+    ms->iNtErNaL_table = table;
+    ms->iNtErNaL_tablesize = tablesize;
+    ms->iNtErNaL_nstates = nstates;
+    ms->iNtErNaL_nclasses = (uint32_t)k;
+}
+
+// Run the automaton of *ms over the bytes [start, hlen) of 'h', calling
+// 'callback' (if not NULL) for each match until it returns false. Return the
+// number of matches reported.
+SSSTR_INLINE size_t
+ss8iNtErNaL_multisearch_scan(ss8_multisearch const *ms, char const *h,
+                             size_t start, size_t hlen,
+                             ss8_multisearch_callback callback, void *data);
+SSSTR_INLINE_DEF size_t
+ss8iNtErNaL_multisearch_scan(ss8_multisearch const *ms, char const *h,
+                             size_t start, size_t hlen,
+                             ss8_multisearch_callback callback, void *data) {
+    SSSTR_ASSERT(ms->iNtErNaL_table != NULL); // Not compiled
+    size_t const k = ms->iNtErNaL_nclasses;
+    uint32_t const *rows = ms->iNtErNaL_table;
+    uint32_t const *next = rows + ms->iNtErNaL_nstates * (k + 1);
+    uint32_t const *pat = next + ms->iNtErNaL_nstates;
+    size_t const *ends = ms->iNtErNaL_ends;
+    unsigned char const *cls = ms->iNtErNaL_class;
+    bool const skip = ms->iNtErNaL_skip;
+
+    size_t count = 0;
+    uint32_t row = 0;
+    char const *p = h + start;
+    char const *const end = h + hlen;
+    for (;;) {
+        for (uint32_t t = rows[row + k]; t != UINT32_MAX; t = next[t]) {
+            size_t const i = pat[t];
+            size_t const len = ends[i] - (i > 0 ? ends[i - 1] : 0);
+            ++count;
+            if (callback != NULL && !callback((size_t)(p - h) - len, i, data))
+                return count;
+        }
+        if (p == end)
+            return count;
+        if (row == 0 && skip) {
+            p = ss8iNtErNaL_charset_find(&ms->iNtErNaL_start, p, end, true);
+            if (p == NULL)
+                return count;
+        }
+        row = rows[row + cls[(unsigned char)*p++]];
+    }
+}
+
+SSSTR_INLINE bool ss8iNtErNaL_multisearch_stop(size_t pos, size_t pattern,
+                                               void *data);
+SSSTR_INLINE_DEF bool ss8iNtErNaL_multisearch_stop(size_t pos, size_t pattern,
+                                                   void *data) {
+    size_t *result = (size_t *)data;
+    result[0] = pos;
+    result[1] = pattern;
+    return false;
+}
+
+// Run the automaton of *ms over the bytes [start, hlen) of 'h' and return the
+// position of the leftmost match, storing its pattern in *pattern; of the
+// matches starting there, the longest is chosen. Return SIZE_MAX if none.
+SSSTR_INLINE size_t ss8iNtErNaL_multisearch_leftmost(
+    ss8_multisearch const *ms, char const *h, size_t start, size_t hlen,
+    size_t *pattern);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_multisearch_leftmost(
+    ss8_multisearch const *ms, char const *h, size_t start, size_t hlen,
+    size_t *pattern) {
+    SSSTR_ASSERT(ms->iNtErNaL_table != NULL); // Not compiled
+    size_t const k = ms->iNtErNaL_nclasses;
+    uint32_t const *rows = ms->iNtErNaL_table;
+    uint32_t const *next = rows + ms->iNtErNaL_nstates * (k + 1);
+    uint32_t const *pat = next + ms->iNtErNaL_nstates;
+    uint32_t const *depth = pat + ms->iNtErNaL_nstates;
+    size_t const *ends = ms->iNtErNaL_ends;
+    unsigned char const *cls = ms->iNtErNaL_class;
+    bool const skip = ms->iNtErNaL_skip;
+
+    size_t best = SIZE_MAX;
+    uint32_t row = 0;
+    char const *p = h + start;
+    char const *const end = h + hlen;
+    for (;;) {
+        size_t const pos = (size_t)(p - h);
+        // Of the matches ending here, the first on the chain is the longest
+        // and so starts earliest. A match starting where the best one does,
+        // but ending later, is longer.
+        uint32_t const t = rows[row + k];
+        if (t != UINT32_MAX) {
+            size_t const i = pat[t];
+            size_t const len = ends[i] - (i > 0 ? ends[i - 1] : 0);
+            if (pos - len <= best) {
+                best = pos - len;
+                *pattern = i;
+            }
+        }
+        // Any match found later starts within the prefix matched so far.
+        if (best != SIZE_MAX && pos - depth[row / (k + 1)] > best)
+            return best;
+        if (p == end)
+            return best;
+        if (row == 0 && skip) {
+            p = ss8iNtErNaL_charset_find(&ms->iNtErNaL_start, p, end, true);
+            if (p == NULL)
+                return best;
+        }
+        row = rows[row + cls[(unsigned char)*p++]];
+    }
+}
+
+// Return the position of the first match in *haystack, starting the search at
+// 'start', of any pattern of *ms; the first match is the one that starts
+// earliest, and the longest among those. Store the pattern's index in
+// *pattern if not NULL. Return SIZE_MAX if not found.
+SSSTR_INLINE_DEF size_t ss8_multisearch_find(ss8_multisearch const *ms,
+                                             ss8str const *haystack,
+                                             size_t start, size_t *pattern) {
+    SSSTR_EXTRA_ASSERT(ms != NULL);
+    size_t const haystacklen = ss8_len(haystack);
+    SSSTR_ASSERT(start <= haystacklen);
+    size_t pat = SIZE_MAX;
+    size_t const pos = ss8iNtErNaL_multisearch_leftmost(
+        ms, ss8_cstr(haystack), start, haystacklen, &pat);
+    if (pos != SIZE_MAX && pattern != NULL)
+        *pattern = pat;
+    return pos;
+}
+
+// Return whether any pattern of *ms appears in *haystack.
+SSSTR_INLINE_DEF bool ss8_multisearch_contains(ss8_multisearch const *ms,
+                                               ss8str const *haystack) {
+    SSSTR_EXTRA_ASSERT(ms != NULL);
+    // Stop at the first match to end, which need not be the leftmost.
+    size_t result[2];
+    return ss8iNtErNaL_multisearch_scan(ms, ss8_cstr(haystack), 0,
+                                        ss8_len(haystack),
+                                        ss8iNtErNaL_multisearch_stop,
+                                        result) != 0;
+}
+
+// Call 'callback' for every (possibly overlapping) match in *haystack,
+// starting the search at 'start', of every pattern of *ms, in order of end
+// position and then longest first, until it returns false. Return the number
+// of calls made, or the number of matches if 'callback' is NULL.
+SSSTR_INLINE_DEF size_t
+ss8_multisearch_find_all(ss8_multisearch const *ms, ss8str const *haystack,
+                         size_t start, ss8_multisearch_callback callback,
+                         void *data) {
+    SSSTR_EXTRA_ASSERT(ms != NULL);
+    size_t const haystacklen = ss8_len(haystack);
+    SSSTR_ASSERT(start <= haystacklen);
+    return ss8iNtErNaL_multisearch_scan(ms, ss8_cstr(haystack), start,
+                                        haystacklen, callback, data);
+}
+
 // Return whether the first bytes of *str match the 'prefixlen' bytes at
 // 'prefix'.
 SSSTR_INLINE_DEF bool ss8_starts_with_bytes(ss8str const *str,
@@ -1814,15 +4582,49 @@ SSSTR_INLINE_DEF bool ss8_contains_ch(ss8str const *str, char ch) {
     return ss8_find_ch(str, 0, ch) != SIZE_MAX;
 }
 
+// Erase from the beginning of *str any consecutive characters that are in
+// *chars and return 'str'.
+SSSTR_INLINE_DEF ss8str *ss8_lstrip_set(ss8str *str,
+                                        ss8_charset const *chars) {
+    size_t b = ss8_find_first_not_of_set(str, 0, chars);
+    if (b == SIZE_MAX)
+        b = ss8_len(str);
+    return ss8_substr_inplace(str, b, SIZE_MAX);
+}
+
+// Erase from the end of *str any consecutive characters that are in *chars
+// and return 'str'.
+SSSTR_INLINE_DEF ss8str *ss8_rstrip_set(ss8str *str,
+                                        ss8_charset const *chars) {
+    size_t const e = ss8_find_last_not_of_set(str, ss8_len(str), chars);
+    size_t const n = e == SIZE_MAX ? 0 : e + 1;
+    return ss8_substr_inplace(str, 0, n);
+}
+
+// Erase from the beginning and end of *str any consecutive characters that
+// are in *chars and return 'str'.
+SSSTR_INLINE_DEF ss8str *ss8_strip_set(ss8str *str,
+                                       ss8_charset const *chars) {
+    size_t const len = ss8_len(str);
+    size_t n;
+    size_t b = ss8_find_first_not_of_set(str, 0, chars);
+    if (b == SIZE_MAX) {
+        b = n = 0;
+    } else {
+        size_t const e = ss8_find_last_not_of_set(str, len, chars);
+        n = e - b + 1;
+    }
+    return ss8_substr_inplace(str, b, n);
+}
+
 // Erase from the beginning of *str any consecutive characters that appear in
 // the 'count' bytes at 'chars' and return 'str'.
 SSSTR_INLINE_DEF ss8str *ss8_lstrip_bytes(ss8str *SSSTR_RESTRICT str,
                                           char const *SSSTR_RESTRICT chars,
                                           size_t count) {
-    size_t b = ss8_find_first_not_of_bytes(str, 0, chars, count);
-    if (b == SIZE_MAX)
-        b = ss8_len(str);
-    return ss8_substr_inplace(str, b, SIZE_MAX);
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, chars, count);
+    return ss8_lstrip_set(str, &set);
 }
 
 // Erase from the end of *str any consecutive characters that appear in the
@@ -1830,10 +4632,9 @@ SSSTR_INLINE_DEF ss8str *ss8_lstrip_bytes(ss8str *SSSTR_RESTRICT str,
 SSSTR_INLINE_DEF ss8str *ss8_rstrip_bytes(ss8str *SSSTR_RESTRICT str,
                                           char const *SSSTR_RESTRICT chars,
                                           size_t count) {
-    size_t const e =
-        ss8_find_last_not_of_bytes(str, ss8_len(str), chars, count);
-    size_t const n = e == SIZE_MAX ? 0 : e + 1;
-    return ss8_substr_inplace(str, 0, n);
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, chars, count);
+    return ss8_rstrip_set(str, &set);
 }
 
 // Erase from the beginning and end of *str any consecutive characters that
@@ -1841,16 +4642,9 @@ SSSTR_INLINE_DEF ss8str *ss8_rstrip_bytes(ss8str *SSSTR_RESTRICT str,
 SSSTR_INLINE_DEF ss8str *ss8_strip_bytes(ss8str *SSSTR_RESTRICT str,
                                          char const *SSSTR_RESTRICT chars,
                                          size_t count) {
-    size_t const len = ss8_len(str);
-    size_t n;
-    size_t b = ss8_find_first_not_of_bytes(str, 0, chars, count);
-    if (b == SIZE_MAX) {
-        b = n = 0;
-    } else {
-        size_t const e = ss8_find_last_not_of_bytes(str, len, chars, count);
-        n = e - b + 1;
-    }
-    return ss8_substr_inplace(str, b, n);
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, chars, count);
+    return ss8_strip_set(str, &set);
 }
 
 // Erase from the beginning of *str any consecutive characters that appear in
@@ -1930,6 +4724,1902 @@ SSSTR_INLINE_DEF ss8str *ss8_strip_ch(ss8str *str, char ch) {
     return ss8_substr_inplace(str, b, n);
 }
 
+// Return a view of the 'len' bytes at 'buf'.
+SSSTR_INLINE_DEF ss8view ss8_view_bytes(char const *buf, size_t len) {
+    SSSTR_EXTRA_ASSERT(buf != NULL);
+    ss8view view;
+    view.ptr = buf;
+    view.len = len;
+    return view;
+}
+
+// Return a view of the null-terminated string at 'cstr' (not including the
+// null terminator).
+SSSTR_INLINE_DEF ss8view ss8_view_cstr(char const *cstr) {
+    SSSTR_EXTRA_ASSERT(cstr != NULL);
+    return ss8_view_bytes(cstr, strlen(cstr));
+}
+
+// Return a view of *str, valid until *str is modified or destroyed.
+SSSTR_INLINE_DEF ss8view ss8_view(ss8str const *str) {
+    return ss8_view_bytes(ss8_cstr(str), ss8_len(str));
+}
+
+// Return a view of the substring of *str starting at 'start' (which must be in
+// range) and having length at most 'len', valid until *str is modified or
+// destroyed.
+SSSTR_INLINE_DEF ss8view ss8_view_substr(ss8str const *str, size_t start,
+                                         size_t len) {
+    return ss8_view_slice(ss8_view(str), start, len);
+}
+
+// Return the portion of 'view' starting at 'start' (which must be in range)
+// and having length at most 'len'.
+SSSTR_INLINE_DEF ss8view ss8_view_slice(ss8view view, size_t start,
+                                         size_t len) {
+    SSSTR_ASSERT(start <= view.len);
+    if (len >= view.len - start)
+        len = view.len - start;
+    return ss8_view_bytes(view.ptr + start, len);
+}
+
+// Initialize *str to a copy of the bytes viewed by 'src' and return 'str'.
+SSSTR_INLINE_DEF ss8str *ss8_init_copy_view(ss8str *str, ss8view src) {
+    return ss8_init_copy_bytes(str, src.ptr, src.len);
+}
+
+// Set *dest to a copy of the bytes viewed by 'src' (which must not be within
+// *dest) and return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_copy_view(ss8str *dest, ss8view src) {
+    return ss8_copy_bytes(dest, src.ptr, src.len);
+}
+
+// Append the bytes viewed by 'src' (which must not be within *dest) at the end
+// of *dest and return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_cat_view(ss8str *dest, ss8view src) {
+    return ss8_cat_bytes(dest, src.ptr, src.len);
+}
+
+// Write the 'count' views at 'pieces', separated by the 'seplen' bytes at
+// 'sep', into *dest starting at position 'pos' (which must be its length),
+// allocating at most once, and return 'dest'.
+SSSTR_INLINE ss8str *ss8iNtErNaL_cat_joined(ss8str *dest, size_t pos,
+                                           ss8view const *pieces,
+                                           size_t count, char const *sep,
+                                           size_t seplen);
+SSSTR_INLINE_DEF ss8str *ss8iNtErNaL_cat_joined(ss8str *dest, size_t pos,
+                                               ss8view const *pieces,
+                                               size_t count, char const *sep,
+                                               size_t seplen) {
+    SSSTR_EXTRA_ASSERT(pieces != NULL || count == 0);
+    ss8iNtErNaL_extra_assert_no_overlap(dest, sep, seplen);
+    size_t newlen = pos;
+    for (size_t i = 0; i < count; ++i) {
+        ss8iNtErNaL_extra_assert_no_overlap(dest, pieces[i].ptr,
+                                            pieces[i].len);
+        if (i > 0)
+            newlen = ss8iNtErNaL_add_sizes(newlen, seplen);
+        newlen = ss8iNtErNaL_add_sizes(newlen, pieces[i].len);
+    }
+
+    char *p = ss8iNtErNaL_grow(dest, newlen) + pos;
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            memcpy(p, sep, seplen);
+            p += seplen;
+        }
+        memcpy(p, pieces[i].ptr, pieces[i].len);
+        p += pieces[i].len;
+    }
+    *p = '\0';
+    ss8iNtErNaL_setlen(dest, newlen);
+    return dest;
+}
+
+// Append the 'count' views at 'pieces' (which must not be within *dest) at the
+// end of *dest, allocating at most once, and return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_cat_many(ss8str *dest, ss8view const *pieces,
+                                      size_t count) {
+    return ss8iNtErNaL_cat_joined(dest, ss8_len(dest), pieces, count, "", 0);
+}
+
+// Set *dest to the 'count' views at 'pieces' (which must not be within
+// *dest), separated by the 'seplen' bytes at 'sep', and return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_join_bytes(ss8str *SSSTR_RESTRICT dest,
+                                        ss8view const *pieces, size_t count,
+                                        char const *SSSTR_RESTRICT sep,
+                                        size_t seplen) {
+    SSSTR_EXTRA_ASSERT(sep != NULL);
+    return ss8iNtErNaL_cat_joined(dest, 0, pieces, count, sep, seplen);
+}
+
+// Set *dest to the 'count' views at 'pieces' (which must not be within
+// *dest), separated by the null-terminated string at 'sep', and return
+// 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_join_cstr(ss8str *SSSTR_RESTRICT dest,
+                                       ss8view const *pieces, size_t count,
+                                       char const *SSSTR_RESTRICT sep) {
+    SSSTR_EXTRA_ASSERT(sep != NULL);
+    return ss8_join_bytes(dest, pieces, count, sep, strlen(sep));
+}
+
+// Set *dest to the 'count' views at 'pieces' (which must not be within
+// *dest), separated by *sep, and return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_join(ss8str *SSSTR_RESTRICT dest,
+                                  ss8view const *pieces, size_t count,
+                                  ss8str const *SSSTR_RESTRICT sep) {
+    return ss8_join_bytes(dest, pieces, count, ss8_cstr(sep), ss8_len(sep));
+}
+
+// Set *dest to the 'count' views at 'pieces' (which must not be within
+// *dest), separated by the byte 'sep', and return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_join_ch(ss8str *dest, ss8view const *pieces,
+                                     size_t count, char sep) {
+    return ss8iNtErNaL_cat_joined(dest, 0, pieces, count, &sep, 1);
+}
+
+// Lexicographically compare 'lhs' and 'rhs' and return a value >/==/< 0 when
+// lhs >/==/< rhs.
+SSSTR_INLINE_DEF int ss8_view_cmp(ss8view lhs, ss8view rhs) {
+    size_t const cmplen = lhs.len < rhs.len ? lhs.len : rhs.len;
+    int const c = memcmp(lhs.ptr, rhs.ptr, cmplen);
+    if (c != 0 || lhs.len == rhs.len)
+        return c;
+    return lhs.len < rhs.len ? -1 : 1;
+}
+
+// Return whether 'lhs' and 'rhs' view equal byte sequences.
+SSSTR_INLINE_DEF bool ss8_view_equals(ss8view lhs, ss8view rhs) {
+    return lhs.len == rhs.len && memcmp(lhs.ptr, rhs.ptr, lhs.len) == 0;
+}
+
+// Return whether 'view' starts with 'prefix'.
+SSSTR_INLINE_DEF bool ss8_view_starts_with(ss8view view, ss8view prefix) {
+    return prefix.len <= view.len &&
+           memcmp(view.ptr, prefix.ptr, prefix.len) == 0;
+}
+
+// Return whether 'view' ends with 'suffix'.
+SSSTR_INLINE_DEF bool ss8_view_ends_with(ss8view view, ss8view suffix) {
+    return suffix.len <= view.len &&
+           memcmp(view.ptr + (view.len - suffix.len), suffix.ptr,
+                  suffix.len) == 0;
+}
+
+// Return the first position at which 'needle' appears in 'haystack', starting
+// the search at 'start'. Return SIZE_MAX if not found.
+SSSTR_INLINE_DEF size_t ss8_view_find(ss8view haystack, size_t start,
+                                      ss8view needle) {
+    SSSTR_ASSERT(start <= haystack.len);
+    char const *p = ss8iNtErNaL_memmem(haystack.ptr + start,
+                                       haystack.len - start, needle.ptr,
+                                       needle.len);
+    return p != NULL ? (size_t)(p - haystack.ptr) : SIZE_MAX;
+}
+
+// Return the first position at which the character 'needle' appears in
+// 'haystack', starting the search at 'start'. Return SIZE_MAX if not found.
+SSSTR_INLINE_DEF size_t ss8_view_find_ch(ss8view haystack, size_t start,
+                                         char needle) {
+    SSSTR_ASSERT(start <= haystack.len);
+    char const *p = SSSTR_CHARP_MEMCHR(haystack.ptr + start, needle,
+                                       haystack.len - start);
+    return p != NULL ? (size_t)(p - haystack.ptr) : SIZE_MAX;
+}
+
+// Return the last position at which 'needle' appears in 'haystack', starting
+// the backward search at 'start'. Return SIZE_MAX if not found.
+SSSTR_INLINE_DEF size_t ss8_view_rfind(ss8view haystack, size_t start,
+                                       ss8view needle) {
+    if (needle.len > haystack.len)
+        return SIZE_MAX;
+    SSSTR_ASSERT(start <= haystack.len);
+    if (needle.len == 0)
+        return start;
+    size_t lastpos = haystack.len - needle.len;
+    if (start < lastpos)
+        lastpos = start;
+    char const *p = ss8iNtErNaL_rmemmem(haystack.ptr, lastpos + needle.len,
+                                        needle.ptr, needle.len);
+    return p != NULL ? (size_t)(p - haystack.ptr) : SIZE_MAX;
+}
+
+// Return the last position at which the character 'needle' appears in
+// 'haystack', starting the backward search at 'start'. Return SIZE_MAX if not
+// found.
+SSSTR_INLINE_DEF size_t ss8_view_rfind_ch(ss8view haystack, size_t start,
+                                          char needle) {
+    SSSTR_ASSERT(start <= haystack.len);
+    size_t const n = start < haystack.len ? start + 1 : haystack.len;
+    char const *p = ss8iNtErNaL_memrchr(haystack.ptr, needle, n);
+    return p != NULL ? (size_t)(p - haystack.ptr) : SIZE_MAX;
+}
+
+// Return the portion of 'view' remaining after skipping any leading bytes
+// that appear in 'chars'.
+SSSTR_INLINE_DEF ss8view ss8_view_lstrip(ss8view view, ss8view chars) {
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, chars.ptr, chars.len);
+    char const *const end = view.ptr + view.len;
+    char const *b = ss8iNtErNaL_charset_find(&set, view.ptr, end, false);
+    if (b == NULL)
+        b = end;
+    return ss8_view_bytes(b, (size_t)(end - b));
+}
+
+// Return the portion of 'view' remaining after skipping any trailing bytes
+// that appear in 'chars'.
+SSSTR_INLINE_DEF ss8view ss8_view_rstrip(ss8view view, ss8view chars) {
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, chars.ptr, chars.len);
+    char const *e = ss8iNtErNaL_charset_rfind(&set, view.ptr,
+                                              view.ptr + view.len, false);
+    size_t const len = e == NULL ? 0 : (size_t)(e + 1 - view.ptr);
+    return ss8_view_bytes(view.ptr, len);
+}
+
+// Return the portion of 'view' remaining after skipping any leading and
+// trailing bytes that appear in 'chars'.
+SSSTR_INLINE_DEF ss8view ss8_view_strip(ss8view view, ss8view chars) {
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, chars.ptr, chars.len);
+    char const *const end = view.ptr + view.len;
+    char const *b = ss8iNtErNaL_charset_find(&set, view.ptr, end, false);
+    if (b == NULL)
+        return ss8_view_bytes(view.ptr, 0);
+    char const *e = ss8iNtErNaL_charset_rfind(&set, b, end, false);
+    return ss8_view_bytes(b, (size_t)(e + 1 - b));
+}
+
+SSSTR_INLINE void ss8iNtErNaL_split_init(ss8_split *sp, ss8str const *str,
+                                         unsigned char kind);
+SSSTR_INLINE_DEF void ss8iNtErNaL_split_init(ss8_split *sp, ss8str const *str,
+                                             unsigned char kind) {
+    SSSTR_EXTRA_ASSERT(sp != NULL);
+    sp->iNtErNaL_pos = ss8_cstr(str);
+    sp->iNtErNaL_end = sp->iNtErNaL_pos + ss8_len(str);
+    sp->iNtErNaL_delim = NULL;
+    sp->iNtErNaL_delimlen = 1;
+    sp->iNtErNaL_splits = SIZE_MAX;
+    sp->iNtErNaL_ch = '\0';
+    sp->iNtErNaL_kind = kind;
+    sp->iNtErNaL_skip_empty = false;
+    sp->iNtErNaL_done = false;
+}
+
+// Prepare *sp to split *str into the fields separated by the 'delimlen'
+// (which must be nonzero) bytes at 'delim'. Neither *str nor the delimiter may
+// be modified or destroyed until splitting is finished.
+SSSTR_INLINE_DEF void ss8_split_init_bytes(ss8_split *sp, ss8str const *str,
+                                           char const *delim,
+                                           size_t delimlen) {
+    SSSTR_EXTRA_ASSERT(delim != NULL);
+    SSSTR_ASSERT(delimlen > 0);
+    ss8iNtErNaL_split_init(sp, str, 2);
+    sp->iNtErNaL_delim = delim;
+    sp->iNtErNaL_delimlen = delimlen;
+}
+
+// Prepare *sp to split *str into the fields separated by the null-terminated
+// string (which must not be empty) at 'delim'.
+SSSTR_INLINE_DEF void ss8_split_init_cstr(ss8_split *sp, ss8str const *str,
+                                          char const *delim) {
+    SSSTR_EXTRA_ASSERT(delim != NULL);
+    ss8_split_init_bytes(sp, str, delim, strlen(delim));
+}
+
+// Prepare *sp to split *str into the fields separated by *delim (which must
+// not be empty).
+SSSTR_INLINE_DEF void ss8_split_init(ss8_split *sp, ss8str const *str,
+                                     ss8str const *delim) {
+    ss8_split_init_bytes(sp, str, ss8_cstr(delim), ss8_len(delim));
+}
+
+// Prepare *sp to split *str into the fields separated by the byte 'delim'.
+SSSTR_INLINE_DEF void ss8_split_init_ch(ss8_split *sp, ss8str const *str,
+                                        char delim) {
+    ss8iNtErNaL_split_init(sp, str, 0);
+    sp->iNtErNaL_ch = delim;
+}
+
+// Prepare *sp to split *str into the fields separated by any single byte in
+// *delims (which is copied).
+SSSTR_INLINE_DEF void ss8_split_init_set(ss8_split *sp, ss8str const *str,
+                                         ss8_charset const *delims) {
+    SSSTR_EXTRA_ASSERT(delims != NULL);
+    ss8iNtErNaL_split_init(sp, str, 1);
+    sp->iNtErNaL_set = *delims;
+}
+
+// Make *sp skip empty fields; they then do not count toward the limit.
+SSSTR_INLINE_DEF void ss8_split_skip_empty(ss8_split *sp) {
+    sp->iNtErNaL_skip_empty = true;
+}
+
+// Make *sp split at most 'maxsplit' more times; the remainder of the string
+// then becomes the last field.
+SSSTR_INLINE_DEF void ss8_split_limit(ss8_split *sp, size_t maxsplit) {
+    sp->iNtErNaL_splits = maxsplit;
+}
+
+// Return the first delimiter of *sp in [begin, end), or NULL.
+SSSTR_INLINE char const *ss8iNtErNaL_split_find(ss8_split const *sp,
+                                                char const *begin,
+                                                char const *end);
+SSSTR_INLINE_DEF char const *ss8iNtErNaL_split_find(ss8_split const *sp,
+                                                    char const *begin,
+                                                    char const *end) {
+    switch (sp->iNtErNaL_kind) {
+    case 0:
+        return SSSTR_CHARP_MEMCHR(begin, sp->iNtErNaL_ch,
+                                  (size_t)(end - begin));
+    case 1:
+        return ss8iNtErNaL_charset_find(&sp->iNtErNaL_set, begin, end, true);
+    default:
+        return ss8iNtErNaL_memmem(begin, (size_t)(end - begin),
+                                  sp->iNtErNaL_delim, sp->iNtErNaL_delimlen);
+    }
+}
+
+// Set *field to view the next field of the split *sp and return true, or
+// return false if there are no more fields. The fields are views into the
+// string being split, so that their positions in it can be computed from
+// their 'ptr'.
+SSSTR_INLINE_DEF bool ss8_split_next(ss8_split *sp, ss8view *field) {
+    SSSTR_EXTRA_ASSERT(field != NULL);
+    if (sp->iNtErNaL_done)
+        return false;
+    char const *const end = sp->iNtErNaL_end;
+    size_t const dlen = sp->iNtErNaL_delimlen;
+    for (;;) {
+        char const *const b = sp->iNtErNaL_pos;
+        // Once out of splits, we only need to check for a delimiter right at
+        // the start, to skip it if empty fields are being skipped.
+        char const *lim = end;
+        if (sp->iNtErNaL_splits == 0)
+            lim = sp->iNtErNaL_skip_empty && (size_t)(end - b) >= dlen
+                      ? b + dlen
+                      : b;
+        char const *const d = ss8iNtErNaL_split_find(sp, b, lim);
+        if (d == b && sp->iNtErNaL_skip_empty) {
+            sp->iNtErNaL_pos = b + dlen;
+            continue;
+        }
+        if (d == NULL || sp->iNtErNaL_splits == 0) {
+            sp->iNtErNaL_done = true;
+            if (b == end && sp->iNtErNaL_skip_empty)
+                return false;
+            *field = ss8_view_bytes(b, (size_t)(end - b));
+            return true;
+        }
+        *field = ss8_view_bytes(b, (size_t)(d - b));
+        sp->iNtErNaL_pos = d + dlen;
+        --sp->iNtErNaL_splits;
+        return true;
+    }
+}
+
+// Record, as field number 'count' (if less than 'maxfields'), the field from
+// *fstart to the delimiter at 'pos', advance *fstart past the delimiter, and
+// return the new number of fields.
+SSSTR_INLINE size_t ss8iNtErNaL_split_emit(size_t *offsets, size_t maxfields,
+                                           size_t count, size_t *fstart,
+                                           size_t pos);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_split_emit(size_t *offsets,
+                                               size_t maxfields, size_t count,
+                                               size_t *fstart, size_t pos) {
+    if (count < maxfields) {
+        offsets[2 * count] = *fstart;
+        offsets[2 * count + 1] = pos - *fstart;
+    }
+    *fstart = pos + 1;
+    return count + 1;
+}
+
+// The split kernels below record the fields ended by each delimiter (byte in
+// *set) in [p, end), where offsets are relative to 'h' and the current field
+// starts at *fstart, and return the new number of fields. They classify each
+// block of bytes once, rather than restarting a search after each delimiter.
+
+SSSTR_INLINE size_t ss8iNtErNaL_split_into_scalar(
+    ss8_charset const *set, char const *h, char const *p, char const *end,
+    size_t *offsets, size_t maxfields, size_t count, size_t *fstart);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_split_into_scalar(
+    ss8_charset const *set, char const *h, char const *p, char const *end,
+    size_t *offsets, size_t maxfields, size_t count, size_t *fstart) {
+    for (; p < end; ++p) {
+        if (ss8_charset_contains(set, *p))
+            count = ss8iNtErNaL_split_emit(offsets, maxfields, count, fstart,
+                                           (size_t)(p - h));
+    }
+    return count;
+}
+
+#ifdef SSSTR_USE_SSSE3
+SSSTR_TARGET_SSSE3 SSSTR_INLINE size_t ss8iNtErNaL_split_into_ssse3(
+    ss8_charset const *set, char const *h, char const *p, char const *end,
+    size_t *offsets, size_t maxfields, size_t count, size_t *fstart);
+SSSTR_TARGET_SSSE3 SSSTR_INLINE_DEF size_t ss8iNtErNaL_split_into_ssse3(
+    ss8_charset const *set, char const *h, char const *p, char const *end,
+    size_t *offsets, size_t maxfields, size_t count, size_t *fstart) {
+    __m128i const lo = _mm_loadu_si128((__m128i const *)set->iNtErNaL_bits);
+    __m128i const hi =
+        _mm_loadu_si128((__m128i const *)(set->iNtErNaL_bits + 16));
+    for (; end - p >= 16; p += 16) {
+        __m128i const x = _mm_loadu_si128((__m128i const *)p);
+        unsigned mask = ss8iNtErNaL_charset_mask_ssse3(lo, hi, x);
+        size_t const base = (size_t)(p - h);
+        for (; mask != 0; mask &= mask - 1)
+            count = ss8iNtErNaL_split_emit(offsets, maxfields, count, fstart,
+                                           base + ss8iNtErNaL_ctz(mask));
+    }
+    return ss8iNtErNaL_split_into_scalar(set, h, p, end, offsets, maxfields,
+                                         count, fstart);
+}
+#endif
+
+#ifdef SSSTR_USE_AVX2
+SSSTR_TARGET_AVX2 SSSTR_INLINE size_t ss8iNtErNaL_split_into_avx2(
+    ss8_charset const *set, char const *h, char const *p, char const *end,
+    size_t *offsets, size_t maxfields, size_t count, size_t *fstart);
+SSSTR_TARGET_AVX2 SSSTR_INLINE_DEF size_t ss8iNtErNaL_split_into_avx2(
+    ss8_charset const *set, char const *h, char const *p, char const *end,
+    size_t *offsets, size_t maxfields, size_t count, size_t *fstart) {
+    __m256i const lo = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((__m128i const *)set->iNtErNaL_bits));
+    __m256i const hi = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((__m128i const *)(set->iNtErNaL_bits + 16)));
+    for (; end - p >= 32; p += 32) {
+        __m256i const x = _mm256_loadu_si256((__m256i const *)p);
+        unsigned mask = ss8iNtErNaL_charset_mask_avx2(lo, hi, x);
+        size_t const base = (size_t)(p - h);
+        for (; mask != 0; mask &= mask - 1)
+            count = ss8iNtErNaL_split_emit(offsets, maxfields, count, fstart,
+                                           base + ss8iNtErNaL_ctz(mask));
+    }
+    return ss8iNtErNaL_split_into_ssse3(set, h, p, end, offsets, maxfields,
+                                        count, fstart);
+}
+#endif
+
+SSSTR_INLINE size_t ss8iNtErNaL_split_into(ss8_charset const *set,
+                                           char const *h, char const *p,
+                                           char const *end, size_t *offsets,
+                                           size_t maxfields, size_t count,
+                                           size_t *fstart);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_split_into(ss8_charset const *set,
+                                               char const *h, char const *p,
+                                               char const *end,
+                                               size_t *offsets,
+                                               size_t maxfields, size_t count,
+                                               size_t *fstart) {
+#ifdef SSSTR_USE_AVX2
+    if (SSSTR_HAVE_AVX2())
+        return ss8iNtErNaL_split_into_avx2(set, h, p, end, offsets, maxfields,
+                                           count, fstart);
+#endif
+#ifdef SSSTR_USE_SSSE3
+    if (SSSTR_HAVE_SSSE3())
+        return ss8iNtErNaL_split_into_ssse3(set, h, p, end, offsets,
+                                            maxfields, count, fstart);
+#endif
+    return ss8iNtErNaL_split_into_scalar(set, h, p, end, offsets, maxfields,
+                                         count, fstart);
+}
+
+// Store in 'offsets' the start position and length of each of up to
+// 'maxfields' fields of *str, beginning at 'start', that are separated by
+// bytes in *delims ('offsets' must have room for 2 * 'maxfields' elements).
+// Return the total number of fields, which may exceed 'maxfields'.
+SSSTR_INLINE_DEF size_t ss8_split_into_set(ss8str const *str, size_t start,
+                                           ss8_charset const *delims,
+                                           size_t *offsets,
+                                           size_t maxfields) {
+    SSSTR_EXTRA_ASSERT(delims != NULL);
+    SSSTR_EXTRA_ASSERT(offsets != NULL || maxfields == 0);
+    char const *h = ss8_cstr(str);
+    size_t const len = ss8_len(str);
+    SSSTR_ASSERT(start <= len);
+    size_t fstart = start;
+    size_t const count = ss8iNtErNaL_split_into(
+        delims, h, h + start, h + len, offsets, maxfields, 0, &fstart);
+    // The last field is ended by the end of the string.
+    return ss8iNtErNaL_split_emit(offsets, maxfields, count, &fstart, len);
+}
+
+// Like ss8_split_into_set(), but the delimiters are the 'count' bytes at
+// 'delims'.
+SSSTR_INLINE_DEF size_t ss8_split_into_bytes(ss8str const *str, size_t start,
+                                             char const *delims, size_t count,
+                                             size_t *offsets,
+                                             size_t maxfields) {
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, delims, count);
+    return ss8_split_into_set(str, start, &set, offsets, maxfields);
+}
+
+// Like ss8_split_into_set(), but the delimiters are the bytes of the
+// null-terminated string at 'delims'.
+SSSTR_INLINE_DEF size_t ss8_split_into_cstr(ss8str const *str, size_t start,
+                                            char const *delims,
+                                            size_t *offsets,
+                                            size_t maxfields) {
+    SSSTR_EXTRA_ASSERT(delims != NULL);
+    return ss8_split_into_bytes(str, start, delims, strlen(delims), offsets,
+                                maxfields);
+}
+
+// Like ss8_split_into_set(), but the delimiters are the bytes of *delims.
+SSSTR_INLINE_DEF size_t ss8_split_into(ss8str const *str, size_t start,
+                                       ss8str const *delims, size_t *offsets,
+                                       size_t maxfields) {
+    return ss8_split_into_bytes(str, start, ss8_cstr(delims), ss8_len(delims),
+                                offsets, maxfields);
+}
+
+// Chunks start at the size of the first append (but no smaller than the
+// minimum) and double until they reach the maximum.
+enum {
+    ss8iNtErNaL_builder_minchunk = 128,
+    ss8iNtErNaL_builder_chunksize = 16384
+};
+
+// Return the size of chunk 'index' of *b, which must have a first chunk, and
+// set *start to its offset in the contents.
+SSSTR_INLINE size_t ss8iNtErNaL_builder_chunkspan(ss8_builder const *b,
+                                                  size_t index, size_t *start);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_builder_chunkspan(ss8_builder const *b,
+                                                      size_t index,
+                                                      size_t *start) {
+    size_t const maxsize = ss8iNtErNaL_builder_chunksize;
+    size_t size = b->iNtErNaL_firstsize;
+    size_t offset = 0;
+    for (; index > 0 && size < maxsize; --index) {
+        offset += size;
+        size *= 2;
+    }
+    *start = offset + index * maxsize;
+    return size;
+}
+
+// Initialize *b to an empty builder and return 'b'.
+SSSTR_INLINE_DEF ss8_builder *ss8_builder_init(ss8_builder *b) {
+    SSSTR_EXTRA_ASSERT(b != NULL);
+    b->iNtErNaL_chunks = NULL;
+    b->iNtErNaL_nchunks = 0;
+    b->iNtErNaL_capacity = 0;
+    b->iNtErNaL_len = 0;
+    b->iNtErNaL_firstsize = 0;
+    b->iNtErNaL_laststart = 0;
+    b->iNtErNaL_lastsize = 0;
+    return b;
+}
+
+// Destroy *b, deallocating any associated dynamic storage.
+SSSTR_INLINE_DEF void ss8_builder_destroy(ss8_builder *b) {
+    SSSTR_EXTRA_ASSERT(b != NULL);
+    size_t const maxsize = ss8iNtErNaL_builder_chunksize;
+    size_t size = b->iNtErNaL_firstsize;
+    for (size_t i = 0; i < b->iNtErNaL_nchunks; ++i) {
+        SSSTR_FREE_SIZED(b->iNtErNaL_chunks[i], size);
+        if (size < maxsize)
+            size *= 2;
+    }
+    if (b->iNtErNaL_chunks != NULL)
+        SSSTR_FREE_SIZED(b->iNtErNaL_chunks,
+                         b->iNtErNaL_capacity * sizeof(char *));
+}
+
+// Empty *b, keeping its first chunk for reuse, and return 'b'.
+SSSTR_INLINE_DEF ss8_builder *ss8_builder_clear(ss8_builder *b) {
+    SSSTR_EXTRA_ASSERT(b != NULL);
+    size_t const maxsize = ss8iNtErNaL_builder_chunksize;
+    size_t size = b->iNtErNaL_firstsize;
+    for (size_t i = 1; i < b->iNtErNaL_nchunks; ++i) {
+        if (size < maxsize)
+            size *= 2;
+        SSSTR_FREE_SIZED(b->iNtErNaL_chunks[i], size);
+    }
+    if (b->iNtErNaL_nchunks > 1)
+        b->iNtErNaL_nchunks = 1;
+    b->iNtErNaL_len = 0;
+    b->iNtErNaL_laststart = 0;
+    b->iNtErNaL_lastsize = b->iNtErNaL_firstsize;
+    return b;
+}
+
+// Return the length of the contents of *b.
+SSSTR_INLINE_DEF size_t ss8_builder_len(ss8_builder const *b) {
+    SSSTR_EXTRA_ASSERT(b != NULL);
+    return b->iNtErNaL_len;
+}
+
+// Return a pointer to the unused space in the last chunk of *b, adding a chunk
+// if the last one is full, and set *room to the number of bytes available. If
+// this adds the first chunk, it is sized to hold 'want' bytes if possible.
+SSSTR_INLINE char *ss8iNtErNaL_builder_space(ss8_builder *b, size_t want,
+                                             size_t *room);
+SSSTR_INLINE_DEF char *ss8iNtErNaL_builder_space(ss8_builder *b,
+                                                 size_t want, size_t *room) {
+    size_t const maxsize = ss8iNtErNaL_builder_chunksize;
+    size_t const n = b->iNtErNaL_nchunks;
+    size_t const used = b->iNtErNaL_len - b->iNtErNaL_laststart;
+    if (n > 0 && used < b->iNtErNaL_lastsize) {
+        *room = b->iNtErNaL_lastsize - used;
+        return b->iNtErNaL_chunks[n - 1] + used;
+    }
+
+    size_t size;
+    if (n > 0) {
+        size = b->iNtErNaL_lastsize < maxsize ? 2 * b->iNtErNaL_lastsize
+                                              : maxsize;
+    } else {
+        size = ss8iNtErNaL_builder_minchunk;
+        while (size < want && size < maxsize)
+            size *= 2;
+    }
+    if (n == b->iNtErNaL_capacity) {
+        size_t const cap = n > 0 ? 2 * n : 8;
+        if (cap > SIZE_MAX / sizeof(char *))
+            SSSTR_SIZE_OVERFLOW();
+        char **chunks =
+            b->iNtErNaL_chunks == NULL
+                ? (char **)SSSTR_MALLOC(cap * sizeof(char *))
+                : (char **)SSSTR_REALLOC_SIZED(b->iNtErNaL_chunks,
+                                               n * sizeof(char *),
+                                               cap * sizeof(char *));
+        if (chunks == NULL)
+            SSSTR_OUT_OF_MEMORY(cap * sizeof(char *));
+        b->iNtErNaL_chunks = chunks;
+        b->iNtErNaL_capacity = cap;
+    }
+    char *chunk = SSSTR_CHARP_MALLOC(size);
+    if (chunk == NULL)
+        SSSTR_OUT_OF_MEMORY(size);
+    b->iNtErNaL_chunks[n] = chunk;
+    b->iNtErNaL_nchunks = n + 1;
+    if (n == 0)
+        b->iNtErNaL_firstsize = size;
+    b->iNtErNaL_laststart = b->iNtErNaL_len;
+    b->iNtErNaL_lastsize = size;
+    *room = size;
+    return chunk;
+}
+
+// Append the 'srclen' bytes at 'src' to *b and return 'b'.
+SSSTR_INLINE_DEF ss8_builder *ss8_builder_cat_bytes(ss8_builder *b,
+                                                    char const *src,
+                                                    size_t srclen) {
+    SSSTR_EXTRA_ASSERT(b != NULL);
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    size_t const nchunks = b->iNtErNaL_nchunks;
+    if (nchunks > 0) { // Fast path: fits in the last chunk.
+        size_t const used = b->iNtErNaL_len - b->iNtErNaL_laststart;
+        if (srclen <= b->iNtErNaL_lastsize - used) {
+            memcpy(b->iNtErNaL_chunks[nchunks - 1] + used, src, srclen);
+            b->iNtErNaL_len += srclen;
+            return b;
+        }
+    }
+    (void)ss8iNtErNaL_add_sizes(b->iNtErNaL_len, srclen);
+    while (srclen > 0) {
+        size_t room;
+        char *p = ss8iNtErNaL_builder_space(b, srclen, &room);
+        size_t const n = srclen < room ? srclen : room;
+        memcpy(p, src, n);
+        b->iNtErNaL_len += n;
+        src += n;
+        srclen -= n;
+    }
+    return b;
+}
+
+// Append the null-terminated string at 'src' to *b and return 'b'.
+SSSTR_INLINE_DEF ss8_builder *ss8_builder_cat_cstr(ss8_builder *b,
+                                                   char const *src) {
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    return ss8_builder_cat_bytes(b, src, strlen(src));
+}
+
+// Append *src to *b and return 'b'.
+SSSTR_INLINE_DEF ss8_builder *ss8_builder_cat(ss8_builder *b,
+                                              ss8str const *src) {
+    return ss8_builder_cat_bytes(b, ss8_cstr(src), ss8_len(src));
+}
+
+// Append 'count' copies of 'ch' to *b and return 'b'.
+SSSTR_INLINE_DEF ss8_builder *ss8_builder_cat_ch_n(ss8_builder *b, char ch,
+                                                   size_t count) {
+    SSSTR_EXTRA_ASSERT(b != NULL);
+    (void)ss8iNtErNaL_add_sizes(b->iNtErNaL_len, count);
+    while (count > 0) {
+        size_t room;
+        char *p = ss8iNtErNaL_builder_space(b, count, &room);
+        size_t const n = count < room ? count : room;
+        memset(p, ch, n);
+        b->iNtErNaL_len += n;
+        count -= n;
+    }
+    return b;
+}
+
+// Append 'ch' to *b and return 'b'.
+SSSTR_INLINE_DEF ss8_builder *ss8_builder_cat_ch(ss8_builder *b, char ch) {
+    return ss8_builder_cat_ch_n(b, ch, 1);
+}
+
+// Return the number of chunks holding the contents of *b.
+SSSTR_INLINE_DEF size_t ss8_builder_chunk_count(ss8_builder const *b) {
+    SSSTR_EXTRA_ASSERT(b != NULL);
+    size_t const maxsize = ss8iNtErNaL_builder_chunksize;
+    size_t len = b->iNtErNaL_len;
+    if (len == 0)
+        return 0;
+    size_t size = b->iNtErNaL_firstsize;
+    size_t count = 0;
+    for (; len > size && size < maxsize; ++count) {
+        len -= size;
+        size *= 2;
+    }
+    return count + (len + size - 1) / size;
+}
+
+// Return a view of chunk 'index' (which must be less than the chunk count) of
+// *b, valid until *b is modified or destroyed.
+SSSTR_INLINE_DEF ss8view ss8_builder_chunk(ss8_builder const *b,
+                                           size_t index) {
+    SSSTR_ASSERT(index < ss8_builder_chunk_count(b));
+    size_t start;
+    size_t const size = ss8iNtErNaL_builder_chunkspan(b, index, &start);
+    size_t const rest = b->iNtErNaL_len - start;
+    return ss8_view_bytes(b->iNtErNaL_chunks[index],
+                          rest < size ? rest : size);
+}
+
+// Set *dest to the contents of *b and return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_builder_flatten(ss8_builder const *b,
+                                             ss8str *dest) {
+    size_t const n = ss8_builder_chunk_count(b);
+    ss8_clear(dest);
+    ss8_set_len(dest, b->iNtErNaL_len);
+    char *p = ss8_mutable_cstr(dest);
+    for (size_t i = 0; i < n; ++i) {
+        ss8view const chunk = ss8_builder_chunk(b, i);
+        memcpy(p, chunk.ptr, chunk.len);
+        p += chunk.len;
+    }
+    return dest;
+}
+
+// Write the contents of *b to 'stream' and return the number of bytes written,
+// which is less than the length of *b only if an error occurred.
+SSSTR_INLINE_DEF size_t ss8_builder_fwrite(ss8_builder const *b,
+                                           FILE *stream) {
+    SSSTR_EXTRA_ASSERT(stream != NULL);
+    size_t const n = ss8_builder_chunk_count(b);
+    size_t written = 0;
+    for (size_t i = 0; i < n; ++i) {
+        ss8view const chunk = ss8_builder_chunk(b, i);
+        size_t const w = fwrite(chunk.ptr, 1, chunk.len, stream);
+        written += w;
+        if (w < chunk.len)
+            break;
+    }
+    return written;
+}
+
+struct ss8iNtErNaL_ropenode {
+    struct ss8iNtErNaL_ropenode *iNtErNaL_left;
+    struct ss8iNtErNaL_ropenode *iNtErNaL_right;
+    size_t iNtErNaL_len; // Total length of this subtree
+    uint32_t iNtErNaL_prio;
+    ss8str iNtErNaL_piece;
+};
+typedef struct ss8iNtErNaL_ropenode ss8iNtErNaL_ropenode;
+
+// Pieces are kept at most this long, so that editing within one is cheap.
+enum { ss8iNtErNaL_rope_maxpiece = 1024 };
+
+SSSTR_INLINE size_t ss8iNtErNaL_rope_nodelen(ss8iNtErNaL_ropenode const *node);
+SSSTR_INLINE_DEF size_t
+ss8iNtErNaL_rope_nodelen(ss8iNtErNaL_ropenode const *node) {
+    return node != NULL ? node->iNtErNaL_len : 0;
+}
+
+SSSTR_INLINE void ss8iNtErNaL_rope_update(ss8iNtErNaL_ropenode *node);
+SSSTR_INLINE_DEF void ss8iNtErNaL_rope_update(ss8iNtErNaL_ropenode *node) {
+    node->iNtErNaL_len = ss8iNtErNaL_rope_nodelen(node->iNtErNaL_left) +
+                         ss8_len(&node->iNtErNaL_piece) +
+                         ss8iNtErNaL_rope_nodelen(node->iNtErNaL_right);
+}
+
+// Allocate a leaf node holding the 'len' bytes at 'src' and priority 'prio'.
+SSSTR_INLINE ss8iNtErNaL_ropenode *
+ss8iNtErNaL_rope_newnode(char const *src, size_t len, uint32_t prio);
+SSSTR_INLINE_DEF ss8iNtErNaL_ropenode *
+ss8iNtErNaL_rope_newnode(char const *src, size_t len, uint32_t prio) {
+    ss8iNtErNaL_ropenode *node =
+        (ss8iNtErNaL_ropenode *)SSSTR_MALLOC(sizeof(ss8iNtErNaL_ropenode));
+    if (node == NULL)
+        SSSTR_OUT_OF_MEMORY(sizeof(ss8iNtErNaL_ropenode));
+    node->iNtErNaL_left = NULL;
+    node->iNtErNaL_right = NULL;
+    node->iNtErNaL_len = len;
+    node->iNtErNaL_prio = prio;
+    ss8_init_copy_bytes(&node->iNtErNaL_piece, src, len);
+    return node;
+}
+
+SSSTR_INLINE void ss8iNtErNaL_rope_free(ss8iNtErNaL_ropenode *node);
+SSSTR_INLINE_DEF void ss8iNtErNaL_rope_free(ss8iNtErNaL_ropenode *node) {
+    while (node != NULL) { // Recurse left, iterate right.
+        ss8iNtErNaL_rope_free(node->iNtErNaL_left);
+        ss8iNtErNaL_ropenode *right = node->iNtErNaL_right;
+        ss8_destroy(&node->iNtErNaL_piece);
+        SSSTR_FREE_SIZED(node, sizeof(ss8iNtErNaL_ropenode));
+        node = right;
+    }
+}
+
+// Return the next pseudorandom node priority for *rope (xorshift32).
+SSSTR_INLINE uint32_t ss8iNtErNaL_rope_prio(ss8_rope *rope);
+SSSTR_INLINE_DEF uint32_t ss8iNtErNaL_rope_prio(ss8_rope *rope) {
+    uint32_t x = rope->iNtErNaL_seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rope->iNtErNaL_seed = x;
+    return x;
+}
+
+// Join two treaps, all of whose contents are in order.
+SSSTR_INLINE ss8iNtErNaL_ropenode *
+ss8iNtErNaL_rope_merge(ss8iNtErNaL_ropenode *a, ss8iNtErNaL_ropenode *b);
+SSSTR_INLINE_DEF ss8iNtErNaL_ropenode *
+ss8iNtErNaL_rope_merge(ss8iNtErNaL_ropenode *a, ss8iNtErNaL_ropenode *b) {
+    if (a == NULL)
+        return b;
+    if (b == NULL)
+        return a;
+    if (a->iNtErNaL_prio >= b->iNtErNaL_prio) {
+        a->iNtErNaL_right = ss8iNtErNaL_rope_merge(a->iNtErNaL_right, b);
+        ss8iNtErNaL_rope_update(a);
+        return a;
+    }
+    b->iNtErNaL_left = ss8iNtErNaL_rope_merge(a, b->iNtErNaL_left);
+    ss8iNtErNaL_rope_update(b);
+    return b;
+}
+
+// Split the treap at 'node' into the first 'pos' bytes (*l) and the rest (*r),
+// splitting a piece if necessary.
+SSSTR_INLINE void ss8iNtErNaL_rope_split(ss8iNtErNaL_ropenode *node,
+                                         size_t pos,
+                                         ss8iNtErNaL_ropenode **l,
+                                         ss8iNtErNaL_ropenode **r);
+SSSTR_INLINE_DEF void ss8iNtErNaL_rope_split(ss8iNtErNaL_ropenode *node,
+                                             size_t pos,
+                                             ss8iNtErNaL_ropenode **l,
+                                             ss8iNtErNaL_ropenode **r) {
+    if (node == NULL) {
+        *l = *r = NULL;
+        return;
+    }
+    size_t const leftlen = ss8iNtErNaL_rope_nodelen(node->iNtErNaL_left);
+    size_t const piecelen = ss8_len(&node->iNtErNaL_piece);
+    if (pos <= leftlen) {
+        ss8iNtErNaL_rope_split(node->iNtErNaL_left, pos, l,
+                               &node->iNtErNaL_left);
+        ss8iNtErNaL_rope_update(node);
+        *r = node;
+    } else if (pos >= leftlen + piecelen) {
+        ss8iNtErNaL_rope_split(node->iNtErNaL_right, pos - leftlen - piecelen,
+                               &node->iNtErNaL_right, r);
+        ss8iNtErNaL_rope_update(node);
+        *l = node;
+    } else {
+        // The tail of the piece goes to a new node with the same priority,
+        // which keeps the heap order as the parent of the right subtree.
+        size_t const off = pos - leftlen;
+        ss8iNtErNaL_ropenode *tail = ss8iNtErNaL_rope_newnode(
+            ss8_cstr(&node->iNtErNaL_piece) + off, piecelen - off,
+            node->iNtErNaL_prio);
+        tail->iNtErNaL_right = node->iNtErNaL_right;
+        ss8iNtErNaL_rope_update(tail);
+        ss8_set_len(&node->iNtErNaL_piece, off);
+        node->iNtErNaL_right = NULL;
+        ss8iNtErNaL_rope_update(node);
+        *l = node;
+        *r = tail;
+    }
+}
+
+// Return the node whose piece contains position 'pos' (which must be less
+// than the length) of the treap at 'node', and set *off to the offset of
+// 'pos' within the piece.
+SSSTR_INLINE ss8iNtErNaL_ropenode const *
+ss8iNtErNaL_rope_locate(ss8iNtErNaL_ropenode const *node, size_t pos,
+                        size_t *off);
+SSSTR_INLINE_DEF ss8iNtErNaL_ropenode const *
+ss8iNtErNaL_rope_locate(ss8iNtErNaL_ropenode const *node, size_t pos,
+                        size_t *off) {
+    for (;;) {
+        size_t const leftlen = ss8iNtErNaL_rope_nodelen(node->iNtErNaL_left);
+        if (pos < leftlen) {
+            node = node->iNtErNaL_left;
+            continue;
+        }
+        pos -= leftlen;
+        size_t const piecelen = ss8_len(&node->iNtErNaL_piece);
+        if (pos < piecelen) {
+            *off = pos;
+            return node;
+        }
+        pos -= piecelen;
+        node = node->iNtErNaL_right;
+    }
+}
+
+// Copy the contents of the treap at 'node' to 'dest' and return the end.
+SSSTR_INLINE char *ss8iNtErNaL_rope_write(ss8iNtErNaL_ropenode const *node,
+                                          char *dest);
+SSSTR_INLINE_DEF char *
+ss8iNtErNaL_rope_write(ss8iNtErNaL_ropenode const *node, char *dest) {
+    while (node != NULL) {
+        dest = ss8iNtErNaL_rope_write(node->iNtErNaL_left, dest);
+        size_t const piecelen = ss8_len(&node->iNtErNaL_piece);
+        memcpy(dest, ss8_cstr(&node->iNtErNaL_piece), piecelen);
+        dest += piecelen;
+        node = node->iNtErNaL_right;
+    }
+    return dest;
+}
+
+// Insert into the existing piece at position 'pos' of the treap at 'node', if
+// it has room, and return whether done.
+SSSTR_INLINE bool ss8iNtErNaL_rope_insert_into(ss8iNtErNaL_ropenode *node,
+                                               size_t pos, char const *src,
+                                               size_t srclen);
+SSSTR_INLINE_DEF bool ss8iNtErNaL_rope_insert_into(ss8iNtErNaL_ropenode *node,
+                                                   size_t pos,
+                                                   char const *src,
+                                                   size_t srclen) {
+    if (node == NULL)
+        return false;
+    size_t const leftlen = ss8iNtErNaL_rope_nodelen(node->iNtErNaL_left);
+    size_t const piecelen = ss8_len(&node->iNtErNaL_piece);
+    bool done;
+    if (pos < leftlen || (pos == leftlen && node->iNtErNaL_left != NULL)) {
+        done = ss8iNtErNaL_rope_insert_into(node->iNtErNaL_left, pos, src,
+                                            srclen);
+    } else if (pos <= leftlen + piecelen) {
+        done = piecelen + srclen <= ss8iNtErNaL_rope_maxpiece;
+        if (done)
+            ss8_insert_bytes(&node->iNtErNaL_piece, pos - leftlen, src,
+                             srclen);
+    } else {
+        done = ss8iNtErNaL_rope_insert_into(
+            node->iNtErNaL_right, pos - leftlen - piecelen, src, srclen);
+    }
+    if (done)
+        node->iNtErNaL_len += srclen;
+    return done;
+}
+
+// Erase from the existing piece at position 'pos' of the treap at 'node', if
+// the range lies strictly within that piece, and return whether done.
+SSSTR_INLINE bool ss8iNtErNaL_rope_erase_from(ss8iNtErNaL_ropenode *node,
+                                              size_t pos, size_t len);
+SSSTR_INLINE_DEF bool ss8iNtErNaL_rope_erase_from(ss8iNtErNaL_ropenode *node,
+                                                  size_t pos, size_t len) {
+    size_t const leftlen = ss8iNtErNaL_rope_nodelen(node->iNtErNaL_left);
+    size_t const piecelen = ss8_len(&node->iNtErNaL_piece);
+    bool done;
+    if (pos < leftlen) {
+        done = ss8iNtErNaL_rope_erase_from(node->iNtErNaL_left, pos, len);
+    } else if (pos < leftlen + piecelen) {
+        done = len < piecelen - (pos - leftlen);
+        if (done)
+            ss8_erase(&node->iNtErNaL_piece, pos - leftlen, len);
+    } else {
+        done = ss8iNtErNaL_rope_erase_from(node->iNtErNaL_right,
+                                           pos - leftlen - piecelen, len);
+    }
+    if (done)
+        node->iNtErNaL_len -= len;
+    return done;
+}
+
+// Join the pieces on either side of 'pos', which must be a piece boundary of
+// *rope, if they fit in one piece; return whether joined.
+SSSTR_INLINE bool ss8iNtErNaL_rope_join(ss8_rope *rope, size_t pos);
+SSSTR_INLINE_DEF bool ss8iNtErNaL_rope_join(ss8_rope *rope, size_t pos) {
+    if (pos == 0 || pos >= ss8iNtErNaL_rope_nodelen(rope->iNtErNaL_root))
+        return false;
+    size_t off;
+    ss8iNtErNaL_ropenode const *before =
+        ss8iNtErNaL_rope_locate(rope->iNtErNaL_root, pos - 1, &off);
+    ss8iNtErNaL_ropenode const *after =
+        ss8iNtErNaL_rope_locate(rope->iNtErNaL_root, pos, &off);
+    size_t const blen = ss8_len(&after->iNtErNaL_piece);
+    if (ss8_len(&before->iNtErNaL_piece) + blen > ss8iNtErNaL_rope_maxpiece)
+        return false;
+
+    ss8iNtErNaL_ropenode *l;
+    ss8iNtErNaL_ropenode *r;
+    ss8iNtErNaL_rope_split(rope->iNtErNaL_root, pos, &l, &r);
+    ss8iNtErNaL_ropenode *a = l;
+    while (a->iNtErNaL_right != NULL)
+        a = a->iNtErNaL_right;
+    ss8iNtErNaL_ropenode *b = r;
+    while (b->iNtErNaL_left != NULL)
+        b = b->iNtErNaL_left;
+    ss8_cat(&a->iNtErNaL_piece, &b->iNtErNaL_piece);
+    // Every node on the right spine of l has a in its subtree.
+    for (ss8iNtErNaL_ropenode *node = l; node != NULL;
+         node = node->iNtErNaL_right)
+        node->iNtErNaL_len += blen;
+    ss8iNtErNaL_rope_split(r, blen, &b, &r);
+    ss8iNtErNaL_rope_free(b);
+    rope->iNtErNaL_root = ss8iNtErNaL_rope_merge(l, r);
+    return true;
+}
+
+// Join the piece of *rope containing position 'pos' (or the last piece, if
+// 'pos' is the end) with its neighbors, where they fit in one piece.
+SSSTR_INLINE void ss8iNtErNaL_rope_coalesce(ss8_rope *rope, size_t pos);
+SSSTR_INLINE_DEF void ss8iNtErNaL_rope_coalesce(ss8_rope *rope, size_t pos) {
+    size_t const len = ss8iNtErNaL_rope_nodelen(rope->iNtErNaL_root);
+    if (len == 0)
+        return;
+    size_t const at = pos < len ? pos : len - 1;
+    size_t off;
+    ss8iNtErNaL_ropenode const *node =
+        ss8iNtErNaL_rope_locate(rope->iNtErNaL_root, at, &off);
+    size_t const start = at - off;
+    (void)ss8iNtErNaL_rope_join(rope,
+                                start + ss8_len(&node->iNtErNaL_piece));
+    (void)ss8iNtErNaL_rope_join(rope, start);
+}
+
+// Initialize *rope to the empty string and return 'rope'.
+SSSTR_INLINE_DEF ss8_rope *ss8_rope_init(ss8_rope *rope) {
+    SSSTR_EXTRA_ASSERT(rope != NULL);
+    rope->iNtErNaL_root = NULL;
+    rope->iNtErNaL_seed = 2463534242u;
+    return rope;
+}
+
+// Destroy *rope, deallocating any associated dynamic storage.
+SSSTR_INLINE_DEF void ss8_rope_destroy(ss8_rope *rope) {
+    SSSTR_EXTRA_ASSERT(rope != NULL);
+    ss8iNtErNaL_rope_free(rope->iNtErNaL_root);
+}
+
+// Set *rope to the empty string and return 'rope'.
+SSSTR_INLINE_DEF ss8_rope *ss8_rope_clear(ss8_rope *rope) {
+    SSSTR_EXTRA_ASSERT(rope != NULL);
+    ss8iNtErNaL_rope_free(rope->iNtErNaL_root);
+    rope->iNtErNaL_root = NULL;
+    return rope;
+}
+
+// Return the length of *rope.
+SSSTR_INLINE_DEF size_t ss8_rope_len(ss8_rope const *rope) {
+    SSSTR_EXTRA_ASSERT(rope != NULL);
+    return ss8iNtErNaL_rope_nodelen(rope->iNtErNaL_root);
+}
+
+// Insert the 'srclen' bytes at 'src' at position 'pos' of *rope and return
+// 'rope'.
+SSSTR_INLINE_DEF ss8_rope *ss8_rope_insert_bytes(ss8_rope *rope, size_t pos,
+                                                 char const *src,
+                                                 size_t srclen) {
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    size_t const len = ss8_rope_len(rope);
+    SSSTR_ASSERT(pos <= len);
+    (void)ss8iNtErNaL_add_sizes(len, srclen);
+    if (srclen == 0 || ss8iNtErNaL_rope_insert_into(rope->iNtErNaL_root, pos,
+                                                    src, srclen))
+        return rope;
+
+    ss8iNtErNaL_ropenode *l;
+    ss8iNtErNaL_ropenode *r;
+    ss8iNtErNaL_rope_split(rope->iNtErNaL_root, pos, &l, &r);
+    while (srclen > 0) {
+        size_t const n = srclen < ss8iNtErNaL_rope_maxpiece
+                             ? srclen
+                             : (size_t)ss8iNtErNaL_rope_maxpiece;
+        l = ss8iNtErNaL_rope_merge(
+            l, ss8iNtErNaL_rope_newnode(src, n, ss8iNtErNaL_rope_prio(rope)));
+        src += n;
+        srclen -= n;
+    }
+    rope->iNtErNaL_root = ss8iNtErNaL_rope_merge(l, r);
+    return rope;
+}
+
+// Insert the null-terminated string at 'src' at position 'pos' of *rope and
+// return 'rope'.
+SSSTR_INLINE_DEF ss8_rope *ss8_rope_insert_cstr(ss8_rope *rope, size_t pos,
+                                                char const *src) {
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    return ss8_rope_insert_bytes(rope, pos, src, strlen(src));
+}
+
+// Insert *src at position 'pos' of *rope and return 'rope'.
+SSSTR_INLINE_DEF ss8_rope *ss8_rope_insert(ss8_rope *rope, size_t pos,
+                                           ss8str const *src) {
+    return ss8_rope_insert_bytes(rope, pos, ss8_cstr(src), ss8_len(src));
+}
+
+// Remove at most 'len' bytes from *rope starting at position 'pos' and return
+// 'rope'.
+SSSTR_INLINE_DEF ss8_rope *ss8_rope_erase(ss8_rope *rope, size_t pos,
+                                          size_t len) {
+    size_t const ropelen = ss8_rope_len(rope);
+    SSSTR_ASSERT(pos <= ropelen);
+    if (len >= ropelen - pos)
+        len = ropelen - pos;
+    if (len == 0)
+        return rope;
+    if (!ss8iNtErNaL_rope_erase_from(rope->iNtErNaL_root, pos, len)) {
+        ss8iNtErNaL_ropenode *l;
+        ss8iNtErNaL_ropenode *m;
+        ss8iNtErNaL_ropenode *r;
+        ss8iNtErNaL_rope_split(rope->iNtErNaL_root, pos, &l, &r);
+        ss8iNtErNaL_rope_split(r, len, &m, &r);
+        ss8iNtErNaL_rope_free(m);
+        rope->iNtErNaL_root = ss8iNtErNaL_rope_merge(l, r);
+        (void)ss8iNtErNaL_rope_join(rope, pos);
+    }
+    // Keep erasures from leaving runs of small pieces behind.
+    ss8iNtErNaL_rope_coalesce(rope, pos);
+    return rope;
+}
+
+// Set *rope to the 'srclen' bytes at 'src' and return 'rope'.
+SSSTR_INLINE_DEF ss8_rope *ss8_rope_copy_bytes(ss8_rope *rope, char const *src,
+                                               size_t srclen) {
+    return ss8_rope_insert_bytes(ss8_rope_clear(rope), 0, src, srclen);
+}
+
+// Set *rope to the null-terminated string at 'src' and return 'rope'.
+SSSTR_INLINE_DEF ss8_rope *ss8_rope_copy_cstr(ss8_rope *rope,
+                                              char const *src) {
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    return ss8_rope_copy_bytes(rope, src, strlen(src));
+}
+
+// Set *rope to the contents of *src and return 'rope'.
+SSSTR_INLINE_DEF ss8_rope *ss8_rope_copy(ss8_rope *rope, ss8str const *src) {
+    return ss8_rope_copy_bytes(rope, ss8_cstr(src), ss8_len(src));
+}
+
+// Set *dest to the contents of *rope and return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_rope_flatten(ss8_rope const *rope,
+                                          ss8str *dest) {
+    ss8_clear(dest);
+    ss8_set_len(dest, ss8_rope_len(rope));
+    ss8iNtErNaL_rope_write(rope->iNtErNaL_root, ss8_mutable_cstr(dest));
+    return dest;
+}
+
+// Return the byte at position 'pos' (which must be less than the length) of
+// *rope.
+SSSTR_INLINE_DEF char ss8_rope_at(ss8_rope const *rope, size_t pos) {
+    SSSTR_ASSERT(pos < ss8_rope_len(rope));
+    size_t off;
+    ss8iNtErNaL_ropenode const *node =
+        ss8iNtErNaL_rope_locate(rope->iNtErNaL_root, pos, &off);
+    return ss8_cstr(&node->iNtErNaL_piece)[off];
+}
+
+// Initialize *cur to point to position 'pos' (which must be in range) of
+// *rope and return 'cur'. The cursor is invalidated by modifying *rope.
+SSSTR_INLINE_DEF ss8_rope_cursor *ss8_rope_cursor_init(ss8_rope_cursor *cur,
+                                                       ss8_rope const *rope,
+                                                       size_t pos) {
+    SSSTR_EXTRA_ASSERT(cur != NULL);
+    SSSTR_ASSERT(pos <= ss8_rope_len(rope));
+    cur->iNtErNaL_rope = rope;
+    cur->iNtErNaL_pos = pos;
+    cur->iNtErNaL_ptr = NULL;
+    cur->iNtErNaL_end = NULL;
+    return cur;
+}
+
+// Return the position of *cur in its rope.
+SSSTR_INLINE_DEF size_t ss8_rope_cursor_pos(ss8_rope_cursor const *cur) {
+    return cur->iNtErNaL_pos;
+}
+
+// Set *chunk to view the bytes from *cur to the end of the piece containing
+// it, advance *cur past them, and return true; or return false if *cur is at
+// the end of its rope.
+SSSTR_INLINE_DEF bool ss8_rope_cursor_next_chunk(ss8_rope_cursor *cur,
+                                                 ss8view *chunk) {
+    SSSTR_EXTRA_ASSERT(chunk != NULL);
+    if (cur->iNtErNaL_ptr == cur->iNtErNaL_end) {
+        if (cur->iNtErNaL_pos == ss8_rope_len(cur->iNtErNaL_rope))
+            return false;
+        size_t off;
+        ss8iNtErNaL_ropenode const *node = ss8iNtErNaL_rope_locate(
+            cur->iNtErNaL_rope->iNtErNaL_root, cur->iNtErNaL_pos, &off);
+        cur->iNtErNaL_ptr = ss8_cstr(&node->iNtErNaL_piece) + off;
+        cur->iNtErNaL_end = ss8_cstr(&node->iNtErNaL_piece) +
+                            ss8_len(&node->iNtErNaL_piece);
+    }
+    *chunk = ss8_view_bytes(cur->iNtErNaL_ptr,
+                            (size_t)(cur->iNtErNaL_end - cur->iNtErNaL_ptr));
+    cur->iNtErNaL_pos += chunk->len;
+    cur->iNtErNaL_ptr = cur->iNtErNaL_end;
+    return true;
+}
+
+// Return the byte at *cur (as an unsigned char converted to int) and advance
+// *cur by one, or return EOF if *cur is at the end of its rope.
+SSSTR_INLINE_DEF int ss8_rope_cursor_next(ss8_rope_cursor *cur) {
+    if (cur->iNtErNaL_ptr == cur->iNtErNaL_end) {
+        ss8view chunk;
+        if (!ss8_rope_cursor_next_chunk(cur, &chunk))
+            return EOF;
+        // Rewind to the start of the chunk.
+        cur->iNtErNaL_pos -= chunk.len;
+        cur->iNtErNaL_ptr = chunk.ptr;
+    }
+    ++cur->iNtErNaL_pos;
+    return (unsigned char)*cur->iNtErNaL_ptr++;
+}
+
+// Set *dest to the substring of *rope starting at 'start' (which must be in
+// range) and having length at most 'len'; return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_rope_copy_substr(ss8str *dest,
+                                              ss8_rope const *rope,
+                                              size_t start, size_t len) {
+    size_t const ropelen = ss8_rope_len(rope);
+    SSSTR_ASSERT(start <= ropelen);
+    if (len >= ropelen - start)
+        len = ropelen - start;
+    ss8_clear(dest);
+    ss8_reserve(dest, len);
+    ss8_rope_cursor cur;
+    ss8_rope_cursor_init(&cur, rope, start);
+    ss8view chunk;
+    while (ss8_len(dest) < len && ss8_rope_cursor_next_chunk(&cur, &chunk)) {
+        size_t const want = len - ss8_len(dest);
+        ss8_cat_bytes(dest, chunk.ptr, chunk.len < want ? chunk.len : want);
+    }
+    return dest;
+}
+
+// Initialize *gb to the empty string and return 'gb'.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_init(ss8_gapbuf *gb) {
+    SSSTR_EXTRA_ASSERT(gb != NULL);
+    gb->iNtErNaL_buf = NULL;
+    gb->iNtErNaL_bufsize = 0;
+    gb->iNtErNaL_gapstart = 0;
+    gb->iNtErNaL_gapend = 0;
+    return gb;
+}
+
+// Destroy *gb, deallocating any associated dynamic storage.
+SSSTR_INLINE_DEF void ss8_gapbuf_destroy(ss8_gapbuf *gb) {
+    SSSTR_EXTRA_ASSERT(gb != NULL);
+    if (gb->iNtErNaL_buf != NULL)
+        SSSTR_FREE_SIZED(gb->iNtErNaL_buf, gb->iNtErNaL_bufsize);
+}
+
+// Set *gb to the empty string, keeping its buffer, and return 'gb'.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_clear(ss8_gapbuf *gb) {
+    SSSTR_EXTRA_ASSERT(gb != NULL);
+    gb->iNtErNaL_gapstart = 0;
+    gb->iNtErNaL_gapend = gb->iNtErNaL_bufsize;
+    return gb;
+}
+
+// Return the length of *gb.
+SSSTR_INLINE_DEF size_t ss8_gapbuf_len(ss8_gapbuf const *gb) {
+    SSSTR_EXTRA_ASSERT(gb != NULL);
+    return gb->iNtErNaL_bufsize -
+           (gb->iNtErNaL_gapend - gb->iNtErNaL_gapstart);
+}
+
+// Return the cursor position of *gb.
+SSSTR_INLINE_DEF size_t ss8_gapbuf_cursor(ss8_gapbuf const *gb) {
+    SSSTR_EXTRA_ASSERT(gb != NULL);
+    return gb->iNtErNaL_gapstart;
+}
+
+// Move the cursor of *gb to 'pos' (which must be in range) and return 'gb'.
+// This moves the bytes between the old and new cursor positions.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_set_cursor(ss8_gapbuf *gb,
+                                                   size_t pos) {
+    SSSTR_ASSERT(pos <= ss8_gapbuf_len(gb));
+    char *buf = gb->iNtErNaL_buf;
+    size_t const gapstart = gb->iNtErNaL_gapstart;
+    size_t const gaplen = gb->iNtErNaL_gapend - gapstart;
+    if (pos < gapstart)
+        memmove(buf + pos + gaplen, buf + pos, gapstart - pos);
+    else if (pos > gapstart)
+        memmove(buf + gapstart, buf + gapstart + gaplen, pos - gapstart);
+    gb->iNtErNaL_gapstart = pos;
+    gb->iNtErNaL_gapend = pos + gaplen;
+    return gb;
+}
+
+// Make the gap of *gb at least 'mingap' bytes long.
+SSSTR_INLINE void ss8iNtErNaL_gapbuf_grow(ss8_gapbuf *gb, size_t mingap);
+SSSTR_INLINE_DEF void ss8iNtErNaL_gapbuf_grow(ss8_gapbuf *gb, size_t mingap) {
+    size_t const bufsize = gb->iNtErNaL_bufsize;
+    size_t const gapend = gb->iNtErNaL_gapend;
+    if (mingap <= gapend - gb->iNtErNaL_gapstart)
+        return;
+    size_t const len = ss8_gapbuf_len(gb);
+    size_t newsize = ss8iNtErNaL_growcap(
+        bufsize, ss8iNtErNaL_add_sizes(len, mingap));
+    if (newsize < 64)
+        newsize = 64;
+    char *buf = gb->iNtErNaL_buf == NULL
+                    ? SSSTR_CHARP_MALLOC(newsize)
+                    : SSSTR_CHARP_REALLOC_SIZED(gb->iNtErNaL_buf, bufsize,
+                                                newsize);
+    if (buf == NULL)
+        SSSTR_OUT_OF_MEMORY(newsize);
+    size_t const taillen = bufsize - gapend;
+    memmove(buf + newsize - taillen, buf + gapend, taillen);
+    gb->iNtErNaL_buf = buf;
+    gb->iNtErNaL_bufsize = newsize;
+    gb->iNtErNaL_gapend = newsize - taillen;
+}
+
+// Insert the 'srclen' bytes at 'src' at the cursor of *gb, leaving the cursor
+// after them, and return 'gb'.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_insert_bytes(ss8_gapbuf *gb,
+                                                     char const *src,
+                                                     size_t srclen) {
+    SSSTR_EXTRA_ASSERT(gb != NULL);
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    ss8iNtErNaL_gapbuf_grow(gb, srclen);
+    if (srclen > 0)
+        memcpy(gb->iNtErNaL_buf + gb->iNtErNaL_gapstart, src, srclen);
+    gb->iNtErNaL_gapstart += srclen;
+    return gb;
+}
+
+// Insert the null-terminated string at 'src' at the cursor of *gb, leaving
+// the cursor after it, and return 'gb'.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_insert_cstr(ss8_gapbuf *gb,
+                                                    char const *src) {
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    return ss8_gapbuf_insert_bytes(gb, src, strlen(src));
+}
+
+// Insert *src at the cursor of *gb, leaving the cursor after it, and return
+// 'gb'.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_insert(ss8_gapbuf *gb,
+                                               ss8str const *src) {
+    return ss8_gapbuf_insert_bytes(gb, ss8_cstr(src), ss8_len(src));
+}
+
+// Insert 'ch' at the cursor of *gb, leaving the cursor after it, and return
+// 'gb'.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_insert_ch(ss8_gapbuf *gb, char ch) {
+    SSSTR_EXTRA_ASSERT(gb != NULL);
+    if (gb->iNtErNaL_gapstart == gb->iNtErNaL_gapend)
+        ss8iNtErNaL_gapbuf_grow(gb, 1);
+    gb->iNtErNaL_buf[gb->iNtErNaL_gapstart++] = ch;
+    return gb;
+}
+
+// Remove at most 'len' bytes before the cursor of *gb and return 'gb'.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_erase_before(ss8_gapbuf *gb,
+                                                     size_t len) {
+    SSSTR_EXTRA_ASSERT(gb != NULL);
+    if (len > gb->iNtErNaL_gapstart)
+        len = gb->iNtErNaL_gapstart;
+    gb->iNtErNaL_gapstart -= len;
+    return gb;
+}
+
+// Remove at most 'len' bytes after the cursor of *gb and return 'gb'.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_erase_after(ss8_gapbuf *gb,
+                                                    size_t len) {
+    SSSTR_EXTRA_ASSERT(gb != NULL);
+    size_t const after = gb->iNtErNaL_bufsize - gb->iNtErNaL_gapend;
+    if (len > after)
+        len = after;
+    gb->iNtErNaL_gapend += len;
+    return gb;
+}
+
+// Set *gb to the 'srclen' bytes at 'src', with the cursor at the end, and
+// return 'gb'.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_copy_bytes(ss8_gapbuf *gb,
+                                                   char const *src,
+                                                   size_t srclen) {
+    return ss8_gapbuf_insert_bytes(ss8_gapbuf_clear(gb), src, srclen);
+}
+
+// Set *gb to the null-terminated string at 'src', with the cursor at the end,
+// and return 'gb'.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_copy_cstr(ss8_gapbuf *gb,
+                                                  char const *src) {
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    return ss8_gapbuf_copy_bytes(gb, src, strlen(src));
+}
+
+// Set *gb to the contents of *src, with the cursor at the end, and return
+// 'gb'.
+SSSTR_INLINE_DEF ss8_gapbuf *ss8_gapbuf_copy(ss8_gapbuf *gb,
+                                             ss8str const *src) {
+    return ss8_gapbuf_copy_bytes(gb, ss8_cstr(src), ss8_len(src));
+}
+
+// Return the byte at position 'pos' (which must be less than the length) of
+// *gb.
+SSSTR_INLINE_DEF char ss8_gapbuf_at(ss8_gapbuf const *gb, size_t pos) {
+    SSSTR_ASSERT(pos < ss8_gapbuf_len(gb));
+    if (pos >= gb->iNtErNaL_gapstart)
+        pos += gb->iNtErNaL_gapend - gb->iNtErNaL_gapstart;
+    return gb->iNtErNaL_buf[pos];
+}
+
+// Set *dest to the contents of *gb and return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_gapbuf_flatten(ss8_gapbuf const *gb,
+                                            ss8str *dest) {
+    size_t const before = gb->iNtErNaL_gapstart;
+    size_t const after = gb->iNtErNaL_bufsize - gb->iNtErNaL_gapend;
+    ss8_clear(dest);
+    ss8_set_len(dest, before + after);
+    if (before + after > 0) {
+        char *p = ss8_mutable_cstr(dest);
+        memcpy(p, gb->iNtErNaL_buf, before);
+        memcpy(p + before, gb->iNtErNaL_buf + gb->iNtErNaL_gapend, after);
+    }
+    return dest;
+}
+
+// Consumed space at the front of an ss8_streambuf is reclaimed (by moving the
+// unconsumed data) only once it is at least this large and at least as large
+// as the unconsumed data, so that each byte is moved O(1) times on average.
+enum { ss8iNtErNaL_streambuf_minwaste = 4096 };
+
+// Initialize *sb to be empty and return 'sb'.
+SSSTR_INLINE_DEF ss8_streambuf *ss8_streambuf_init(ss8_streambuf *sb) {
+    SSSTR_EXTRA_ASSERT(sb != NULL);
+    ss8_init(&sb->iNtErNaL_buf);
+    sb->iNtErNaL_head = 0;
+    return sb;
+}
+
+// Destroy *sb, deallocating any associated dynamic storage.
+SSSTR_INLINE_DEF void ss8_streambuf_destroy(ss8_streambuf *sb) {
+    SSSTR_EXTRA_ASSERT(sb != NULL);
+    ss8_destroy(&sb->iNtErNaL_buf);
+}
+
+// Discard the contents of *sb, keeping its buffer, and return 'sb'.
+SSSTR_INLINE_DEF ss8_streambuf *ss8_streambuf_clear(ss8_streambuf *sb) {
+    SSSTR_EXTRA_ASSERT(sb != NULL);
+    ss8_clear(&sb->iNtErNaL_buf);
+    sb->iNtErNaL_head = 0;
+    return sb;
+}
+
+// Return the length of the unconsumed contents of *sb.
+SSSTR_INLINE_DEF size_t ss8_streambuf_len(ss8_streambuf const *sb) {
+    SSSTR_EXTRA_ASSERT(sb != NULL);
+    return ss8_len(&sb->iNtErNaL_buf) - sb->iNtErNaL_head;
+}
+
+// Append the 'srclen' bytes at 'src' to *sb and return 'sb'.
+SSSTR_INLINE_DEF ss8_streambuf *ss8_streambuf_append_bytes(ss8_streambuf *sb,
+                                                           char const *src,
+                                                           size_t srclen) {
+    SSSTR_EXTRA_ASSERT(sb != NULL);
+    size_t const head = sb->iNtErNaL_head;
+    size_t const len = ss8_streambuf_len(sb);
+    if (head >= ss8iNtErNaL_streambuf_minwaste && head >= len) {
+        char *p = ss8_mutable_cstr(&sb->iNtErNaL_buf);
+        memmove(p, p + head, len);
+        ss8_set_len(&sb->iNtErNaL_buf, len);
+        sb->iNtErNaL_head = 0;
+    }
+    ss8_cat_bytes(&sb->iNtErNaL_buf, src, srclen);
+    return sb;
+}
+
+// Append the null-terminated string at 'src' to *sb and return 'sb'.
+SSSTR_INLINE_DEF ss8_streambuf *ss8_streambuf_append_cstr(ss8_streambuf *sb,
+                                                          char const *src) {
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    return ss8_streambuf_append_bytes(sb, src, strlen(src));
+}
+
+// Append *src to *sb and return 'sb'.
+SSSTR_INLINE_DEF ss8_streambuf *ss8_streambuf_append(ss8_streambuf *sb,
+                                                     ss8str const *src) {
+    return ss8_streambuf_append_bytes(sb, ss8_cstr(src), ss8_len(src));
+}
+
+// Return a view of the unconsumed contents of *sb.
+SSSTR_INLINE_DEF ss8view ss8_streambuf_peek(ss8_streambuf const *sb) {
+    SSSTR_EXTRA_ASSERT(sb != NULL);
+    return ss8_view_bytes(ss8_cstr(&sb->iNtErNaL_buf) + sb->iNtErNaL_head,
+                          ss8_streambuf_len(sb));
+}
+
+// Discard at most 'len' bytes from the front of *sb and return 'sb'.
+SSSTR_INLINE_DEF ss8_streambuf *ss8_streambuf_consume(ss8_streambuf *sb,
+                                                      size_t len) {
+    size_t const avail = ss8_streambuf_len(sb);
+    if (len >= avail) // Rewind for free when everything is consumed.
+        return ss8_streambuf_clear(sb);
+    sb->iNtErNaL_head += len;
+    return sb;
+}
+
+// Initialize *ring to be empty, with room for 'capacity' (which must be
+// positive) bytes, and return 'ring'.
+SSSTR_INLINE_DEF ss8_ring *ss8_ring_init(ss8_ring *ring, size_t capacity) {
+    SSSTR_EXTRA_ASSERT(ring != NULL);
+    SSSTR_ASSERT(capacity > 0);
+    ring->iNtErNaL_buf = SSSTR_CHARP_MALLOC(capacity);
+    if (ring->iNtErNaL_buf == NULL)
+        SSSTR_OUT_OF_MEMORY(capacity);
+    ring->iNtErNaL_capacity = capacity;
+    ring->iNtErNaL_head = 0;
+    ring->iNtErNaL_len = 0;
+    return ring;
+}
+
+// Destroy *ring, deallocating any associated dynamic storage.
+SSSTR_INLINE_DEF void ss8_ring_destroy(ss8_ring *ring) {
+    SSSTR_EXTRA_ASSERT(ring != NULL);
+    SSSTR_FREE_SIZED(ring->iNtErNaL_buf, ring->iNtErNaL_capacity);
+}
+
+// Empty *ring and return 'ring'.
+SSSTR_INLINE_DEF ss8_ring *ss8_ring_clear(ss8_ring *ring) {
+    SSSTR_EXTRA_ASSERT(ring != NULL);
+    ring->iNtErNaL_head = 0;
+    ring->iNtErNaL_len = 0;
+    return ring;
+}
+
+// Return the number of bytes queued in *ring.
+SSSTR_INLINE_DEF size_t ss8_ring_len(ss8_ring const *ring) {
+    SSSTR_EXTRA_ASSERT(ring != NULL);
+    return ring->iNtErNaL_len;
+}
+
+// Return the maximum number of bytes that *ring can hold.
+SSSTR_INLINE_DEF size_t ss8_ring_capacity(ss8_ring const *ring) {
+    SSSTR_EXTRA_ASSERT(ring != NULL);
+    return ring->iNtErNaL_capacity;
+}
+
+// Return the number of bytes that can be added to *ring.
+SSSTR_INLINE_DEF size_t ss8_ring_space(ss8_ring const *ring) {
+    SSSTR_EXTRA_ASSERT(ring != NULL);
+    return ring->iNtErNaL_capacity - ring->iNtErNaL_len;
+}
+
+// Set ptrs[0..1] and lens[0..1] to the 'len' bytes of the buffer of *ring
+// starting at offset 'start', wrapping around; return the number of nonempty
+// spans.
+SSSTR_INLINE size_t ss8iNtErNaL_ring_spans(ss8_ring const *ring, size_t start,
+                                           size_t len, char **ptrs,
+                                           size_t *lens);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_ring_spans(ss8_ring const *ring,
+                                               size_t start, size_t len,
+                                               char **ptrs, size_t *lens) {
+    size_t const toend = ring->iNtErNaL_capacity - start;
+    ptrs[0] = ring->iNtErNaL_buf + start;
+    lens[0] = len < toend ? len : toend;
+    ptrs[1] = ring->iNtErNaL_buf;
+    lens[1] = len - lens[0];
+    return lens[1] > 0 ? 2 : lens[0] > 0 ? 1 : 0;
+}
+
+// Return the offset in the buffer of *ring of 'off' bytes past its head.
+SSSTR_INLINE size_t ss8iNtErNaL_ring_offset(ss8_ring const *ring, size_t off);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_ring_offset(ss8_ring const *ring,
+                                                size_t off) {
+    size_t const toend = ring->iNtErNaL_capacity - ring->iNtErNaL_head;
+    return off < toend ? ring->iNtErNaL_head + off : off - toend;
+}
+
+// Set spans[0] and spans[1] to view the queued bytes of *ring, in order, and
+// return the number of nonempty spans (0, 1, or 2).
+SSSTR_INLINE_DEF size_t ss8_ring_read_spans(ss8_ring const *ring,
+                                            ss8view spans[2]) {
+    SSSTR_EXTRA_ASSERT(spans != NULL);
+    char *ptrs[2];
+    size_t lens[2];
+    size_t const n = ss8iNtErNaL_ring_spans(ring, ring->iNtErNaL_head,
+                                            ss8_ring_len(ring), ptrs, lens);
+    spans[0] = ss8_view_bytes(ptrs[0], lens[0]);
+    spans[1] = ss8_view_bytes(ptrs[1], lens[1]);
+    return n;
+}
+
+// Set spans[0] and spans[1] to the free space of *ring, in order, and return
+// the number of nonempty spans (0, 1, or 2).
+SSSTR_INLINE_DEF size_t ss8_ring_write_spans(ss8_ring *ring,
+                                             ss8_ring_span spans[2]) {
+    SSSTR_EXTRA_ASSERT(spans != NULL);
+    char *ptrs[2];
+    size_t lens[2];
+    size_t const start =
+        ss8_ring_space(ring) > 0
+            ? ss8iNtErNaL_ring_offset(ring, ring->iNtErNaL_len)
+            : 0;
+    size_t const n = ss8iNtErNaL_ring_spans(ring, start, ss8_ring_space(ring),
+                                            ptrs, lens);
+    spans[0].ptr = ptrs[0];
+    spans[0].len = lens[0];
+    spans[1].ptr = ptrs[1];
+    spans[1].len = lens[1];
+    return n;
+}
+
+// Add the 'len' bytes (which must not exceed the free space) written to the
+// start of the write spans of *ring to the queue, and return 'ring'.
+SSSTR_INLINE_DEF ss8_ring *ss8_ring_commit(ss8_ring *ring, size_t len) {
+    SSSTR_ASSERT(len <= ss8_ring_space(ring));
+    ring->iNtErNaL_len += len;
+    return ring;
+}
+
+// Remove at most 'len' bytes from the front of *ring and return 'ring'.
+SSSTR_INLINE_DEF ss8_ring *ss8_ring_consume(ss8_ring *ring, size_t len) {
+    size_t const avail = ss8_ring_len(ring);
+    if (len >= avail) // Rewind, so that the free space is contiguous.
+        return ss8_ring_clear(ring);
+    ring->iNtErNaL_head = ss8iNtErNaL_ring_offset(ring, len);
+    ring->iNtErNaL_len -= len;
+    return ring;
+}
+
+// Append as many as fit of the 'srclen' bytes at 'src' to *ring, and return
+// the number appended.
+SSSTR_INLINE_DEF size_t ss8_ring_push_bytes(ss8_ring *ring, char const *src,
+                                            size_t srclen) {
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    ss8_ring_span spans[2];
+    ss8_ring_write_spans(ring, spans);
+    size_t const n = srclen < ss8_ring_space(ring) ? srclen
+                                                   : ss8_ring_space(ring);
+    size_t const n0 = n < spans[0].len ? n : spans[0].len;
+    if (n0 > 0)
+        memcpy(spans[0].ptr, src, n0);
+    if (n > n0)
+        memcpy(spans[1].ptr, src + n0, n - n0);
+    ring->iNtErNaL_len += n;
+    return n;
+}
+
+// Append as many as fit of the bytes of the null-terminated string at 'src'
+// to *ring, and return the number appended.
+SSSTR_INLINE_DEF size_t ss8_ring_push_cstr(ss8_ring *ring, char const *src) {
+    SSSTR_EXTRA_ASSERT(src != NULL);
+    return ss8_ring_push_bytes(ring, src, strlen(src));
+}
+
+// Append as many as fit of the bytes of *src to *ring, and return the number
+// appended.
+SSSTR_INLINE_DEF size_t ss8_ring_push(ss8_ring *ring, ss8str const *src) {
+    return ss8_ring_push_bytes(ring, ss8_cstr(src), ss8_len(src));
+}
+
+// Copy at most 'len' bytes from the front of *ring to 'dest', remove them
+// from *ring, and return the number copied.
+SSSTR_INLINE_DEF size_t ss8_ring_pop_bytes(ss8_ring *ring, char *dest,
+                                           size_t len) {
+    SSSTR_EXTRA_ASSERT(dest != NULL);
+    ss8view spans[2];
+    ss8_ring_read_spans(ring, spans);
+    size_t const n = len < ss8_ring_len(ring) ? len : ss8_ring_len(ring);
+    size_t const n0 = n < spans[0].len ? n : spans[0].len;
+    if (n0 > 0)
+        memcpy(dest, spans[0].ptr, n0);
+    if (n > n0)
+        memcpy(dest + n0, spans[1].ptr, n - n0);
+    ss8_ring_consume(ring, n);
+    return n;
+}
+
+// Set *dest to at most 'len' bytes from the front of *ring, remove them from
+// *ring, and return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_ring_pop(ss8_ring *ring, ss8str *dest,
+                                      size_t len) {
+    size_t const n = len < ss8_ring_len(ring) ? len : ss8_ring_len(ring);
+    ss8_clear(dest);
+    ss8_set_len(dest, n);
+    if (n > 0)
+        ss8_ring_pop_bytes(ring, ss8_mutable_cstr(dest), n);
+    return dest;
+}
+
+// Set *dest to the bytes queued in *ring, in order, and return 'dest'.
+SSSTR_INLINE_DEF ss8str *ss8_ring_flatten(ss8_ring const *ring,
+                                          ss8str *dest) {
+    ss8view spans[2];
+    ss8_ring_read_spans(ring, spans);
+    ss8_clear(dest);
+    ss8_set_len(dest, spans[0].len + spans[1].len);
+    if (spans[0].len > 0)
+        memcpy(ss8_mutable_cstr(dest), spans[0].ptr, spans[0].len);
+    if (spans[1].len > 0)
+        memcpy(ss8_mutable_cstr(dest) + spans[0].len, spans[1].ptr,
+               spans[1].len);
+    return dest;
+}
+
+#ifdef SSSTR_USE_ALLOCATORS
+
+// Arena chunks begin with a pointer to the previous chunk and the usable size
+// of the chunk, followed by the usable area. Allocations are aligned to the
+// size of a pointer.
+enum { ss8iNtErNaL_arena_hdr = sizeof(char *) + sizeof(size_t) };
+enum { ss8iNtErNaL_arena_minchunk = 4096 - ss8iNtErNaL_arena_hdr };
+
+// Round 'n' up to the arena alignment; 'n' must be at most the chunk size.
+SSSTR_INLINE size_t ss8iNtErNaL_arena_align(size_t n);
+SSSTR_INLINE_DEF size_t ss8iNtErNaL_arena_align(size_t n) {
+    size_t const a = sizeof(char *);
+    return (n + (a - 1)) / a * a;
+}
+
+// Deallocate an arena chunk and return the previous chunk.
+SSSTR_INLINE char *ss8iNtErNaL_arena_freechunk(char *chunk);
+SSSTR_INLINE_DEF char *ss8iNtErNaL_arena_freechunk(char *chunk) {
+    char *prev;
+    size_t size;
+    memcpy(&prev, chunk, sizeof(char *));
+    memcpy(&size, chunk + sizeof(char *), sizeof(size_t));
+    SSSTR_FREE_SIZED(chunk, ss8iNtErNaL_arena_hdr + size);
+    return prev;
+}
+
+// Start a new chunk of *arena with at least 'size' usable bytes. Return false
+// if allocation fails.
+SSSTR_INLINE bool ss8iNtErNaL_arena_newchunk(ss8_arena *arena, size_t size);
+SSSTR_INLINE_DEF bool ss8iNtErNaL_arena_newchunk(ss8_arena *arena,
+                                                 size_t size) {
+    size_t const hdr = ss8iNtErNaL_arena_hdr;
+    size_t chunksize = arena->iNtErNaL_size;
+    chunksize = chunksize <= (SIZE_MAX - hdr) / 2 ? chunksize * 2
+                                                  : SIZE_MAX - hdr;
+    if (chunksize < ss8iNtErNaL_arena_minchunk)
+        chunksize = ss8iNtErNaL_arena_minchunk;
+    if (chunksize < size)
+        chunksize = size;
+    if (chunksize > SIZE_MAX - hdr)
+        return false;
+    char *chunk = SSSTR_CHARP_MALLOC(hdr + chunksize);
+    if (chunk == NULL)
+        return false;
+    memcpy(chunk, &arena->iNtErNaL_chunk, sizeof(char *));
+    memcpy(chunk + sizeof(char *), &chunksize, sizeof(size_t));
+    arena->iNtErNaL_chunk = chunk;
+    arena->iNtErNaL_size = chunksize;
+    arena->iNtErNaL_used = 0;
+    arena->iNtErNaL_last = NULL;
+    return true;
+}
+
+// The ss8_allocator functions of an arena; 'ctx' is the arena.
+SSSTR_INLINE void *ss8iNtErNaL_arena_allocate(void *ctx, size_t size);
+SSSTR_INLINE_DEF void *ss8iNtErNaL_arena_allocate(void *ctx, size_t size) {
+    ss8_arena *arena = (ss8_arena *)ctx;
+    size_t used = ss8iNtErNaL_arena_align(arena->iNtErNaL_used);
+    if (arena->iNtErNaL_chunk == NULL || used > arena->iNtErNaL_size ||
+        size > arena->iNtErNaL_size - used) {
+        if (!ss8iNtErNaL_arena_newchunk(arena, size))
+            return NULL;
+        used = 0;
+    }
+    char *p = arena->iNtErNaL_chunk + ss8iNtErNaL_arena_hdr + used;
+    arena->iNtErNaL_used = used + size;
+    arena->iNtErNaL_last = p;
+    return p;
+}
+
+SSSTR_INLINE void *ss8iNtErNaL_arena_reallocate(void *ctx, void *ptr,
+                                                size_t oldsize,
+                                                size_t newsize);
+SSSTR_INLINE_DEF void *ss8iNtErNaL_arena_reallocate(void *ctx, void *ptr,
+                                                    size_t oldsize,
+                                                    size_t newsize) {
+    ss8_arena *arena = (ss8_arena *)ctx;
+    if (ptr == arena->iNtErNaL_last) {
+        // Grow or shrink in place if it fits in the current chunk.
+        char *data = arena->iNtErNaL_chunk + ss8iNtErNaL_arena_hdr;
+        size_t const offset = (size_t)((char *)ptr - data);
+        if (newsize <= arena->iNtErNaL_size - offset) {
+            arena->iNtErNaL_used = offset + newsize;
+            return ptr;
+        }
+    }
+    if (newsize <= oldsize)
+        return ptr;
+    void *p = ss8iNtErNaL_arena_allocate(ctx, newsize);
+    if (p != NULL)
+        memcpy(p, ptr, oldsize);
+    return p;
+}
+
+SSSTR_INLINE void ss8iNtErNaL_arena_deallocate(void *ctx, void *ptr,
+                                               size_t size);
+SSSTR_INLINE_DEF void ss8iNtErNaL_arena_deallocate(void *ctx, void *ptr,
+                                                   size_t size) {
+    (void)size;
+    ss8_arena *arena = (ss8_arena *)ctx;
+    if (ptr == arena->iNtErNaL_last) { // Reclaim if it is the last allocation.
+        char *data = arena->iNtErNaL_chunk + ss8iNtErNaL_arena_hdr;
+        arena->iNtErNaL_used = (size_t)((char *)ptr - data);
+        arena->iNtErNaL_last = NULL;
+    }
+}
+
+// Initialize *arena to be empty and return 'arena'.
+SSSTR_INLINE_DEF ss8_arena *ss8_arena_init(ss8_arena *arena) {
+    SSSTR_EXTRA_ASSERT(arena != NULL);
+    arena->iNtErNaL_alloc.allocate = ss8iNtErNaL_arena_allocate;
+    arena->iNtErNaL_alloc.reallocate = ss8iNtErNaL_arena_reallocate;
+    arena->iNtErNaL_alloc.deallocate = ss8iNtErNaL_arena_deallocate;
+    arena->iNtErNaL_alloc.ctx = arena;
+    arena->iNtErNaL_chunk = NULL;
+    arena->iNtErNaL_size = 0;
+    arena->iNtErNaL_used = 0;
+    arena->iNtErNaL_last = NULL;
+    return arena;
+}
+
+// Destroy *arena, deallocating all of its storage at once. Strings bound to
+// the arena become invalid and need not be destroyed.
+SSSTR_INLINE_DEF void ss8_arena_destroy(ss8_arena *arena) {
+    SSSTR_EXTRA_ASSERT(arena != NULL);
+    char *chunk = arena->iNtErNaL_chunk;
+    while (chunk != NULL)
+        chunk = ss8iNtErNaL_arena_freechunk(chunk);
+}
+
+// Release all storage of *arena for reuse, keeping only its latest (largest)
+// chunk, and return 'arena'. Strings bound to the arena become invalid.
+SSSTR_INLINE_DEF ss8_arena *ss8_arena_clear(ss8_arena *arena) {
+    SSSTR_EXTRA_ASSERT(arena != NULL);
+    char *chunk = arena->iNtErNaL_chunk;
+    if (chunk == NULL)
+        return arena;
+    char *prev;
+    memcpy(&prev, chunk, sizeof(char *));
+    while (prev != NULL)
+        prev = ss8iNtErNaL_arena_freechunk(prev);
+    memcpy(chunk, &prev, sizeof(char *));
+    arena->iNtErNaL_used = 0;
+    arena->iNtErNaL_last = NULL;
+    return arena;
+}
+
+// Return the allocator that allocates from *arena, for use with
+// ss8_init_with_allocator().
+SSSTR_INLINE_DEF ss8_allocator const *ss8_arena_allocator(ss8_arena *arena) {
+    SSSTR_EXTRA_ASSERT(arena != NULL);
+    return &arena->iNtErNaL_alloc;
+}
+
+// Initialize the uninitialized *str to the empty string, with its buffer
+// allocated from *arena, and return 'str'.
+SSSTR_INLINE_DEF ss8str *ss8_init_in_arena(ss8str *str, ss8_arena *arena) {
+    return ss8_init_with_allocator(str, ss8_arena_allocator(arena));
+}
+
+#endif // SSSTR_USE_ALLOCATORS
+
 // We need va_copy() for the [v]s[n]printf functions; va_copy requires (C99 or)
 // C++11. (Note that we do not disable the prototypes for these functions.)
 #if !defined(__cplusplus) || SSSTR_CPLUSPLUS_11
@@ -2101,6 +6791,49 @@ SSSTR_INLINE_DEF ss8str *ss8_snprintf(ss8str *SSSTR_RESTRICT dest,
     return dest;
 }
 
+// Append to *b the result of formatting 'args' according to 'fmt' and return
+// 'b'.
+SSSTR_INLINE_DEF ss8_builder *ss8_builder_cat_vsprintf(ss8_builder *b,
+                                                       char const *fmt,
+                                                       va_list args) {
+    SSSTR_EXTRA_ASSERT(fmt != NULL);
+
+    // First try formatting directly into the last chunk (chunks are much
+    // smaller than INT_MAX; see also comments in ss8_cat_vsprintf()).
+    size_t room;
+    char *p = ss8iNtErNaL_builder_space(b, strlen(fmt), &room);
+    va_list args_copy;
+    va_copy(args_copy, args);
+    errno = 0;
+    int const r = vsnprintf(p, room, fmt, args_copy);
+    va_end(args_copy);
+    if (r < 0)
+        SSSTR_PANIC_ERRNO("vsnprintf error");
+    if ((size_t)r < room) {
+        b->iNtErNaL_len += (size_t)r;
+        return b;
+    }
+
+    // Otherwise format into a temporary string, to be split across chunks.
+    ss8str tmp;
+    ss8_init(&tmp);
+    ss8_cat_vsprintf(&tmp, fmt, args);
+    ss8_builder_cat(b, &tmp);
+    ss8_destroy(&tmp);
+    return b;
+}
+
+// Append to *b the result of formatting the variadic arguments according to
+// 'fmt' and return 'b'.
+SSSTR_INLINE_DEF ss8_builder *ss8_builder_cat_sprintf(ss8_builder *b,
+                                                      char const *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    ss8_builder_cat_vsprintf(b, fmt, args);
+    va_end(args);
+    return b;
+}
+
 #endif // C or SSSTR_CPLUSPLUS_11
 
 // Avoid leaking internal macros
@@ -2112,8 +6845,16 @@ SSSTR_INLINE_DEF ss8str *ss8_snprintf(ss8str *SSSTR_RESTRICT dest,
 #undef SSSTR_PANIC
 #undef SSSTR_PANIC_ERRNO
 #undef SSSTR_CHARP_MALLOC
-#undef SSSTR_CHARP_REALLOC
+#undef SSSTR_CHARP_REALLOC_SIZED
 #undef SSSTR_CHARP_MEMCHR
+#undef SSSTR_USE_SSE2
+#undef SSSTR_USE_SSSE3
+#undef SSSTR_USE_AVX2
+#undef SSSTR_RUNTIME_DISPATCH
+#undef SSSTR_TARGET_SSSE3
+#undef SSSTR_TARGET_AVX2
+#undef SSSTR_HAVE_SSSE3
+#undef SSSTR_HAVE_AVX2
 #undef SSSTR_ASSERT_MSG
 #undef SSSTR_EXTRA_ASSERT
 #undef SSSTR_EXTRA_ASSERT_MSG
@@ -2125,6 +6866,41 @@ SSSTR_INLINE_DEF ss8str *ss8_snprintf(ss8str *SSSTR_RESTRICT dest,
 #undef SSSTR_USING_DEFAULT_MALLOC
 #endif
 
+#ifdef SSSTR_USING_DEFAULT_MALLOC_USABLE_SIZE
+#undef SSSTR_MALLOC_USABLE_SIZE
+#undef SSSTR_USING_DEFAULT_MALLOC_USABLE_SIZE
+#endif
+
+#ifdef SSSTR_USING_DEFAULT_FREE_SIZED
+#undef SSSTR_FREE_SIZED
+#undef SSSTR_USING_DEFAULT_FREE_SIZED
+#endif
+
+#ifdef SSSTR_USING_DEFAULT_REALLOC_SIZED
+#undef SSSTR_REALLOC_SIZED
+#undef SSSTR_USING_DEFAULT_REALLOC_SIZED
+#endif
+
+#ifdef SSSTR_USING_DEFAULT_THREAD_LOCAL
+#undef SSSTR_THREAD_LOCAL
+#undef SSSTR_USING_DEFAULT_THREAD_LOCAL
+#endif
+
+#ifdef SSSTR_USING_DEFAULT_GROWTH_POLICY
+#undef SSSTR_GROWTH_POLICY
+#undef SSSTR_USING_DEFAULT_GROWTH_POLICY
+#endif
+
+#ifdef SSSTR_USING_DEFAULT_GROWTH_PAGE_SIZE
+#undef SSSTR_GROWTH_PAGE_SIZE
+#undef SSSTR_USING_DEFAULT_GROWTH_PAGE_SIZE
+#endif
+
+#ifdef SSSTR_USING_DEFAULT_GROWTH_PAGE_THRESHOLD
+#undef SSSTR_GROWTH_PAGE_THRESHOLD
+#undef SSSTR_USING_DEFAULT_GROWTH_PAGE_THRESHOLD
+#endif
+
 #ifdef SSSTR_USING_DEFAULT_ASSERT
 #undef SSSTR_ASSERT
 #undef SSSTR_USING_DEFAULT_ASSERT
@@ -8,7 +8,9 @@
 
 #include "ss8str.h"
 
+#include <cstring>
 #include <string>
+#include <vector>
 
 static void EmptyStringCreation(benchmark::State &state) {
     for (auto _ : state) {
@@ -169,4 +171,1087 @@ static void CppStringSwap(benchmark::State &state) {
 }
 BENCHMARK(CppStringSwap)->RangeMultiplier(16)->Range(0, 256);
 
+// Haystack resembling log text, in which the needle's first byte (space) is
+// common; the needle appears only at the very end.
+static std::string FindHaystack(std::size_t n) {
+    static char const text[] = "GET /index.html HTTP/1.1 200 a b c d ";
+    std::string h;
+    while (h.size() < n)
+        h += text;
+    h.resize(n);
+    h.replace(n - 7, 7, " error:");
+    return h;
+}
+
+static char const FindNeedle[] = " error:";
+
+static void Find(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = FindHaystack(n);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_find_cstr(&s, 0, FindNeedle));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(Find)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+static void CppFind(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = FindHaystack(n);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(h.find(FindNeedle));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(CppFind)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+#ifdef __GLIBC__
+static void MemmemFind(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = FindHaystack(n);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(memmem(h.data(), h.size(), FindNeedle,
+                                        std::strlen(FindNeedle)));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(MemmemFind)->RangeMultiplier(16)->Range(64, 1 << 20);
+#endif
+
+// Adversarial case for first/last-byte filtering: every candidate position
+// passes the filter but fails in the middle.
+static std::string WorstCaseNeedle() {
+    std::string n(64, 'a');
+    n[32] = 'b';
+    return n;
+}
+
+static void FindWorstCase(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8str s;
+    ss8_init_copy_ch_n(&s, 'a', n);
+    auto const needle = WorstCaseNeedle();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            ss8_find_bytes(&s, 0, needle.data(), needle.size()));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(FindWorstCase)->RangeMultiplier(16)->Range(4096, 1 << 20);
+
+static void CppFindWorstCase(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::string const h(n, 'a');
+    auto const needle = WorstCaseNeedle();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(h.find(needle));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(CppFindWorstCase)->RangeMultiplier(16)->Range(4096, 1 << 20);
+
+#ifdef __GLIBC__
+static void MemmemFindWorstCase(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::string const h(n, 'a');
+    auto const needle = WorstCaseNeedle();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            memmem(h.data(), h.size(), needle.data(), needle.size()));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(MemmemFindWorstCase)->RangeMultiplier(16)->Range(4096, 1 << 20);
+#endif
+
+// Reverse search should keep up with forward search. The needle is placed at
+// the start of the haystack so that the whole haystack is scanned.
+static void RFind(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto h = FindHaystack(n);
+    h.replace(0, 7, FindNeedle);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_rfind_cstr(&s, n, FindNeedle));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(RFind)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+static void CppRFind(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto h = FindHaystack(n);
+    h.replace(0, 7, FindNeedle);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(h.rfind(FindNeedle));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(CppRFind)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+// Path-like string with a single separator at one end.
+static void FindCh(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8str s;
+    ss8_init_copy_ch_n(&s, 'x', n);
+    ss8_set_back(&s, '/');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_find_ch(&s, 0, '/'));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(FindCh)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+static void RFindCh(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8str s;
+    ss8_init_copy_ch_n(&s, 'x', n);
+    ss8_set_front(&s, '/');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_rfind_ch(&s, n, '/'));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(RFindCh)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+static void CppRFindCh(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::string s(n, 'x');
+    s.front() = '/';
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s.rfind('/'));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(CppRFindCh)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+// Tokenizer-style delimiter search: a run of word characters with a single
+// delimiter at the end (or, for the "not of" variants, a single non-blank).
+static char const Delimiters[] = " \t\r\n,;";
+
+static void FindFirstOf(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8str s;
+    ss8_init_copy_ch_n(&s, 'x', n);
+    ss8_set_back(&s, ';');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_find_first_of_cstr(&s, 0, Delimiters));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(FindFirstOf)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void CppFindFirstOf(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::string s(n, 'x');
+    s.back() = ';';
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s.find_first_of(Delimiters));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(CppFindFirstOf)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void FindFirstNotOf(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8str s;
+    ss8_init_copy_ch_n(&s, ' ', n);
+    ss8_set_back(&s, 'x');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            ss8_find_first_not_of_cstr(&s, 0, Delimiters));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(FindFirstNotOf)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void CppFindFirstNotOf(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::string s(n, ' ');
+    s.back() = 'x';
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s.find_first_not_of(Delimiters));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(CppFindFirstNotOf)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void FindLastNotOf(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8str s;
+    ss8_init_copy_ch_n(&s, ' ', n);
+    ss8_set_front(&s, 'x');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            ss8_find_last_not_of_cstr(&s, n, Delimiters));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(FindLastNotOf)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void CppFindLastNotOf(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::string s(n, ' ');
+    s.front() = 'x';
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s.find_last_not_of(Delimiters));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(CppFindLastNotOf)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+// Per-record cost of stripping short fields, building the set on every call
+// versus once.
+static void StripCstr(benchmark::State &state) {
+    ss8str s;
+    ss8_init(&s);
+    for (auto _ : state) {
+        ss8_copy_cstr(&s, " \tfield value,\r\n");
+        benchmark::DoNotOptimize(ss8_strip_cstr(&s, Delimiters));
+    }
+    ss8_destroy(&s);
+}
+BENCHMARK(StripCstr);
+
+static void StripSet(benchmark::State &state) {
+    ss8str s;
+    ss8_init(&s);
+    ss8_charset set;
+    ss8_charset_init_cstr(&set, Delimiters);
+    for (auto _ : state) {
+        ss8_copy_cstr(&s, " \tfield value,\r\n");
+        benchmark::DoNotOptimize(ss8_strip_set(&s, &set));
+    }
+    ss8_destroy(&s);
+}
+BENCHMARK(StripSet);
+
+// Repeated search for a keyword whose length is given by the second argument,
+// placed at the end of the haystack.
+static std::string SearcherNeedle(std::size_t len) {
+    std::string n = "connection reset by peer while reading response header";
+    while (n.size() < len)
+        n += n;
+    n.resize(len);
+    return n;
+}
+
+static void SearcherFind(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const needle = SearcherNeedle(std::size_t(state.range(1)));
+    auto h = FindHaystack(n);
+    h.replace(n - needle.size(), needle.size(), needle);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    ss8_searcher srch;
+    ss8_searcher_init_bytes(&srch, needle.data(), needle.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_searcher_find(&srch, &s, 0));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_searcher_destroy(&srch);
+    ss8_destroy(&s);
+}
+BENCHMARK(SearcherFind)->ArgsProduct({{4096, 1 << 20}, {8, 64, 256, 1024}});
+
+static void SearcherFindUnprepared(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const needle = SearcherNeedle(std::size_t(state.range(1)));
+    auto h = FindHaystack(n);
+    h.replace(n - needle.size(), needle.size(), needle);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            ss8_find_bytes(&s, 0, needle.data(), needle.size()));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(SearcherFindUnprepared)
+    ->ArgsProduct({{4096, 1 << 20}, {8, 64, 256, 1024}});
+
+static void SearcherRFind(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const needle = SearcherNeedle(std::size_t(state.range(1)));
+    auto h = FindHaystack(n);
+    h.replace(0, needle.size(), needle);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    ss8_searcher srch;
+    ss8_searcher_init_bytes(&srch, needle.data(), needle.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_searcher_rfind(&srch, &s, n));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_searcher_destroy(&srch);
+    ss8_destroy(&s);
+}
+BENCHMARK(SearcherRFind)->ArgsProduct({{4096, 1 << 20}, {8, 64, 256, 1024}});
+
+// A needle none of whose bytes occur in the haystack, so that the searcher's
+// skip tables apply.
+static void SearcherFindRare(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::string needle;
+    for (int c = 0x80; c < 0x100; ++c)
+        needle += char(c);
+    for (int c = 0x01; c < 0x20; ++c)
+        needle += char(c);
+    auto h = FindHaystack(n);
+    h.replace(n - needle.size(), needle.size(), needle);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    ss8_searcher srch;
+    ss8_searcher_init_bytes(&srch, needle.data(), needle.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_searcher_find(&srch, &s, 0));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_searcher_destroy(&srch);
+    ss8_destroy(&s);
+}
+BENCHMARK(SearcherFindRare)->Arg(4096)->Arg(1 << 20);
+
+static std::vector<std::string> MultisearchKeywords(std::size_t count) {
+    // Made-up words that do not occur in FindHaystack(), except the last.
+    std::vector<std::string> kws;
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+        std::string kw = "kw";
+        for (std::size_t j = i; j > 0; j /= 26)
+            kw += char('a' + j % 26);
+        kws.push_back(kw + "_" + std::to_string(i % 7));
+    }
+    kws.emplace_back(" error:");
+    return kws;
+}
+
+static void MultisearchContains(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const kws = MultisearchKeywords(std::size_t(state.range(1)));
+    auto const h = FindHaystack(n);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    ss8_multisearch ms;
+    ss8_multisearch_init(&ms);
+    for (auto const &kw : kws)
+        ss8_multisearch_add_bytes(&ms, kw.data(), kw.size());
+    ss8_multisearch_compile(&ms);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_multisearch_contains(&ms, &s));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_multisearch_destroy(&ms);
+    ss8_destroy(&s);
+}
+BENCHMARK(MultisearchContains)->ArgsProduct({{4096, 1 << 20}, {4, 64, 512}});
+
+static void MultisearchContainsLoop(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const kws = MultisearchKeywords(std::size_t(state.range(1)));
+    auto const h = FindHaystack(n);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    for (auto _ : state) {
+        bool found = false;
+        for (auto const &kw : kws) {
+            if (ss8_contains_bytes(&s, kw.data(), kw.size())) {
+                found = true;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(MultisearchContainsLoop)
+    ->ArgsProduct({{4096, 1 << 20}, {4, 64, 512}});
+
+static void ReplaceAll(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = FindHaystack(n);
+    ss8str orig, s;
+    ss8_init_copy_bytes(&orig, h.data(), h.size());
+    ss8_init(&s);
+    for (auto _ : state) {
+        ss8_copy(&s, &orig);
+        ss8_replace_all_cstr(&s, " 200 ", " 404 Not Found ");
+        benchmark::DoNotOptimize(ss8_cstr(&s));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+    ss8_destroy(&orig);
+}
+BENCHMARK(ReplaceAll)->Arg(4096)->Arg(1 << 16);
+
+static void ReplaceAllLoop(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = FindHaystack(n);
+    ss8str orig, s;
+    ss8_init_copy_bytes(&orig, h.data(), h.size());
+    ss8_init(&s);
+    static char const src[] = " 404 Not Found ";
+    for (auto _ : state) {
+        ss8_copy(&s, &orig);
+        std::size_t pos = 0;
+        while ((pos = ss8_find_cstr(&s, pos, " 200 ")) != SIZE_MAX) {
+            ss8_replace_cstr(&s, pos, 5, src);
+            pos += sizeof(src) - 1;
+        }
+        benchmark::DoNotOptimize(ss8_cstr(&s));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+    ss8_destroy(&orig);
+}
+BENCHMARK(ReplaceAllLoop)->Arg(4096)->Arg(1 << 16);
+
+static void CountCh(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = FindHaystack(n);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_count_ch(&s, 0, ' '));
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(CountCh)->Arg(64)->Arg(4096)->Arg(1 << 20);
+
+static void CountChLoop(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = FindHaystack(n);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    for (auto _ : state) {
+        std::size_t count = 0;
+        for (std::size_t pos = 0;
+             (pos = ss8_find_ch(&s, pos, ' ')) != SIZE_MAX; ++pos)
+            ++count;
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(CountChLoop)->Arg(64)->Arg(4096)->Arg(1 << 20);
+
+static void FindAll(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = FindHaystack(n);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    std::vector<std::size_t> positions(256);
+    for (auto _ : state) {
+        std::size_t start = 0;
+        for (;;) {
+            auto const found = ss8_find_all_cstr(
+                &s, start, "HTTP", positions.data(), positions.size());
+            benchmark::DoNotOptimize(positions.data());
+            if (found < positions.size())
+                break;
+            start = positions.back() + 4;
+        }
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(FindAll)->Arg(4096)->Arg(1 << 20);
+
+static std::string SplitHaystack(std::size_t n) {
+    static char const text[] =
+        "1024,alpha,3.25,GET /index.html HTTP/1.1,200\n";
+    std::string h;
+    while (h.size() < n)
+        h += text;
+    h.resize(n);
+    return h;
+}
+
+static void SplitCh(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = SplitHaystack(n);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    for (auto _ : state) {
+        ss8_split sp;
+        ss8_split_init_ch(&sp, &s, ',');
+        ss8view field;
+        std::size_t total = 0;
+        while (ss8_split_next(&sp, &field))
+            total += field.len;
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(SplitCh)->Arg(4096)->Arg(1 << 20)->Arg(100 << 20);
+
+static void SplitChMemchrLoop(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = SplitHaystack(n);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    for (auto _ : state) {
+        char const *p = ss8_cstr(&s);
+        char const *const end = p + ss8_len(&s);
+        std::size_t total = 0;
+        for (;;) {
+            auto const d = static_cast<char const *>(
+                std::memchr(p, ',', std::size_t(end - p)));
+            if (d == nullptr) {
+                total += std::size_t(end - p);
+                break;
+            }
+            total += std::size_t(d - p);
+            p = d + 1;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(SplitChMemchrLoop)->Arg(4096)->Arg(1 << 20)->Arg(100 << 20);
+
+static void SplitChCopySubstr(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = SplitHaystack(n);
+    ss8str s, field;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    ss8_init(&field);
+    for (auto _ : state) {
+        std::size_t total = 0;
+        std::size_t pos = 0;
+        for (;;) {
+            auto const d = ss8_find_ch(&s, pos, ',');
+            ss8_copy_substr(&field, &s, pos, d - pos);
+            total += ss8_len(&field);
+            if (d == SIZE_MAX)
+                break;
+            pos = d + 1;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&field);
+    ss8_destroy(&s);
+}
+BENCHMARK(SplitChCopySubstr)->Arg(4096)->Arg(1 << 20);
+
+static void SplitSet(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = SplitHaystack(n);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    ss8_charset set;
+    ss8_charset_init_cstr(&set, ",\n");
+    for (auto _ : state) {
+        ss8_split sp;
+        ss8_split_init_set(&sp, &s, &set);
+        ss8view field;
+        std::size_t total = 0;
+        while (ss8_split_next(&sp, &field))
+            total += field.len;
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(SplitSet)->Arg(4096)->Arg(1 << 20)->Arg(100 << 20);
+
+static void SplitIntoSet(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = SplitHaystack(n);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    ss8_charset set;
+    ss8_charset_init_cstr(&set, ",\n");
+    std::vector<std::size_t> offsets(2 * (n / 4 + 1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_split_into_set(
+            &s, 0, &set, offsets.data(), offsets.size() / 2));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(SplitIntoSet)->Arg(4096)->Arg(1 << 20)->Arg(100 << 20);
+
+static void SplitIntoFindFirstOfLoop(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    auto const h = SplitHaystack(n);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h.data(), h.size());
+    std::vector<std::size_t> offsets(2 * (n / 4 + 1));
+    for (auto _ : state) {
+        std::size_t count = 0;
+        std::size_t pos = 0;
+        for (;;) {
+            auto const d = ss8_find_first_of_bytes(&s, pos, ",\n", 2);
+            auto const e = d == SIZE_MAX ? ss8_len(&s) : d;
+            offsets[2 * count] = pos;
+            offsets[2 * count + 1] = e - pos;
+            ++count;
+            if (d == SIZE_MAX)
+                break;
+            pos = d + 1;
+        }
+        benchmark::DoNotOptimize(count);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+    ss8_destroy(&s);
+}
+BENCHMARK(SplitIntoFindFirstOfLoop)->Arg(4096)->Arg(1 << 20)->Arg(100 << 20);
+
+static std::vector<std::string> CatPieces(std::size_t count) {
+    static char const *const words[] = {"Content-Type", ": ", "text/plain",
+                                        "\r\n", "X-Request-Id", "0123456789"};
+    std::vector<std::string> pieces;
+    for (std::size_t i = 0; i < count; ++i)
+        pieces.emplace_back(words[i % 6]);
+    return pieces;
+}
+
+static void CatChained(benchmark::State &state) {
+    auto const pieces = CatPieces(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        ss8str s;
+        ss8_init(&s);
+        for (auto const &piece : pieces)
+            ss8_cat_cstr(&s, piece.c_str());
+        benchmark::DoNotOptimize(ss8_cstr(&s));
+        ss8_destroy(&s);
+    }
+}
+BENCHMARK(CatChained)->Arg(2)->Arg(8)->Arg(64);
+
+static void CatMany(benchmark::State &state) {
+    auto const pieces = CatPieces(std::size_t(state.range(0)));
+    std::vector<ss8view> views;
+    for (auto const &piece : pieces)
+        views.push_back(ss8_view_bytes(piece.data(), piece.size()));
+    for (auto _ : state) {
+        ss8str s;
+        ss8_init(&s);
+        ss8_cat_many(&s, views.data(), views.size());
+        benchmark::DoNotOptimize(ss8_cstr(&s));
+        ss8_destroy(&s);
+    }
+}
+BENCHMARK(CatMany)->Arg(2)->Arg(8)->Arg(64);
+
+static void JoinChained(benchmark::State &state) {
+    auto const pieces = CatPieces(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        ss8str s;
+        ss8_init(&s);
+        for (std::size_t i = 0; i < pieces.size(); ++i) {
+            if (i > 0)
+                ss8_cat_ch(&s, ',');
+            ss8_cat_cstr(&s, pieces[i].c_str());
+        }
+        benchmark::DoNotOptimize(ss8_cstr(&s));
+        ss8_destroy(&s);
+    }
+}
+BENCHMARK(JoinChained)->Arg(2)->Arg(8)->Arg(64);
+
+static void Join(benchmark::State &state) {
+    auto const pieces = CatPieces(std::size_t(state.range(0)));
+    std::vector<ss8view> views;
+    for (auto const &piece : pieces)
+        views.push_back(ss8_view_bytes(piece.data(), piece.size()));
+    for (auto _ : state) {
+        ss8str s;
+        ss8_init(&s);
+        ss8_join_ch(&s, views.data(), views.size(), ',');
+        benchmark::DoNotOptimize(ss8_cstr(&s));
+        ss8_destroy(&s);
+    }
+}
+BENCHMARK(Join)->Arg(2)->Arg(8)->Arg(64);
+
+static char const BuildPiece[] =
+    "<tr><td>0123456789</td><td>text/plain</td><td>OK</td></tr>\n";
+
+static void BuildCat(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    for (auto _ : state) {
+        ss8str s;
+        ss8_init(&s);
+        while (ss8_len(&s) < n)
+            ss8_cat_cstr(&s, BuildPiece);
+        benchmark::DoNotOptimize(ss8_cstr(&s));
+        ss8_destroy(&s);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(BuildCat)->Arg(1 << 16)->Arg(1 << 22);
+
+static void BuildBuilder(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    for (auto _ : state) {
+        ss8_builder b;
+        ss8_builder_init(&b);
+        while (ss8_builder_len(&b) < n)
+            ss8_builder_cat_cstr(&b, BuildPiece);
+        benchmark::DoNotOptimize(ss8_builder_chunk(&b, 0).ptr);
+        ss8_builder_destroy(&b);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(BuildBuilder)->Arg(1 << 16)->Arg(1 << 22);
+
+static void BuildBuilderFlatten(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    for (auto _ : state) {
+        ss8_builder b;
+        ss8_builder_init(&b);
+        while (ss8_builder_len(&b) < n)
+            ss8_builder_cat_cstr(&b, BuildPiece);
+        ss8str s;
+        ss8_init(&s);
+        ss8_builder_flatten(&b, &s);
+        benchmark::DoNotOptimize(ss8_cstr(&s));
+        ss8_destroy(&s);
+        ss8_builder_destroy(&b);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(BuildBuilderFlatten)->Arg(1 << 16)->Arg(1 << 22);
+
+static void BuildBuilderSprintf(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    for (auto _ : state) {
+        ss8_builder b;
+        ss8_builder_init(&b);
+        for (int i = 0; ss8_builder_len(&b) < n; ++i)
+            ss8_builder_cat_sprintf(&b, "<tr><td>%d</td></tr>\n", i);
+        benchmark::DoNotOptimize(ss8_builder_chunk(&b, 0).ptr);
+        ss8_builder_destroy(&b);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(BuildBuilderSprintf)->Arg(1 << 16)->Arg(1 << 22);
+
+static void BuildCatSprintf(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    for (auto _ : state) {
+        ss8str s;
+        ss8_init(&s);
+        for (int i = 0; ss8_len(&s) < n; ++i)
+            ss8_cat_sprintf(&s, "<tr><td>%d</td></tr>\n", i);
+        benchmark::DoNotOptimize(ss8_cstr(&s));
+        ss8_destroy(&s);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(BuildCatSprintf)->Arg(1 << 16)->Arg(1 << 22);
+
+// Typing and deleting near random positions of a large document.
+static void EditInsertErase(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8str doc;
+    ss8_init_copy_ch_n(&doc, 'x', n);
+    std::uint32_t rng = 1;
+    for (auto _ : state) {
+        rng = rng * 1103515245u + 12345u;
+        auto const pos = std::size_t(rng >> 4) % n;
+        ss8_insert_bytes(&doc, pos, "edit", 4);
+        ss8_erase(&doc, pos, 4);
+    }
+    benchmark::DoNotOptimize(ss8_cstr(&doc));
+    ss8_destroy(&doc);
+    state.SetItemsProcessed(std::int64_t(state.iterations()));
+}
+BENCHMARK(EditInsertErase)->Arg(4096)->Arg(1 << 20)->Arg(100 << 20);
+
+static void EditRope(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8str init;
+    ss8_init_copy_ch_n(&init, 'x', n);
+    ss8_rope doc;
+    ss8_rope_init(&doc);
+    ss8_rope_copy(&doc, &init);
+    ss8_destroy(&init);
+    std::uint32_t rng = 1;
+    for (auto _ : state) {
+        rng = rng * 1103515245u + 12345u;
+        auto const pos = std::size_t(rng >> 4) % n;
+        ss8_rope_insert_bytes(&doc, pos, "edit", 4);
+        ss8_rope_erase(&doc, pos, 4);
+    }
+    benchmark::DoNotOptimize(ss8_rope_len(&doc));
+    ss8_rope_destroy(&doc);
+    state.SetItemsProcessed(std::int64_t(state.iterations()));
+}
+BENCHMARK(EditRope)->Arg(4096)->Arg(1 << 20)->Arg(100 << 20);
+
+static void RopeIterate(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8_rope doc;
+    ss8_rope_init(&doc);
+    std::uint32_t rng = 1;
+    ss8_rope_insert_bytes(&doc, 0, "0123456789abcdef", 16);
+    while (ss8_rope_len(&doc) < n) { // Fragment it as by editing.
+        rng = rng * 1103515245u + 12345u;
+        ss8_rope_insert_bytes(&doc, std::size_t(rng >> 4) % ss8_rope_len(&doc),
+                              "0123456789abcdef", 16);
+    }
+    for (auto _ : state) {
+        ss8_rope_cursor cur;
+        ss8_rope_cursor_init(&cur, &doc, 0);
+        ss8view chunk;
+        std::size_t sum = 0;
+        while (ss8_rope_cursor_next_chunk(&cur, &chunk))
+            sum += chunk.len;
+        benchmark::DoNotOptimize(sum);
+    }
+    ss8_rope_destroy(&doc);
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(RopeIterate)->Arg(1 << 20);
+
+// Typing a line of characters at a position in a large document, as in an
+// interactive editor.
+static void TypeInsertCh(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8str doc;
+    ss8_init_copy_ch_n(&doc, 'x', n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < 64; ++i)
+            ss8_insert_ch(&doc, n / 2 + i, 'a');
+        ss8_erase(&doc, n / 2, 64);
+    }
+    benchmark::DoNotOptimize(ss8_cstr(&doc));
+    ss8_destroy(&doc);
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * 64);
+}
+BENCHMARK(TypeInsertCh)->Arg(4096)->Arg(1 << 20);
+
+static void TypeGapbuf(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8_gapbuf doc;
+    ss8_gapbuf_init(&doc);
+    ss8str init;
+    ss8_init_copy_ch_n(&init, 'x', n);
+    ss8_gapbuf_copy(&doc, &init);
+    ss8_destroy(&init);
+    ss8_gapbuf_set_cursor(&doc, n / 2);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < 64; ++i)
+            ss8_gapbuf_insert_ch(&doc, 'a');
+        ss8_gapbuf_erase_before(&doc, 64);
+    }
+    benchmark::DoNotOptimize(ss8_gapbuf_len(&doc));
+    ss8_gapbuf_destroy(&doc);
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * 64);
+}
+BENCHMARK(TypeGapbuf)->Arg(4096)->Arg(1 << 20);
+
+// Consuming 64-byte messages from the front of a backlog of the given size,
+// with new data arriving as messages are consumed.
+static void ConsumeErase(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8str buf;
+    ss8_init_copy_ch_n(&buf, 'm', n);
+    char msg[64];
+    std::memset(msg, 'm', sizeof(msg));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_cstr(&buf)[63]);
+        ss8_erase(&buf, 0, sizeof(msg));
+        ss8_cat_bytes(&buf, msg, sizeof(msg));
+    }
+    ss8_destroy(&buf);
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * 64);
+}
+BENCHMARK(ConsumeErase)->Arg(4096)->Arg(1 << 20);
+
+static void ConsumeStreambuf(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    ss8_streambuf buf;
+    ss8_streambuf_init(&buf);
+    char msg[64];
+    std::memset(msg, 'm', sizeof(msg));
+    for (std::size_t i = 0; i < n / sizeof(msg); ++i)
+        ss8_streambuf_append_bytes(&buf, msg, sizeof(msg));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ss8_streambuf_peek(&buf).ptr[63]);
+        ss8_streambuf_consume(&buf, sizeof(msg));
+        ss8_streambuf_append_bytes(&buf, msg, sizeof(msg));
+    }
+    ss8_streambuf_destroy(&buf);
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * 64);
+}
+BENCHMARK(ConsumeStreambuf)->Arg(4096)->Arg(1 << 20);
+
+// Passing packets of the given size through a queue holding a 64 KiB backlog.
+static void QueueStr(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::vector<char> packet(n, 'p');
+    ss8str q;
+    ss8_init_copy_ch_n(&q, 'q', 1 << 16);
+    for (auto _ : state) {
+        ss8_cat_bytes(&q, packet.data(), n);
+        std::memcpy(packet.data(), ss8_cstr(&q), n);
+        ss8_erase(&q, 0, n);
+    }
+    ss8_destroy(&q);
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(QueueStr)->Arg(64)->Arg(1500);
+
+static void QueueRing(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::vector<char> packet(n, 'p');
+    ss8_ring q;
+    ss8_ring_init(&q, 2 << 16);
+    std::vector<char> fill(1 << 16, 'q');
+    ss8_ring_push_bytes(&q, fill.data(), fill.size());
+    for (auto _ : state) {
+        ss8_ring_push_bytes(&q, packet.data(), n);
+        ss8_ring_pop_bytes(&q, packet.data(), n);
+    }
+    ss8_ring_destroy(&q);
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(QueueRing)->Arg(64)->Arg(1500);
+
+// Short-lived strings in the 32-512 byte range, created and destroyed on each
+// thread. Compare with BufferCacheChurn in bench_ss8str_bufcache.cpp, which is
+// built with SSSTR_USE_BUFFER_CACHE.
+static void StringChurn(benchmark::State &state) {
+    static std::size_t const sizes[] = {40, 100, 200, 480, 64, 300, 150, 90};
+    for (auto _ : state) {
+        ss8str s[8];
+        for (std::size_t i = 0; i < 8; ++i) {
+            ss8_init_copy_ch_n(&s[i], '*', sizes[i]);
+            benchmark::DoNotOptimize(ss8_mutable_cstr(&s[i]));
+        }
+        benchmark::ClobberMemory();
+        for (std::size_t i = 0; i < 8; ++i)
+            ss8_destroy(&s[i]);
+    }
+}
+BENCHMARK(StringChurn)->ThreadRange(1, 8)->UseRealTime();
+
+// Build a string by appending short pieces; compare AppendPiecesUsableSize.
+static void AppendPieces(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    for (auto _ : state) {
+        ss8str s;
+        ss8_init(&s);
+        while (ss8_len(&s) < n)
+            ss8_cat_bytes(&s, "abcdefg ", 8);
+        benchmark::DoNotOptimize(ss8_mutable_cstr(&s));
+        ss8_destroy(&s);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(AppendPieces)->Arg(64)->Arg(256)->Arg(4096)->Arg(65536);
+
+// Append short pieces under each growth policy (first argument), also
+// reporting the number of reallocations (capacity changes) per string.
+static void AppendPiecesGrowth(benchmark::State &state) {
+    auto const policy = ss8_growth_policy(state.range(0));
+    auto const n = std::size_t(state.range(1));
+    std::int64_t reallocs = 0;
+    for (auto _ : state) {
+        ss8str s;
+        ss8_init(&s);
+        ss8_set_growth_policy(&s, policy);
+        std::size_t cap = ss8_capacity(&s);
+        while (ss8_len(&s) < n) {
+            ss8_cat_bytes(&s, "abcdefg ", 8);
+            if (ss8_capacity(&s) != cap) {
+                cap = ss8_capacity(&s);
+                ++reallocs;
+            }
+        }
+        benchmark::DoNotOptimize(ss8_mutable_cstr(&s));
+        ss8_destroy(&s);
+    }
+    state.counters["reallocs"] = benchmark::Counter(
+        double(reallocs), benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(AppendPiecesGrowth)
+    ->ArgsProduct({{SS8_GROWTH_THREE_HALVES, SS8_GROWTH_DOUBLE,
+                    SS8_GROWTH_SIZE_CLASS, SS8_GROWTH_PAGED},
+                   {4096, 1 << 20, 16 << 20}});
+
+// A request handler creating many strings and dropping them all at the end.
+static void RequestStrings(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::vector<ss8str> strs(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; ++i) {
+            ss8_init_copy_ch_n(&strs[i], '*', 40 + i % 200);
+            benchmark::DoNotOptimize(ss8_mutable_cstr(&strs[i]));
+        }
+        benchmark::ClobberMemory();
+        for (std::size_t i = 0; i < n; ++i)
+            ss8_destroy(&strs[i]);
+    }
+}
+BENCHMARK(RequestStrings)->Arg(100)->Arg(1000);
+
+
 BENCHMARK_MAIN();
@@ -0,0 +1,53 @@
+/*
+ * This file is part of the Ssstr string library.
+ * Copyright 2022-2023 Board of Regents of the University of Wisconsin System
+ * SPDX-License-Identifier: MIT
+ */
+
+// Benchmarks built with per-string allocators enabled. This is a separate
+// translation unit so that the same benchmark binary can compare against the
+// default configuration (bench_ss8str.cpp), in which the allocator checks are
+// compiled out.
+
+#include <benchmark/benchmark.h>
+
+#define SSSTR_USE_ALLOCATORS
+#include "ss8str.h"
+
+#include <cstddef>
+#include <vector>
+
+// Same as RequestStrings in bench_ss8str.cpp, but with heap strings in this
+// configuration.
+static void RequestStringsAllocatorsEnabled(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::vector<ss8str> strs(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; ++i) {
+            ss8_init_copy_ch_n(&strs[i], '*', 40 + i % 200);
+            benchmark::DoNotOptimize(ss8_mutable_cstr(&strs[i]));
+        }
+        benchmark::ClobberMemory();
+        for (std::size_t i = 0; i < n; ++i)
+            ss8_destroy(&strs[i]);
+    }
+}
+BENCHMARK(RequestStringsAllocatorsEnabled)->Arg(100)->Arg(1000);
+
+static void RequestStringsArena(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    std::vector<ss8str> strs(n);
+    ss8_arena arena;
+    ss8_arena_init(&arena);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; ++i) {
+            ss8_init_in_arena(&strs[i], &arena);
+            ss8_copy_ch_n(&strs[i], '*', 40 + i % 200);
+            benchmark::DoNotOptimize(ss8_mutable_cstr(&strs[i]));
+        }
+        benchmark::ClobberMemory();
+        ss8_arena_clear(&arena);
+    }
+    ss8_arena_destroy(&arena);
+}
+BENCHMARK(RequestStringsArena)->Arg(100)->Arg(1000);
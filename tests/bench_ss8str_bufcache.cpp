@@ -0,0 +1,32 @@
+/*
+ * This file is part of the Ssstr string library.
+ * Copyright 2022-2023 Board of Regents of the University of Wisconsin System
+ * SPDX-License-Identifier: MIT
+ */
+
+// Benchmarks built with the thread-local buffer cache enabled. This is a
+// separate translation unit so that the same benchmark binary can compare
+// against the default configuration (bench_ss8str.cpp).
+
+#include <benchmark/benchmark.h>
+
+#define SSSTR_USE_BUFFER_CACHE
+#include "ss8str.h"
+
+#include <cstddef>
+
+static void BufferCacheChurn(benchmark::State &state) {
+    static std::size_t const sizes[] = {40, 100, 200, 480, 64, 300, 150, 90};
+    for (auto _ : state) {
+        ss8str s[8];
+        for (std::size_t i = 0; i < 8; ++i) {
+            ss8_init_copy_ch_n(&s[i], '*', sizes[i]);
+            benchmark::DoNotOptimize(ss8_mutable_cstr(&s[i]));
+        }
+        benchmark::ClobberMemory();
+        for (std::size_t i = 0; i < 8; ++i)
+            ss8_destroy(&s[i]);
+    }
+    ss8_flush_buffer_cache();
+}
+BENCHMARK(BufferCacheChurn)->ThreadRange(1, 8)->UseRealTime();
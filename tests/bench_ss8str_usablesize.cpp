@@ -0,0 +1,33 @@
+/*
+ * This file is part of the Ssstr string library.
+ * Copyright 2022-2023 Board of Regents of the University of Wisconsin System
+ * SPDX-License-Identifier: MIT
+ */
+
+// Benchmarks built with SSSTR_USE_MALLOC_USABLE_SIZE, so that capacity
+// includes allocator slack. This is a separate translation unit so that the
+// same benchmark binary can compare against the default configuration
+// (bench_ss8str.cpp).
+
+#include <benchmark/benchmark.h>
+
+#define SSSTR_USE_MALLOC_USABLE_SIZE
+#include "ss8str.h"
+
+#include <cstddef>
+#include <cstdint>
+
+static void AppendPiecesUsableSize(benchmark::State &state) {
+    auto const n = std::size_t(state.range(0));
+    for (auto _ : state) {
+        ss8str s;
+        ss8_init(&s);
+        while (ss8_len(&s) < n)
+            ss8_cat_bytes(&s, "abcdefg ", 8);
+        benchmark::DoNotOptimize(ss8_mutable_cstr(&s));
+        ss8_destroy(&s);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) *
+                            std::int64_t(n));
+}
+BENCHMARK(AppendPiecesUsableSize)->Arg(64)->Arg(256)->Arg(4096)->Arg(65536);
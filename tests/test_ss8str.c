@@ -13,6 +13,20 @@ int size_overflow_count;
         ++size_overflow_count;                                                \
     } while (0)
 
+// Mock for testing: limit the SIMD kernels chosen (0: baseline, 1: up to
+// SSSE3, 2: up to AVX2). Without __builtin_cpu_supports(), there is no
+// run-time dispatch: only targeted kernels are built, and the CPU is known to
+// support them.
+int simd_tier = 2;
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SSSTR_CPU_HAS_SSSE3()                                                 \
+    (simd_tier >= 1 && __builtin_cpu_supports("ssse3"))
+#define SSSTR_CPU_HAS_AVX2() (simd_tier >= 2 && __builtin_cpu_supports("avx2"))
+#else
+#define SSSTR_CPU_HAS_SSSE3() (simd_tier >= 1)
+#define SSSTR_CPU_HAS_AVX2() (simd_tier >= 2)
+#endif
+
 #include "ss8str.h"
 
 #include <unity.h>
@@ -33,6 +47,16 @@ int size_overflow_count;
 // '+' (43) as a test string filler, and
 // '_' (95) to clear a test copy destination.
 
+// With SSSTR_MALLOC_USABLE_SIZE or SSSTR_USE_BUFFER_CACHE, a newly allocated
+// buffer may be larger than requested; use this for sizes that depend on it.
+#if defined(SSSTR_MALLOC_USABLE_SIZE) || defined(SSSTR_USE_BUFFER_CACHE)
+#define TEST_ASSERT_ALLOCATED_size_t(expected, actual)                        \
+    TEST_ASSERT_GREATER_OR_EQUAL_size_t((expected), (actual))
+#else
+#define TEST_ASSERT_ALLOCATED_size_t(expected, actual)                        \
+    TEST_ASSERT_EQUAL_size_t((expected), (actual))
+#endif
+
 void perturb_unused_bytes(ss8str *s) {
     char lastbyte = s->iNtErNaL_S[ss8iNtErNaL_shortbufsiz - 1];
     if (lastbyte != ss8iNtErNaL_longmode) {
@@ -42,9 +66,12 @@ void perturb_unused_bytes(ss8str *s) {
                    ss8iNtErNaL_shortcap - len - 1);
     } else {
         size_t len = s->iNtErNaL_L.len;
-        memset(&s->iNtErNaL_L.pad, '*', sizeof(s->iNtErNaL_L.pad) - 1);
-        memset(s->iNtErNaL_L.ptr + len + 1, '*',
-               s->iNtErNaL_L.bufsiz - len - 1);
+        // The last 4 bytes hold the mode, allocator flag, growth policy, and
+        // the null terminator of a string with no buffer.
+        memset(&s->iNtErNaL_L.pad, '*', sizeof(s->iNtErNaL_L.pad) - 4);
+        if (!ss8iNtErNaL_lacks_buf(s))
+            memset(s->iNtErNaL_L.ptr + len + 1, '*',
+                   s->iNtErNaL_L.bufsiz - len - 1);
     }
 }
 
@@ -62,7 +89,7 @@ void make_test_string(char *p, size_t siz) {
 
 // Required by Unity:
 void setUp(void) {}
-void tearDown(void) {}
+void tearDown(void) { ss8_flush_buffer_cache(); }
 
 void test_size(void) {
     // Failure may not be a bug, but we want to know if/when size changes
@@ -327,7 +354,7 @@ void test_reserve_short_to_long(void) {
 
     perturb_unused_bytes(&s);
     ss8_reserve(&s, shortbufsiz);
-    TEST_ASSERT_EQUAL_size_t(shortbufsiz + 1, ss8iNtErNaL_bufsize(&s));
+    TEST_ASSERT_ALLOCATED_size_t(shortbufsiz + 1, ss8iNtErNaL_bufsize(&s));
     TEST_ASSERT_EQUAL_size_t(0, ss8_len(&s));
     TEST_ASSERT_NOT_NULL(s.iNtErNaL_L.ptr);
     ss8_destroy(&s);
@@ -335,7 +362,7 @@ void test_reserve_short_to_long(void) {
 
     perturb_unused_bytes(&s);
     ss8_reserve(&s, shortbufsiz + 1);
-    TEST_ASSERT_EQUAL_size_t(shortbufsiz + 2, ss8iNtErNaL_bufsize(&s));
+    TEST_ASSERT_ALLOCATED_size_t(shortbufsiz + 2, ss8iNtErNaL_bufsize(&s));
     TEST_ASSERT_EQUAL_size_t(0, ss8_len(&s));
     TEST_ASSERT_NOT_NULL(s.iNtErNaL_L.ptr);
     ss8_destroy(&s);
@@ -360,7 +387,7 @@ void test_reserve_long_to_long(void) {
     ss8_reserve(&s, shortbufsiz);
     perturb_unused_bytes(&s);
     ss8_reserve(&s, shortbufsiz + 1);
-    TEST_ASSERT_EQUAL_size_t(shortbufsiz + 2, ss8iNtErNaL_bufsize(&s));
+    TEST_ASSERT_ALLOCATED_size_t(shortbufsiz + 2, ss8iNtErNaL_bufsize(&s));
     TEST_ASSERT_EQUAL_size_t(0, ss8_len(&s));
     TEST_ASSERT_NOT_NULL(s.iNtErNaL_L.ptr);
 
@@ -425,6 +452,50 @@ void test_three_halves(void) {
                              ss8iNtErNaL_three_halves(SIZE_MAX, SIZE_MAX));
 }
 
+void test_growcap_policy(void) {
+    size_t const maxcap = SIZE_MAX - 1;
+    TEST_ASSERT_EQUAL_size_t(
+        150, ss8iNtErNaL_growcap_policy(SS8_GROWTH_DEFAULT, 100, 101));
+    TEST_ASSERT_EQUAL_size_t(
+        150, ss8iNtErNaL_growcap_policy(SS8_GROWTH_THREE_HALVES, 100, 101));
+    TEST_ASSERT_EQUAL_size_t(
+        300, ss8iNtErNaL_growcap_policy(SS8_GROWTH_THREE_HALVES, 100, 300));
+
+    TEST_ASSERT_EQUAL_size_t(
+        200, ss8iNtErNaL_growcap_policy(SS8_GROWTH_DOUBLE, 100, 101));
+    TEST_ASSERT_EQUAL_size_t(
+        300, ss8iNtErNaL_growcap_policy(SS8_GROWTH_DOUBLE, 100, 300));
+    TEST_ASSERT_EQUAL_size_t(maxcap,
+                             ss8iNtErNaL_growcap_policy(
+                                 SS8_GROWTH_DOUBLE, SIZE_MAX / 2 + 1, maxcap));
+
+    // Buffer size (capacity + 1) is rounded.
+    TEST_ASSERT_EQUAL_size_t(
+        47, ss8iNtErNaL_growcap_policy(SS8_GROWTH_SIZE_CLASS, 31, 32));
+    TEST_ASSERT_EQUAL_size_t(
+        159, ss8iNtErNaL_growcap_policy(SS8_GROWTH_SIZE_CLASS, 100, 101));
+    TEST_ASSERT_EQUAL_size_t(
+        1535, ss8iNtErNaL_growcap_policy(SS8_GROWTH_SIZE_CLASS, 1000, 1001));
+    TEST_ASSERT_EQUAL_size_t(
+        2047, ss8iNtErNaL_growcap_policy(SS8_GROWTH_SIZE_CLASS, 1000, 2047));
+    TEST_ASSERT_EQUAL_size_t(maxcap, ss8iNtErNaL_growcap_policy(
+                                         SS8_GROWTH_SIZE_CLASS, maxcap - 1,
+                                         maxcap));
+
+    size_t const big = 1024 * 1024;
+    TEST_ASSERT_EQUAL_size_t(
+        150, ss8iNtErNaL_growcap_policy(SS8_GROWTH_PAGED, 100, 101));
+    TEST_ASSERT_EQUAL_size_t(big + big / 8 + 4095,
+                             ss8iNtErNaL_growcap_policy(SS8_GROWTH_PAGED, big,
+                                                        big + 1));
+    TEST_ASSERT_EQUAL_size_t(2 * big + 4095,
+                             ss8iNtErNaL_growcap_policy(SS8_GROWTH_PAGED, big,
+                                                        2 * big));
+    TEST_ASSERT_EQUAL_size_t(maxcap,
+                             ss8iNtErNaL_growcap_policy(SS8_GROWTH_PAGED,
+                                                        maxcap - 1, maxcap));
+}
+
 void test_grow_len(void) {
     ss8str s;
     ss8_init(&s);
@@ -449,6 +520,130 @@ void test_grow_len(void) {
     ss8_destroy(&s);
 }
 
+void test_growth_policy(void) {
+    size_t const maxshortlen = ss8iNtErNaL_shortbufsiz - 1;
+    ss8str s;
+    ss8_init(&s);
+    TEST_ASSERT_EQUAL_INT(SS8_GROWTH_DEFAULT, ss8_get_growth_policy(&s));
+
+    // An empty string records the policy without allocating a buffer.
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_set_growth_policy(&s, SS8_GROWTH_DOUBLE));
+    TEST_ASSERT_EQUAL_INT(SS8_GROWTH_DOUBLE, ss8_get_growth_policy(&s));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_capacity(&s));
+    TEST_ASSERT_EQUAL_STRING("", ss8_cstr(&s));
+    perturb_unused_bytes(&s);
+    ss8_shrink_to_fit(&s);
+    ss8_clear(&s);
+    TEST_ASSERT_EQUAL_size_t(0, ss8_capacity(&s));
+
+    // A string with a policy stays in long mode.
+    ss8_copy_cstr(&s, "abc");
+    TEST_ASSERT_EQUAL_INT(SS8_GROWTH_DOUBLE, ss8_get_growth_policy(&s));
+    TEST_ASSERT_EQUAL_STRING("abc", ss8_cstr(&s));
+    ss8_shrink_to_fit(&s);
+    TEST_ASSERT_EQUAL_INT(SS8_GROWTH_DOUBLE, ss8_get_growth_policy(&s));
+    TEST_ASSERT_EQUAL_size_t(maxshortlen + 1, ss8_capacity(&s));
+    TEST_ASSERT_EQUAL_STRING("abc", ss8_cstr(&s));
+
+    // Appending beyond the capacity follows the policy.
+    size_t const cap = ss8_capacity(&s);
+    ss8_copy_ch_n(&s, '+', cap);
+    ss8_cat_ch(&s, '+');
+    TEST_ASSERT_ALLOCATED_size_t(2 * cap, ss8_capacity(&s));
+
+    // So does ss8_grow_len().
+    ss8_set_len(&s, 100);
+    ss8_shrink_to_fit(&s);
+    TEST_ASSERT_EQUAL_size_t(100, ss8_grow_len(&s, SIZE_MAX, SIZE_MAX));
+    TEST_ASSERT_EQUAL_size_t(200, ss8_len(&s));
+
+    // The policy moves with the string.
+    ss8str t;
+    ss8_init_move(&t, &s);
+    TEST_ASSERT_EQUAL_INT(SS8_GROWTH_DOUBLE, ss8_get_growth_policy(&t));
+    TEST_ASSERT_EQUAL_INT(SS8_GROWTH_DEFAULT, ss8_get_growth_policy(&s));
+    ss8_destroy(&t);
+
+    // Without a policy, the string can return to short mode.
+    ss8_copy_ch_n(&s, '+', 100);
+    ss8_set_growth_policy(&s, SS8_GROWTH_PAGED);
+    ss8_set_growth_policy(&s, SS8_GROWTH_DEFAULT);
+    TEST_ASSERT_EQUAL_INT(SS8_GROWTH_DEFAULT, ss8_get_growth_policy(&s));
+    ss8_clear(&s);
+    ss8_shrink_to_fit(&s);
+    TEST_ASSERT_EQUAL_size_t(maxshortlen, ss8_capacity(&s));
+
+    // A non-empty short string moves to the smallest long-mode buffer to
+    // record a policy.
+    ss8_copy_cstr(&s, "abc");
+    ss8_set_growth_policy(&s, SS8_GROWTH_DOUBLE);
+    TEST_ASSERT_EQUAL_INT(SS8_GROWTH_DOUBLE, ss8_get_growth_policy(&s));
+    TEST_ASSERT_ALLOCATED_size_t(maxshortlen + 1, ss8_capacity(&s));
+    TEST_ASSERT_EQUAL_STRING("abc", ss8_cstr(&s));
+    ss8_copy_ch_n(&s, '+', maxshortlen);
+    ss8_set_growth_policy(&s, SS8_GROWTH_PAGED);
+    TEST_ASSERT_EQUAL_INT(SS8_GROWTH_PAGED, ss8_get_growth_policy(&s));
+    TEST_ASSERT_EQUAL_size_t(maxshortlen, ss8_len(&s));
+    ss8_set_growth_policy(&s, SS8_GROWTH_DEFAULT);
+    ss8_shrink_to_fit(&s);
+    TEST_ASSERT_EQUAL_size_t(maxshortlen, ss8_capacity(&s));
+    TEST_ASSERT_EQUAL_size_t(maxshortlen, ss8_len(&s));
+
+    // An empty string with a policy releases its buffer when shrunk, and
+    // returns to short mode when the policy is cleared.
+    ss8_clear(&s);
+    ss8_set_growth_policy(&s, SS8_GROWTH_SIZE_CLASS);
+    ss8_copy_ch_n(&s, '+', 100);
+    ss8_clear(&s);
+    ss8_shrink_to_fit(&s);
+    TEST_ASSERT_EQUAL_INT(SS8_GROWTH_SIZE_CLASS, ss8_get_growth_policy(&s));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_capacity(&s));
+    ss8_set_growth_policy(&s, SS8_GROWTH_DEFAULT);
+    TEST_ASSERT_EQUAL_size_t(maxshortlen, ss8_capacity(&s));
+    TEST_ASSERT_EQUAL_STRING("", ss8_cstr(&s));
+    ss8_set_growth_policy(&s, SS8_GROWTH_PAGED);
+    ss8_destroy(&s);
+}
+
+void test_no_buffer_is_per_string(void) {
+    // A string with no buffer keeps its null terminator in the ss8str itself,
+    // so that strings do not share storage (which would be a data race
+    // between threads), even after being moved.
+    ss8str s, t, u;
+    ss8_init(&s);
+    ss8_init(&t);
+    ss8_set_growth_policy(&s, SS8_GROWTH_DOUBLE);
+    ss8_set_growth_policy(&t, SS8_GROWTH_DOUBLE);
+    TEST_ASSERT_EQUAL_size_t(0, ss8_capacity(&s));
+    char const *p = ss8_cstr(&s);
+    TEST_ASSERT_TRUE(p >= s.iNtErNaL_S && p < s.iNtErNaL_S + sizeof(s));
+    TEST_ASSERT_TRUE(ss8_cstr(&t) != p);
+
+    ss8_clear(&s);
+    ss8_set_len(&s, 0);
+    ss8_copy_bytes(&s, "", 0);
+    ss8_mutable_cstr(&s)[0] = '\0';
+    TEST_ASSERT_EQUAL_size_t(0, ss8_capacity(&s));
+
+    ss8_init_move(&u, &s);
+    p = ss8_cstr(&u);
+    TEST_ASSERT_TRUE(p >= u.iNtErNaL_S && p < u.iNtErNaL_S + sizeof(u));
+    TEST_ASSERT_EQUAL_STRING("", p);
+    ss8_move(&s, &u);
+    p = ss8_cstr(&s);
+    TEST_ASSERT_TRUE(p >= s.iNtErNaL_S && p < s.iNtErNaL_S + sizeof(s));
+    ss8_swap(&s, &t);
+    p = ss8_cstr(&t);
+    TEST_ASSERT_TRUE(p >= t.iNtErNaL_S && p < t.iNtErNaL_S + sizeof(t));
+    TEST_ASSERT_EQUAL_INT(SS8_GROWTH_DOUBLE, ss8_get_growth_policy(&t));
+
+    ss8_cat_cstr(&t, "abc");
+    TEST_ASSERT_EQUAL_STRING("abc", ss8_cstr(&t));
+    ss8_destroy(&u);
+    ss8_destroy(&t);
+    ss8_destroy(&s);
+}
+
 void test_shrink_to_fit_short_to_short(void) {
     size_t const maxshortlen = ss8iNtErNaL_shortbufsiz - 1;
 
@@ -589,7 +784,7 @@ void test_clear(void) {
     perturb_unused_bytes(&s);
     TEST_ASSERT_EQUAL_PTR(&s, ss8_clear(&s));
     TEST_ASSERT_EQUAL_size_t(0, ss8_len(&s));
-    TEST_ASSERT_EQUAL_size_t(127, ss8_capacity(&s));
+    TEST_ASSERT_ALLOCATED_size_t(127, ss8_capacity(&s));
 
     ss8_destroy(&s);
 }
@@ -1811,7 +2006,108 @@ void test_find_bytes(void) {
     ss8_copy_cstr(&s, "aaaabc");
     TEST_ASSERT_EQUAL_size_t(3, ss8_find_bytes(&s, 0, "abc", 3));
 
+    // First and last bytes match but middle does not
+    ss8_copy_cstr(&s, "axc abc");
+    TEST_ASSERT_EQUAL_size_t(4, ss8_find_bytes(&s, 0, "abc", 3));
+
+    ss8_destroy(&s);
+}
+
+// Simple reference implementation for checking search kernels.
+size_t naive_find(char const *h, size_t hlen, size_t start, char const *n,
+                  size_t nlen) {
+    for (size_t i = start; i + nlen <= hlen; ++i) {
+        if (memcmp(h + i, n, nlen) == 0)
+            return i;
+    }
+    return SIZE_MAX;
+}
+
+#if defined(SSSTR_USE_SSSE3) || defined(SSSTR_USE_AVX2)
+void test_simd_tier(void) {
+    // The tier can be forced down even for targeted instruction sets.
+    int const saved = simd_tier;
+    simd_tier = 0;
+    TEST_ASSERT_FALSE(SSSTR_HAVE_SSSE3());
+    TEST_ASSERT_FALSE(SSSTR_HAVE_AVX2());
+    simd_tier = 1;
+    TEST_ASSERT_FALSE(SSSTR_HAVE_AVX2());
+    simd_tier = saved;
+}
+#endif
+
+void test_find_bytes_long(void) {
+    // Exercise block boundaries of vectorized search.
+    char buf[200];
+    make_test_string(buf, sizeof(buf));
+    size_t const buflen = sizeof(buf) - 1;
+    char const *needles[] = {"+-", "-+", "+-+", "++-++", "+++++++++++++++-",
+                             "-+++++++++++++++++++++++++++++++++-"};
+    for (size_t i = 0; i < sizeof(needles) / sizeof(needles[0]); ++i) {
+        char const *n = needles[i];
+        size_t const nlen = strlen(n);
+        for (size_t pos = 0; pos + nlen <= buflen; pos += 7) {
+            make_test_string(buf, sizeof(buf));
+            memcpy(buf + pos, n, nlen);
+            ss8str s;
+            ss8_init_copy_bytes(&s, buf, buflen);
+            for (size_t start = 0; start <= buflen; start += 13) {
+                TEST_ASSERT_EQUAL_size_t(
+                    naive_find(buf, buflen, start, n, nlen),
+                    ss8_find_bytes(&s, start, n, nlen));
+            }
+            ss8_destroy(&s);
+        }
+    }
+}
+
+void test_twoway(void) {
+    // White-box test of the worst-case-linear fallback.
+    char const *const haystacks[] = {
+        "", "a", "aaaaaaaaaa", "abababababc", "abcabcabdabcabcabc",
+        "aabaabaabaaab", "zyxzyxzyxzyw", "banana bandana"};
+    char const *const needles[] = {
+        "a",    "b",     "aa",      "ab",     "aaab", "abc",   "abab",
+        "ababc", "abcabd", "aabaaab", "zyw",  "zyxzyw", "ana", "andana",
+        "bandanas"};
+    for (size_t i = 0; i < sizeof(haystacks) / sizeof(haystacks[0]); ++i) {
+        char const *h = haystacks[i];
+        size_t const hlen = strlen(h);
+        for (size_t j = 0; j < sizeof(needles) / sizeof(needles[0]); ++j) {
+            char const *n = needles[j];
+            size_t const nlen = strlen(n);
+            char const *p = ss8iNtErNaL_twoway(h, hlen, n, nlen);
+            TEST_ASSERT_EQUAL_size_t(naive_find(h, hlen, 0, n, nlen),
+                                     p == NULL ? SIZE_MAX
+                                               : (size_t)(p - h));
+        }
+    }
+}
+
+void test_find_bytes_worst_case(void) {
+    // Adversarial inputs that make first/last-byte filtering quadratic.
+    enum { hlen = 20000, nlen = 1000 };
+    char *h = (char *)malloc(hlen);
+    char *n = (char *)malloc(nlen);
+    TEST_ASSERT_NOT_NULL(h);
+    TEST_ASSERT_NOT_NULL(n);
+    memset(h, 'a', hlen);
+    memset(n, 'a', nlen);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h, hlen);
+
+    n[nlen / 2] = 'b';
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_find_bytes(&s, 0, n, nlen));
+    h[hlen - 700] = 'b';
+    ss8_copy_bytes(&s, h, hlen);
+    TEST_ASSERT_EQUAL_size_t(hlen - 700 - nlen / 2,
+                             ss8_find_bytes(&s, 0, n, nlen));
+    TEST_ASSERT_EQUAL_size_t(hlen - 700 - nlen / 2,
+                             ss8_find_bytes(&s, 3, n, nlen));
+
     ss8_destroy(&s);
+    free(n);
+    free(h);
 }
 
 void test_find(void) {
@@ -1894,6 +2190,611 @@ void test_rfind_bytes(void) {
     ss8_destroy(&s);
 }
 
+// Reference implementation for checking reverse search kernels.
+size_t naive_rfind(char const *h, size_t hlen, size_t start, char const *n,
+                   size_t nlen) {
+    if (nlen > hlen)
+        return SIZE_MAX;
+    size_t i = hlen - nlen;
+    if (start < i)
+        i = start;
+    for (;; --i) {
+        if (memcmp(h + i, n, nlen) == 0)
+            return i;
+        if (i == 0)
+            return SIZE_MAX;
+    }
+}
+
+void test_rfind_bytes_long(void) {
+    // Exercise block boundaries of vectorized search.
+    char buf[200];
+    size_t const buflen = sizeof(buf) - 1;
+    char const *needles[] = {"-", "+-", "-+", "+-+", "++-++",
+                             "+++++++++++++++-",
+                             "-+++++++++++++++++++++++++++++++++-"};
+    for (size_t i = 0; i < sizeof(needles) / sizeof(needles[0]); ++i) {
+        char const *n = needles[i];
+        size_t const nlen = strlen(n);
+        for (size_t pos = 0; pos + nlen <= buflen; pos += 7) {
+            make_test_string(buf, sizeof(buf));
+            memcpy(buf + pos, n, nlen);
+            ss8str s;
+            ss8_init_copy_bytes(&s, buf, buflen);
+            for (size_t start = 0; start <= buflen; start += 13) {
+                TEST_ASSERT_EQUAL_size_t(
+                    naive_rfind(buf, buflen, start, n, nlen),
+                    ss8_rfind_bytes(&s, start, n, nlen));
+                if (nlen == 1) {
+                    TEST_ASSERT_EQUAL_size_t(
+                        naive_rfind(buf, buflen, start, n, nlen),
+                        ss8_rfind_ch(&s, start, n[0]));
+                }
+            }
+            ss8_destroy(&s);
+        }
+    }
+}
+
+void test_rtwoway(void) {
+    // White-box test of the worst-case-linear fallback for reverse search.
+    char const *const haystacks[] = {
+        "", "a", "aaaaaaaaaa", "cbababababa", "abcabcabdabcabcabc",
+        "baaabaabaabaa", "wyzxyzxyzxyz", "banana bandana"};
+    char const *const needles[] = {
+        "a",    "b",     "aa",      "ba",     "baaa", "cba",   "baba",
+        "cbaba", "dbacba", "baaabaa", "wyz",  "wyzxyz", "ana", "banana",
+        "sbanana"};
+    for (size_t i = 0; i < sizeof(haystacks) / sizeof(haystacks[0]); ++i) {
+        char const *h = haystacks[i];
+        size_t const hlen = strlen(h);
+        for (size_t j = 0; j < sizeof(needles) / sizeof(needles[0]); ++j) {
+            char const *n = needles[j];
+            size_t const nlen = strlen(n);
+            char const *p = ss8iNtErNaL_rtwoway(h, hlen, n, nlen);
+            TEST_ASSERT_EQUAL_size_t(naive_rfind(h, hlen, hlen, n, nlen),
+                                     p == NULL ? SIZE_MAX
+                                               : (size_t)(p - h));
+        }
+    }
+}
+
+void test_rfind_bytes_worst_case(void) {
+    // Adversarial inputs that make first/last-byte filtering quadratic.
+    enum { hlen = 20000, nlen = 1000 };
+    char *h = (char *)malloc(hlen);
+    char *n = (char *)malloc(nlen);
+    TEST_ASSERT_NOT_NULL(h);
+    TEST_ASSERT_NOT_NULL(n);
+    memset(h, 'a', hlen);
+    memset(n, 'a', nlen);
+    ss8str s;
+    ss8_init_copy_bytes(&s, h, hlen);
+
+    n[nlen / 2] = 'b';
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_rfind_bytes(&s, hlen, n, nlen));
+    h[700] = 'b';
+    ss8_copy_bytes(&s, h, hlen);
+    TEST_ASSERT_EQUAL_size_t(700 - nlen / 2,
+                             ss8_rfind_bytes(&s, hlen, n, nlen));
+    TEST_ASSERT_EQUAL_size_t(700 - nlen / 2,
+                             ss8_rfind_bytes(&s, hlen - 3, n, nlen));
+
+    ss8_destroy(&s);
+    free(n);
+    free(h);
+}
+
+void test_searcher(void) {
+    ss8_searcher srch;
+    ss8str s;
+    ss8_init_copy_cstr(&s, "abcabc");
+
+    TEST_ASSERT_EQUAL_PTR(&srch, ss8_searcher_init_cstr(&srch, "bc"));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_searcher_find(&srch, &s, 0));
+    TEST_ASSERT_EQUAL_size_t(4, ss8_searcher_find(&srch, &s, 2));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_searcher_find(&srch, &s, 5));
+    TEST_ASSERT_EQUAL_size_t(4, ss8_searcher_rfind(&srch, &s, 6));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_searcher_rfind(&srch, &s, 3));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_searcher_rfind(&srch, &s, 0));
+    TEST_ASSERT_EQUAL_size_t(2, ss8_searcher_count(&srch, &s, 0));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_searcher_count(&srch, &s, 2));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_searcher_count(&srch, &s, 6));
+    ss8_searcher_destroy(&srch);
+
+    // Empty needle
+    TEST_ASSERT_EQUAL_PTR(&srch, ss8_searcher_init_bytes(&srch, "x", 0));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_searcher_find(&srch, &s, 0));
+    TEST_ASSERT_EQUAL_size_t(6, ss8_searcher_find(&srch, &s, 6));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_searcher_rfind(&srch, &s, 3));
+    TEST_ASSERT_EQUAL_size_t(7, ss8_searcher_count(&srch, &s, 0));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_searcher_count(&srch, &s, 6));
+    ss8_searcher_destroy(&srch);
+
+    // Needle longer than haystack
+    ss8str t;
+    ss8_init_copy_cstr(&t, "abcabcabcabcabcabcabc");
+    TEST_ASSERT_EQUAL_PTR(&srch, ss8_searcher_init(&srch, &t));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_searcher_find(&srch, &s, 0));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_searcher_rfind(&srch, &s, 6));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_searcher_count(&srch, &s, 0));
+    ss8_searcher_destroy(&srch);
+
+    // Non-overlapping count
+    ss8_copy_cstr(&s, "aaaaa");
+    ss8_searcher_init_cstr(&srch, "aa");
+    TEST_ASSERT_EQUAL_size_t(2, ss8_searcher_count(&srch, &s, 0));
+    ss8_searcher_destroy(&srch);
+    ss8_copy_ch_n(&s, 'a', 100);
+    ss8_copy_ch_n(&t, 'a', 20);
+    ss8_searcher_init(&srch, &t);
+    TEST_ASSERT_EQUAL_size_t(5, ss8_searcher_count(&srch, &s, 0));
+    TEST_ASSERT_EQUAL_size_t(4, ss8_searcher_count(&srch, &s, 1));
+    ss8_searcher_destroy(&srch);
+
+    ss8_destroy(&t);
+    ss8_destroy(&s);
+}
+
+void test_searcher_long(void) {
+    // Needles placed at various positions; those without '+' allow the
+    // longest possible skips.
+    char buf[300];
+    size_t const buflen = sizeof(buf) - 1;
+    char const *needles[] = {
+        "-",
+        "+-",
+        "+++++++++++++++-",
+        "-+++++++++++++++",
+        "-++++++++++++++++-",
+        "-+++++++++++++++++++++++++++++++++-",
+        "++++-+++++++++++++-++++++++++++++",
+        "abc",
+        "abcdefghijklmnopqrstuvwxyz",
+        "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+    };
+    for (size_t i = 0; i < sizeof(needles) / sizeof(needles[0]); ++i) {
+        char const *n = needles[i];
+        size_t const nlen = strlen(n);
+        ss8_searcher srch;
+        ss8_searcher_init_bytes(&srch, n, nlen);
+        for (size_t pos = 0; pos + nlen <= buflen; pos += 11) {
+            make_test_string(buf, sizeof(buf));
+            memcpy(buf + pos, n, nlen);
+            if (pos + 2 * nlen + 40 <= buflen)
+                memcpy(buf + pos + nlen + 40, n, nlen);
+            ss8str s;
+            ss8_init_copy_bytes(&s, buf, buflen);
+            for (size_t start = 0; start <= buflen; start += 13) {
+                TEST_ASSERT_EQUAL_size_t(
+                    naive_find(buf, buflen, start, n, nlen),
+                    ss8_searcher_find(&srch, &s, start));
+                TEST_ASSERT_EQUAL_size_t(
+                    naive_rfind(buf, buflen, start, n, nlen),
+                    ss8_searcher_rfind(&srch, &s, start));
+            }
+            ss8_destroy(&s);
+        }
+        ss8_searcher_destroy(&srch);
+    }
+
+    // Needles of distinct bytes, for which the skip tables are used (with or
+    // without AVX2).
+    char rare[160];
+    for (size_t i = 0; i < sizeof(rare); ++i)
+        rare[i] = (char)(1 + i < '+' ? 1 + i : 2 + i); // Skip '+'.
+    size_t const rarelens[] = {40, sizeof(rare)};
+    for (size_t i = 0; i < sizeof(rarelens) / sizeof(rarelens[0]); ++i) {
+        size_t const rlen = rarelens[i];
+        char const *r = rare + sizeof(rare) - rlen;
+        ss8_searcher srch;
+        ss8_searcher_init_bytes(&srch, r, rlen);
+        for (size_t pos = 0; pos + rlen <= buflen; pos += 7) {
+            make_test_string(buf, sizeof(buf));
+            memcpy(buf + pos, r, rlen);
+            // Lone copies of the end bytes, which must not match.
+            size_t const after = pos + rlen;
+            if (pos > 0)
+                buf[pos / 2] = r[rlen - 1];
+            if (after < buflen)
+                buf[after + (buflen - after) / 2] = r[0];
+            ss8str s;
+            ss8_init_copy_bytes(&s, buf, buflen);
+            for (size_t start = 0; start <= buflen; start += 5) {
+                TEST_ASSERT_EQUAL_size_t(
+                    naive_find(buf, buflen, start, r, rlen),
+                    ss8_searcher_find(&srch, &s, start));
+                TEST_ASSERT_EQUAL_size_t(
+                    naive_rfind(buf, buflen, start, r, rlen),
+                    ss8_searcher_rfind(&srch, &s, start));
+            }
+            TEST_ASSERT_EQUAL_size_t(1, ss8_searcher_count(&srch, &s, 0));
+            ss8_destroy(&s);
+        }
+        ss8_searcher_destroy(&srch);
+    }
+
+    // Adversarial input, which exercises the Two-Way fallback.
+    ss8str s;
+    ss8_init_copy_ch_n(&s, 'a', 20000);
+    char n[1000];
+    memset(n, 'a', sizeof(n));
+    n[500] = 'b';
+    ss8_searcher srch;
+    ss8_searcher_init_bytes(&srch, n, sizeof(n));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_searcher_find(&srch, &s, 0));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_searcher_rfind(&srch, &s, 20000));
+    ss8_set_at(&s, 15000, 'b');
+    TEST_ASSERT_EQUAL_size_t(14500, ss8_searcher_find(&srch, &s, 0));
+    TEST_ASSERT_EQUAL_size_t(14500, ss8_searcher_rfind(&srch, &s, 20000));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_searcher_count(&srch, &s, 0));
+    ss8_searcher_destroy(&srch);
+
+    // The same, for a needle whose distinct tail makes the skip tables worth
+    // using, but whose run of 'a' forces a shift of 1 through the haystack.
+    ss8str t;
+    ss8_init_copy_ch_n(&t, 'a', 1000);
+    ss8_cat_bytes(&t, rare, sizeof(rare));
+    ss8_searcher_init(&srch, &t);
+    ss8_copy_ch_n(&s, 'a', 20000);
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_searcher_rfind(&srch, &s, 20000));
+    ss8_replace(&s, 3000, ss8_len(&t), &t);
+    TEST_ASSERT_EQUAL_size_t(3000, ss8_searcher_rfind(&srch, &s, 20000));
+    TEST_ASSERT_EQUAL_size_t(3000, ss8_searcher_find(&srch, &s, 0));
+    ss8_searcher_destroy(&srch);
+    ss8_destroy(&t);
+    ss8_destroy(&s);
+}
+
+typedef struct {
+    size_t count;
+    size_t stop_after;
+    size_t pos[64];
+    size_t pattern[64];
+} multisearch_record;
+
+bool record_match(size_t pos, size_t pattern, void *data) {
+    multisearch_record *rec = (multisearch_record *)data;
+    if (rec->count < 64) {
+        rec->pos[rec->count] = pos;
+        rec->pattern[rec->count] = pattern;
+    }
+    ++rec->count;
+    return rec->count != rec->stop_after;
+}
+
+void test_multisearch(void) {
+    ss8_multisearch ms;
+    TEST_ASSERT_EQUAL_PTR(&ms, ss8_multisearch_init(&ms));
+    ss8str s;
+    ss8_init_copy_cstr(&s, "ushers");
+
+    // No patterns
+    ss8_multisearch_compile(&ms);
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_multisearch_find(&ms, &s, 0, NULL));
+    TEST_ASSERT_FALSE(ss8_multisearch_contains(&ms, &s));
+    TEST_ASSERT_EQUAL_size_t(
+        0, ss8_multisearch_find_all(&ms, &s, 0, NULL, NULL));
+
+    ss8str t;
+    ss8_init_copy_cstr(&t, "he");
+    TEST_ASSERT_EQUAL_size_t(0, ss8_multisearch_add(&ms, &t));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_multisearch_add_cstr(&ms, "she"));
+    TEST_ASSERT_EQUAL_size_t(2, ss8_multisearch_add_bytes(&ms, "hisx", 3));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_multisearch_add_cstr(&ms, "hers"));
+    ss8_multisearch_compile(&ms);
+
+    size_t pat = 42;
+    TEST_ASSERT_EQUAL_size_t(1, ss8_multisearch_find(&ms, &s, 0, &pat));
+    TEST_ASSERT_EQUAL_size_t(1, pat);
+    TEST_ASSERT_EQUAL_size_t(2, ss8_multisearch_find(&ms, &s, 2, &pat));
+    TEST_ASSERT_EQUAL_size_t(3, pat); // "hers" is longer than "he"
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_multisearch_find(&ms, &s, 3, &pat));
+    TEST_ASSERT_EQUAL_size_t(3, pat); // Unchanged
+    TEST_ASSERT_TRUE(ss8_multisearch_contains(&ms, &s));
+
+    multisearch_record rec = {0, 0, {0}, {0}};
+    TEST_ASSERT_EQUAL_size_t(
+        3, ss8_multisearch_find_all(&ms, &s, 0, record_match, &rec));
+    TEST_ASSERT_EQUAL_size_t(3, rec.count);
+    TEST_ASSERT_EQUAL_size_t(1, rec.pos[0]);
+    TEST_ASSERT_EQUAL_size_t(1, rec.pattern[0]);
+    TEST_ASSERT_EQUAL_size_t(2, rec.pos[1]);
+    TEST_ASSERT_EQUAL_size_t(0, rec.pattern[1]);
+    TEST_ASSERT_EQUAL_size_t(2, rec.pos[2]);
+    TEST_ASSERT_EQUAL_size_t(3, rec.pattern[2]);
+    TEST_ASSERT_EQUAL_size_t(
+        3, ss8_multisearch_find_all(&ms, &s, 0, NULL, NULL));
+    TEST_ASSERT_EQUAL_size_t(
+        2, ss8_multisearch_find_all(&ms, &s, 2, NULL, NULL));
+
+    // Stopping early
+    multisearch_record rec2 = {0, 2, {0}, {0}};
+    TEST_ASSERT_EQUAL_size_t(
+        2, ss8_multisearch_find_all(&ms, &s, 0, record_match, &rec2));
+
+    // Adding a pattern requires recompiling.
+    TEST_ASSERT_EQUAL_size_t(4, ss8_multisearch_add_cstr(&ms, "us"));
+    ss8_multisearch_compile(&ms);
+    TEST_ASSERT_EQUAL_size_t(0, ss8_multisearch_find(&ms, &s, 0, &pat));
+    TEST_ASSERT_EQUAL_size_t(4, pat);
+
+    ss8_copy_cstr(&s, "xyz");
+    TEST_ASSERT_FALSE(ss8_multisearch_contains(&ms, &s));
+
+    // Empty pattern matches everywhere
+    TEST_ASSERT_EQUAL_size_t(5, ss8_multisearch_add_cstr(&ms, ""));
+    ss8_multisearch_compile(&ms);
+    TEST_ASSERT_EQUAL_size_t(1, ss8_multisearch_find(&ms, &s, 1, &pat));
+    TEST_ASSERT_EQUAL_size_t(5, pat);
+    TEST_ASSERT_EQUAL_size_t(
+        4, ss8_multisearch_find_all(&ms, &s, 0, NULL, NULL));
+    TEST_ASSERT_EQUAL_size_t(
+        1, ss8_multisearch_find_all(&ms, &s, 3, NULL, NULL));
+
+    ss8_multisearch_destroy(&ms);
+
+    // Duplicate patterns report the first index.
+    ss8_multisearch_init(&ms);
+    ss8_multisearch_add_cstr(&ms, "ab");
+    ss8_multisearch_add_cstr(&ms, "ab");
+    ss8_multisearch_compile(&ms);
+    ss8_copy_cstr(&s, "xxab");
+    TEST_ASSERT_EQUAL_size_t(2, ss8_multisearch_find(&ms, &s, 0, &pat));
+    TEST_ASSERT_EQUAL_size_t(0, pat);
+    TEST_ASSERT_EQUAL_size_t(
+        1, ss8_multisearch_find_all(&ms, &s, 0, NULL, NULL));
+    ss8_multisearch_destroy(&ms);
+
+    // Init fully initializes; destroying without compiling is fine.
+    memset(&ms, 0xa5, sizeof(ms));
+    ss8_multisearch_init(&ms);
+    TEST_ASSERT_FALSE(ms.iNtErNaL_skip);
+    for (size_t i = 0; i < sizeof(ms.iNtErNaL_class); ++i)
+        TEST_ASSERT_EQUAL_INT(0, ms.iNtErNaL_class[i]);
+    for (size_t i = 0; i < sizeof(ms.iNtErNaL_start.iNtErNaL_bits); ++i)
+        TEST_ASSERT_EQUAL_INT(0, ms.iNtErNaL_start.iNtErNaL_bits[i]);
+    ss8_multisearch_add_cstr(&ms, "ab");
+    ss8_multisearch_destroy(&ms);
+
+    // The leftmost match is found, as with ss8_find(), even if another ends
+    // earlier.
+    ss8_multisearch_init(&ms);
+    ss8_multisearch_add_cstr(&ms, "abcd");
+    ss8_multisearch_add_cstr(&ms, "bc");
+    ss8_multisearch_compile(&ms);
+    ss8_copy_cstr(&s, "xabcd");
+    TEST_ASSERT_EQUAL_size_t(1, ss8_multisearch_find(&ms, &s, 0, &pat));
+    TEST_ASSERT_EQUAL_size_t(0, pat);
+    TEST_ASSERT_EQUAL_size_t(2, ss8_multisearch_find(&ms, &s, 2, &pat));
+    TEST_ASSERT_EQUAL_size_t(1, pat);
+    ss8_copy_cstr(&s, "xabce");
+    TEST_ASSERT_EQUAL_size_t(2, ss8_multisearch_find(&ms, &s, 0, &pat));
+    TEST_ASSERT_EQUAL_size_t(1, pat);
+    ss8_multisearch_destroy(&ms);
+
+    ss8_destroy(&t);
+    ss8_destroy(&s);
+}
+
+// Count the matches that ss8_multisearch_find_all() should report for
+// 'patterns', and find the one that ss8_multisearch_find() should return.
+size_t naive_multisearch(char const *h, size_t hlen, size_t start,
+                         char const *const *patterns, size_t npatterns,
+                         size_t *first_pos, size_t *first_pattern) {
+    size_t count = 0;
+    *first_pos = SIZE_MAX;
+    for (size_t b = start; b <= hlen; ++b) {
+        size_t best = SIZE_MAX;
+        for (size_t i = 0; i < npatterns; ++i) {
+            size_t const len = strlen(patterns[i]);
+            bool dup = false;
+            for (size_t j = 0; j < i; ++j)
+                dup = dup || strcmp(patterns[i], patterns[j]) == 0;
+            if (dup || len > hlen - b ||
+                memcmp(h + b, patterns[i], len) != 0)
+                continue;
+            ++count;
+            if (best == SIZE_MAX || len > strlen(patterns[best]))
+                best = i;
+        }
+        if (*first_pos == SIZE_MAX && best != SIZE_MAX) {
+            *first_pos = b;
+            *first_pattern = best;
+        }
+    }
+    return count;
+}
+
+void test_multisearch_long(void) {
+    char const *const sets[][6] = {
+        {"-", NULL},
+        {"+-", "-+", "--", NULL},
+        {"-+++-", "++-+", "+++++++++++++++-", "-+++++-", NULL},
+        {"abc", "bcd", "cde", "-", NULL},
+        {"+++", "++", "+", NULL},
+        {"-abcde-", "bcd", "c", "abcde-+", NULL},
+    };
+    char buf[200];
+    size_t const buflen = sizeof(buf) - 1;
+    for (size_t k = 0; k < sizeof(sets) / sizeof(sets[0]); ++k) {
+        size_t npat = 0;
+        ss8_multisearch ms;
+        ss8_multisearch_init(&ms);
+        while (sets[k][npat] != NULL)
+            ss8_multisearch_add_cstr(&ms, sets[k][npat++]);
+        ss8_multisearch_compile(&ms);
+        for (size_t pos = 0; pos < buflen; pos += 17) {
+            make_test_string(buf, sizeof(buf));
+            memcpy(buf + pos, "-abcde-", buflen - pos < 7 ? buflen - pos : 7);
+            if (pos + 60 < buflen)
+                buf[pos + 60] = '-';
+            ss8str s;
+            ss8_init_copy_bytes(&s, buf, buflen);
+            for (size_t start = 0; start <= buflen; start += 23) {
+                size_t epos, epat = SIZE_MAX, pat = SIZE_MAX;
+                size_t const ecount = naive_multisearch(
+                    buf, buflen, start, sets[k], npat, &epos, &epat);
+                TEST_ASSERT_EQUAL_size_t(
+                    ecount,
+                    ss8_multisearch_find_all(&ms, &s, start, NULL, NULL));
+                TEST_ASSERT_EQUAL_size_t(
+                    epos, ss8_multisearch_find(&ms, &s, start, &pat));
+                if (epos != SIZE_MAX)
+                    TEST_ASSERT_EQUAL_size_t(epat, pat);
+            }
+            ss8_destroy(&s);
+        }
+        ss8_multisearch_destroy(&ms);
+    }
+
+    // Patterns using every byte value, so that no byte class is left over
+    ss8_multisearch ms;
+    ss8_multisearch_init(&ms);
+    char all[256];
+    for (size_t i = 0; i < 256; ++i)
+        all[i] = (char)(255 - i);
+    ss8_multisearch_add_bytes(&ms, all, 256);
+    ss8_multisearch_add_bytes(&ms, "\0\xff", 2);
+    ss8_multisearch_compile(&ms);
+    ss8str s;
+    ss8_init_copy_ch_n(&s, '\0', 300);
+    TEST_ASSERT_FALSE(ss8_multisearch_contains(&ms, &s));
+    ss8_set_at(&s, 100, '\xff');
+    size_t pat;
+    TEST_ASSERT_EQUAL_size_t(99, ss8_multisearch_find(&ms, &s, 0, &pat));
+    TEST_ASSERT_EQUAL_size_t(1, pat);
+    ss8_replace_bytes(&s, 150, 0, all, 256);
+    TEST_ASSERT_EQUAL_size_t(149, ss8_multisearch_find(&ms, &s, 100, &pat));
+    TEST_ASSERT_EQUAL_size_t(1, pat);
+    TEST_ASSERT_EQUAL_size_t(150, ss8_multisearch_find(&ms, &s, 150, &pat));
+    TEST_ASSERT_EQUAL_size_t(0, pat);
+    TEST_ASSERT_EQUAL_size_t(
+        3, ss8_multisearch_find_all(&ms, &s, 0, NULL, NULL));
+    ss8_multisearch_destroy(&ms);
+    ss8_destroy(&s);
+}
+
+void test_replace_all(void) {
+    ss8str s, n, t;
+    ss8_init_copy_cstr(&s, "abcabc");
+    ss8_init_copy_cstr(&n, "bc");
+    ss8_init_copy_cstr(&t, "X");
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all(&s, &n, &t));
+    TEST_ASSERT_EXACT_SS8STR("aXaX", &s);
+
+    ss8_copy_cstr(&s, "abcabc");
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_cstr(&s, "b", "Y"));
+    TEST_ASSERT_EXACT_SS8STR("aYcaYc", &s);
+
+    ss8_copy_cstr(&s, "abcabc");
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_cstr(&s, "c", "xyz"));
+    TEST_ASSERT_EXACT_SS8STR("abxyzabxyz", &s);
+
+    ss8_copy_cstr(&s, "abcabc");
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_cstr(&s, "a", ""));
+    TEST_ASSERT_EXACT_SS8STR("bcbc", &s);
+
+    ss8_copy_cstr(&s, "abcabc");
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_cstr(&s, "d", "xyz"));
+    TEST_ASSERT_EXACT_SS8STR("abcabc", &s);
+
+    // Matches do not overlap and are taken from the left.
+    ss8_copy_cstr(&s, "aaaaa");
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_cstr(&s, "aa", "b"));
+    TEST_ASSERT_EXACT_SS8STR("bba", &s);
+    ss8_copy_cstr(&s, "aaaaa");
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_cstr(&s, "aa", "aaa"));
+    TEST_ASSERT_EXACT_SS8STR("aaaaaaa", &s);
+
+    // The empty needle matches between every pair of bytes and at both ends.
+    ss8_copy_cstr(&s, "abc");
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_cstr(&s, "", "-"));
+    TEST_ASSERT_EXACT_SS8STR("-a-b-c-", &s);
+    ss8_clear(&s);
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_cstr(&s, "", "-"));
+    TEST_ASSERT_EXACT_SS8STR("-", &s);
+    ss8_copy_cstr(&s, "abc");
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_cstr(&s, "", ""));
+    TEST_ASSERT_EXACT_SS8STR("abc", &s);
+
+    // Growing from a short to a long string.
+    ss8_copy_cstr(&s, "a.b");
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_cstr(
+                                  &s, ".", "0123456789012345678901234567"));
+    TEST_ASSERT_EXACT_SS8STR("a0123456789012345678901234567b", &s);
+
+    ss8_copy_bytes(&s, "a\0b\0c", 5);
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_bytes(&s, "\0", 1, "::", 2));
+    TEST_ASSERT_EXACT_SS8STR("a::b::c", &s);
+
+    ss8_destroy(&t);
+    ss8_destroy(&n);
+    ss8_destroy(&s);
+}
+
+void test_replace_all_long(void) {
+    // Compare with repeated find and replace.
+    char buf[300];
+    make_test_string(buf, sizeof(buf));
+    size_t const buflen = sizeof(buf) - 1;
+    char const *needles[] = {"-", "+-", "-+-", "++-++"};
+    char const *srcs[] = {"", "x", "xy", "xyz", "xyzxyzxyzxyzxyzxyzxyz"};
+    for (size_t i = 0; i < sizeof(needles) / sizeof(needles[0]); ++i) {
+        char const *n = needles[i];
+        size_t const nlen = strlen(n);
+        for (size_t j = 0; j < sizeof(srcs) / sizeof(srcs[0]); ++j) {
+            char const *src = srcs[j];
+            size_t const srclen = strlen(src);
+            for (size_t step = 1; step < 40; step += 6) {
+                make_test_string(buf, sizeof(buf));
+                for (size_t pos = 0; pos + nlen <= buflen; pos += step)
+                    memcpy(buf + pos, n, nlen);
+
+                ss8str expected;
+                ss8_init_copy_bytes(&expected, buf, buflen);
+                size_t start = 0;
+                for (;;) {
+                    size_t const m =
+                        naive_find(ss8_cstr(&expected), ss8_len(&expected),
+                                   start, n, nlen);
+                    if (m == SIZE_MAX)
+                        break;
+                    ss8_replace_bytes(&expected, m, nlen, src, srclen);
+                    start = m + srclen;
+                }
+
+                ss8str s;
+                ss8_init_copy_bytes(&s, buf, buflen);
+                ss8_replace_all_bytes(&s, n, nlen, src, srclen);
+                TEST_ASSERT_TRUE(ss8_equals(&expected, &s));
+                TEST_ASSERT_EQUAL_CHAR('\0', ss8_cstr(&s)[ss8_len(&s)]);
+                ss8_destroy(&s);
+                ss8_destroy(&expected);
+            }
+        }
+    }
+}
+
+void test_replace_all_ch(void) {
+    ss8str s;
+    ss8_init(&s);
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_ch(&s, 'a', 'b'));
+    TEST_ASSERT_EXACT_SS8STR("", &s);
+
+    ss8_copy_cstr(&s, "banana");
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_replace_all_ch(&s, 'a', 'o'));
+    TEST_ASSERT_EXACT_SS8STR("bonono", &s);
+
+    char buf[100];
+    make_test_string(buf, sizeof(buf));
+    ss8_copy_cstr(&s, buf);
+    ss8_replace_all_ch(&s, '+', '-');
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_find_not_ch(&s, 0, '-'));
+    TEST_ASSERT_EQUAL_size_t(sizeof(buf) - 1, ss8_len(&s));
+    ss8_destroy(&s);
+}
+
 void test_rfind(void) {
     ss8str s, t;
     ss8_init_copy_cstr(&s, "abcabc");
@@ -1952,6 +2853,192 @@ void test_rfind_not_ch(void) {
     ss8_destroy(&s);
 }
 
+void test_count(void) {
+    ss8str s, n;
+    ss8_init_copy_cstr(&s, "abcabcab");
+    ss8_init_copy_cstr(&n, "ab");
+    TEST_ASSERT_EQUAL_size_t(3, ss8_count(&s, 0, &n));
+    TEST_ASSERT_EQUAL_size_t(2, ss8_count(&s, 1, &n));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_count(&s, 7, &n));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_count(&s, 8, &n));
+    TEST_ASSERT_EQUAL_size_t(2, ss8_count_cstr(&s, 0, "c"));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_count_cstr(&s, 0, "cabcab"));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_count_cstr(&s, 0, "abcabcabc"));
+    TEST_ASSERT_EQUAL_size_t(9, ss8_count_cstr(&s, 0, ""));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_count_cstr(&s, 8, ""));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_count_ch(&s, 0, 'a'));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_count_ch(&s, 4, 'c'));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_count_ch(&s, 0, 'd'));
+
+    // Non-overlapping.
+    ss8_copy_cstr(&s, "aaaaa");
+    TEST_ASSERT_EQUAL_size_t(2, ss8_count_cstr(&s, 0, "aa"));
+    TEST_ASSERT_EQUAL_size_t(2, ss8_count_bytes(&s, 1, "aa", 2));
+
+    ss8_clear(&s);
+    TEST_ASSERT_EQUAL_size_t(0, ss8_count_ch(&s, 0, 'a'));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_count_cstr(&s, 0, ""));
+
+    ss8_destroy(&n);
+    ss8_destroy(&s);
+}
+
+void test_count_ch_long(void) {
+    // Exercise block boundaries and counter overflow of vectorized counting.
+    size_t const lens[] = {15, 16, 17, 31, 32, 33, 100, 255 * 32 + 17,
+                           3 * 255 * 32};
+    for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); ++i) {
+        size_t const len = lens[i];
+        ss8str s;
+        ss8_init(&s);
+        ss8_set_len(&s, len);
+        char *p = ss8_mutable_cstr(&s);
+        memset(p, '+', len);
+        TEST_ASSERT_EQUAL_size_t(len, ss8_count_ch(&s, 0, '+'));
+        size_t expected = 0;
+        for (size_t j = 0; j < len; j += 3 + j % 5) {
+            p[j] = '-';
+            ++expected;
+        }
+        TEST_ASSERT_EQUAL_size_t(expected, ss8_count_ch(&s, 0, '-'));
+        TEST_ASSERT_EQUAL_size_t(len - expected, ss8_count_ch(&s, 0, '+'));
+        TEST_ASSERT_EQUAL_size_t(expected - 1, ss8_count_ch(&s, 1, '-'));
+        TEST_ASSERT_EQUAL_size_t(expected, ss8_count_cstr(&s, 0, "-"));
+        ss8_destroy(&s);
+    }
+}
+
+void test_find_all(void) {
+    ss8str s, n;
+    ss8_init_copy_cstr(&s, "a,bc,,d,");
+    ss8_init_copy_cstr(&n, ",");
+    size_t pos[8];
+    TEST_ASSERT_EQUAL_size_t(4, ss8_find_all(&s, 0, &n, pos, 8));
+    TEST_ASSERT_EQUAL_size_t(1, pos[0]);
+    TEST_ASSERT_EQUAL_size_t(4, pos[1]);
+    TEST_ASSERT_EQUAL_size_t(5, pos[2]);
+    TEST_ASSERT_EQUAL_size_t(7, pos[3]);
+
+    // In batches.
+    TEST_ASSERT_EQUAL_size_t(0, ss8_find_all(&s, 0, &n, pos, 0));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_find_all_cstr(&s, 0, ",", pos, 3));
+    TEST_ASSERT_EQUAL_size_t(5, pos[2]);
+    size_t const next = pos[2] + 1;
+    TEST_ASSERT_EQUAL_size_t(1, ss8_find_all_cstr(&s, next, ",", pos, 3));
+    TEST_ASSERT_EQUAL_size_t(7, pos[0]);
+    TEST_ASSERT_EQUAL_size_t(0, ss8_find_all_cstr(&s, 8, ",", pos, 3));
+
+    ss8_copy_cstr(&s, "aaaaa");
+    TEST_ASSERT_EQUAL_size_t(2, ss8_find_all_bytes(&s, 0, "aa", 2, pos, 8));
+    TEST_ASSERT_EQUAL_size_t(0, pos[0]);
+    TEST_ASSERT_EQUAL_size_t(2, pos[1]);
+
+    ss8_copy_cstr(&s, "ab");
+    TEST_ASSERT_EQUAL_size_t(3, ss8_find_all_cstr(&s, 0, "", pos, 8));
+    TEST_ASSERT_EQUAL_size_t(0, pos[0]);
+    TEST_ASSERT_EQUAL_size_t(1, pos[1]);
+    TEST_ASSERT_EQUAL_size_t(2, pos[2]);
+
+    ss8_destroy(&n);
+    ss8_destroy(&s);
+}
+
+void test_find_all_long(void) {
+    // Compare with repeated find.
+    char buf[200];
+    char const *needles[] = {"-", "+-", "-+-", "++-++"};
+    for (size_t i = 0; i < sizeof(needles) / sizeof(needles[0]); ++i) {
+        char const *n = needles[i];
+        size_t const nlen = strlen(n);
+        for (size_t step = 1; step < 40; step += 6) {
+            make_test_string(buf, sizeof(buf));
+            for (size_t pos = 0; pos + nlen < sizeof(buf); pos += step)
+                memcpy(buf + pos, n, nlen);
+            ss8str s;
+            ss8_init_copy_cstr(&s, buf);
+            size_t positions[sizeof(buf)];
+            size_t const count = ss8_find_all_cstr(&s, 0, n, positions,
+                                                   sizeof(buf));
+            TEST_ASSERT_EQUAL_size_t(count, ss8_count_cstr(&s, 0, n));
+            size_t start = 0;
+            for (size_t j = 0; j < count; ++j) {
+                size_t const expected =
+                    naive_find(buf, sizeof(buf) - 1, start, n, nlen);
+                TEST_ASSERT_EQUAL_size_t(expected, positions[j]);
+                start = expected + nlen;
+            }
+            TEST_ASSERT_EQUAL_size_t(
+                SIZE_MAX, naive_find(buf, sizeof(buf) - 1, start, n, nlen));
+            ss8_destroy(&s);
+        }
+    }
+}
+
+void test_charset(void) {
+    ss8_charset set;
+    TEST_ASSERT_EQUAL_PTR(&set, ss8_charset_init_bytes(&set, "", 0));
+    for (int c = 0; c < 256; ++c)
+        TEST_ASSERT_FALSE(ss8_charset_contains(&set, (char)c));
+
+    char all[256];
+    for (int c = 0; c < 256; ++c)
+        all[c] = (char)c;
+    ss8_charset_init_bytes(&set, all, sizeof(all));
+    for (int c = 0; c < 256; ++c)
+        TEST_ASSERT_TRUE(ss8_charset_contains(&set, (char)c));
+
+    // Each byte on its own, to check the table layout.
+    for (int c = 0; c < 256; ++c) {
+        char const ch = (char)c;
+        ss8_charset_init_bytes(&set, &ch, 1);
+        for (int d = 0; d < 256; ++d)
+            TEST_ASSERT_TRUE(ss8_charset_contains(&set, (char)d) == (c == d));
+    }
+
+    TEST_ASSERT_EQUAL_PTR(&set, ss8_charset_init_cstr(&set, "a\xff"));
+    TEST_ASSERT_TRUE(ss8_charset_contains(&set, 'a'));
+    TEST_ASSERT_TRUE(ss8_charset_contains(&set, '\xff'));
+    TEST_ASSERT_FALSE(ss8_charset_contains(&set, '\0'));
+    TEST_ASSERT_FALSE(ss8_charset_contains(&set, 'b'));
+
+    ss8str s;
+    ss8_init_copy_bytes(&s, "x\0", 2);
+    TEST_ASSERT_EQUAL_PTR(&set, ss8_charset_init(&set, &s));
+    TEST_ASSERT_TRUE(ss8_charset_contains(&set, 'x'));
+    TEST_ASSERT_TRUE(ss8_charset_contains(&set, '\0'));
+    TEST_ASSERT_FALSE(ss8_charset_contains(&set, 'a'));
+    ss8_destroy(&s);
+}
+
+void test_find_of_set(void) {
+    ss8str s;
+    ss8_init_copy_cstr(&s, "the quick\tbrown\nfox");
+    ss8_charset ws, alpha;
+    ss8_charset_init_cstr(&ws, " \t\n\r");
+    ss8_charset_init_cstr(&alpha, "abcdefghijklmnopqrstuvwxyz");
+
+    TEST_ASSERT_EQUAL_size_t(3, ss8_find_first_of_set(&s, 0, &ws));
+    TEST_ASSERT_EQUAL_size_t(9, ss8_find_first_of_set(&s, 4, &ws));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_find_first_of_set(&s, 16, &ws));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_find_first_not_of_set(&s, 0, &alpha));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX,
+                             ss8_find_first_not_of_set(&s, 16, &alpha));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_find_last_of_set(&s, 2, &ws));
+    TEST_ASSERT_EQUAL_size_t(9, ss8_find_last_of_set(&s, 14, &ws));
+    TEST_ASSERT_EQUAL_size_t(15, ss8_find_last_of_set(&s, 19, &ws));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX,
+                             ss8_find_last_not_of_set(&s, 2, &alpha));
+    TEST_ASSERT_EQUAL_size_t(15, ss8_find_last_not_of_set(&s, 19, &alpha));
+
+    ss8_clear(&s);
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_find_first_of_set(&s, 0, &ws));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX,
+                             ss8_find_first_not_of_set(&s, 0, &ws));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_find_last_of_set(&s, 0, &ws));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_find_last_not_of_set(&s, 0, &ws));
+    ss8_destroy(&s);
+}
+
 void test_find_first_of(void) {
     ss8str s;
     ss8_init(&s);
@@ -2091,6 +3178,77 @@ void test_find_last_not_of(void) {
     ss8_destroy(&s);
 }
 
+void test_find_of_long(void) {
+    // Exercise all byte values, including NUL and bytes >= 0x80, across block
+    // boundaries of vectorized classification.
+    char buf[300];
+    for (size_t i = 0; i < sizeof(buf); ++i)
+        buf[i] = (char)(i * 37 % 256);
+    char const *sets[] = {"\0\x80", " \t\r\n,;", "\x7f\x80\xff\x01",
+                          "0123456789abcdefABCDEF\xc3\xa9"};
+    size_t const setlens[] = {2, 6, 4, 24};
+    ss8str s;
+    ss8_init_copy_bytes(&s, buf, sizeof(buf));
+    for (size_t i = 0; i < sizeof(sets) / sizeof(sets[0]); ++i) {
+        char const *set = sets[i];
+        size_t const setlen = setlens[i];
+        for (size_t start = 0; start <= sizeof(buf); ++start) {
+            size_t first_of = SIZE_MAX;
+            size_t first_not_of = SIZE_MAX;
+            for (size_t j = start; j < sizeof(buf); ++j) {
+                bool const in = memchr(set, buf[j], setlen) != NULL;
+                if (in && first_of == SIZE_MAX)
+                    first_of = j;
+                if (!in && first_not_of == SIZE_MAX)
+                    first_not_of = j;
+            }
+            size_t last_of = SIZE_MAX;
+            size_t last_not_of = SIZE_MAX;
+            for (size_t j = 0; j <= start && j < sizeof(buf); ++j) {
+                bool const in = memchr(set, buf[j], setlen) != NULL;
+                if (in)
+                    last_of = j;
+                else
+                    last_not_of = j;
+            }
+            TEST_ASSERT_EQUAL_size_t(
+                first_of, ss8_find_first_of_bytes(&s, start, set, setlen));
+            TEST_ASSERT_EQUAL_size_t(
+                first_not_of,
+                ss8_find_first_not_of_bytes(&s, start, set, setlen));
+            TEST_ASSERT_EQUAL_size_t(
+                last_of, ss8_find_last_of_bytes(&s, start, set, setlen));
+            TEST_ASSERT_EQUAL_size_t(
+                last_not_of,
+                ss8_find_last_not_of_bytes(&s, start, set, setlen));
+
+            ss8_charset cs;
+            ss8_charset_init_bytes(&cs, set, setlen);
+            TEST_ASSERT_EQUAL_size_t(first_of,
+                                     ss8_find_first_of_set(&s, start, &cs));
+            TEST_ASSERT_EQUAL_size_t(
+                first_not_of, ss8_find_first_not_of_set(&s, start, &cs));
+            TEST_ASSERT_EQUAL_size_t(last_of,
+                                     ss8_find_last_of_set(&s, start, &cs));
+            TEST_ASSERT_EQUAL_size_t(
+                last_not_of, ss8_find_last_not_of_set(&s, start, &cs));
+        }
+    }
+
+    // Long runs of members, so that a non-member is found late.
+    memset(buf, ' ', sizeof(buf));
+    buf[250] = 'x';
+    ss8_copy_bytes(&s, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_size_t(250, ss8_find_first_not_of_cstr(&s, 0, " \t"));
+    TEST_ASSERT_EQUAL_size_t(250, ss8_find_first_of_cstr(&s, 0, "xy"));
+    buf[250] = ' ';
+    buf[3] = 'x';
+    ss8_copy_bytes(&s, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_find_last_not_of_cstr(&s, 299, " \t"));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_find_last_of_cstr(&s, 299, "xy"));
+    ss8_destroy(&s);
+}
+
 void test_starts_with_bytes(void) {
     ss8str s;
     ss8_init(&s);
@@ -2215,6 +3373,22 @@ void test_strip(void) {
     TEST_ASSERT_EXACT_SS8STR("bbb", ss8_strip(&s, &t));
     ss8_destroy(&t);
 
+    ss8_charset set;
+    ss8_charset_init_cstr(&set, "acx");
+    ss8_copy_cstr(&s, "aabbbccc");
+    TEST_ASSERT_EXACT_SS8STR("bbbccc", ss8_lstrip_set(&s, &set));
+    ss8_copy_cstr(&s, "aabbbccc");
+    TEST_ASSERT_EXACT_SS8STR("aabbb", ss8_rstrip_set(&s, &set));
+    ss8_copy_cstr(&s, "aabbbccc");
+    TEST_ASSERT_EXACT_SS8STR("bbb", ss8_strip_set(&s, &set));
+    ss8_charset_init_cstr(&set, "abc");
+    ss8_copy_cstr(&s, "aabbbccc");
+    TEST_ASSERT_EXACT_SS8STR("", ss8_lstrip_set(&s, &set));
+    ss8_copy_cstr(&s, "aabbbccc");
+    TEST_ASSERT_EXACT_SS8STR("", ss8_rstrip_set(&s, &set));
+    ss8_copy_cstr(&s, "aabbbccc");
+    TEST_ASSERT_EXACT_SS8STR("", ss8_strip_set(&s, &set));
+
     ss8_destroy(&s);
 }
 
@@ -2241,6 +3415,388 @@ void test_strip_ch(void) {
     ss8_destroy(&s);
 }
 
+#define TEST_ASSERT_VIEW(expected_cstr, actual)                               \
+    do {                                                                      \
+        ss8view av = (actual);                                                \
+        TEST_ASSERT_EQUAL_size_t(strlen(expected_cstr), av.len);              \
+        if (av.len > 0) {                                                     \
+            TEST_ASSERT_EQUAL_MEMORY((expected_cstr), av.ptr, av.len);        \
+        }                                                                     \
+    } while (0)
+
+void test_view(void) {
+    ss8str s;
+    ss8_init_copy_cstr(&s, "key = value");
+
+    ss8view v = ss8_view(&s);
+    TEST_ASSERT_EQUAL_PTR(ss8_cstr(&s), v.ptr);
+    TEST_ASSERT_EQUAL_size_t(11, v.len);
+
+    TEST_ASSERT_VIEW("key", ss8_view_substr(&s, 0, 3));
+    TEST_ASSERT_VIEW("value", ss8_view_substr(&s, 6, SIZE_MAX));
+    TEST_ASSERT_VIEW("", ss8_view_substr(&s, 11, 5));
+    TEST_ASSERT_VIEW("= ", ss8_view_slice(v, 4, 2));
+    TEST_ASSERT_VIEW("", ss8_view_slice(v, 11, SIZE_MAX));
+    TEST_ASSERT_VIEW("abc", ss8_view_cstr("abc"));
+    TEST_ASSERT_VIEW("ab", ss8_view_bytes("abc", 2));
+
+    ss8str t;
+    ss8_init_copy_view(&t, ss8_view_slice(v, 6, 3));
+    TEST_ASSERT_EXACT_SS8STR("val", &t);
+    TEST_ASSERT_EQUAL_PTR(&t, ss8_copy_view(&t, ss8_view_slice(v, 0, 3)));
+    TEST_ASSERT_EXACT_SS8STR("key", &t);
+    TEST_ASSERT_EQUAL_PTR(&t, ss8_cat_view(&t, ss8_view_slice(v, 3, 3)));
+    TEST_ASSERT_EXACT_SS8STR("key = ", &t);
+    ss8_destroy(&t);
+
+    ss8_destroy(&s);
+}
+
+void test_view_cmp(void) {
+    ss8view const abc = ss8_view_cstr("abc");
+    TEST_ASSERT_TRUE(ss8_view_cmp(abc, ss8_view_cstr("abc")) == 0);
+    TEST_ASSERT_TRUE(ss8_view_cmp(abc, ss8_view_cstr("abd")) < 0);
+    TEST_ASSERT_TRUE(ss8_view_cmp(abc, ss8_view_cstr("ab")) > 0);
+    TEST_ASSERT_TRUE(ss8_view_cmp(abc, ss8_view_cstr("abcd")) < 0);
+    TEST_ASSERT_TRUE(ss8_view_cmp(ss8_view_cstr(""), ss8_view_cstr("")) == 0);
+
+    TEST_ASSERT_TRUE(ss8_view_equals(abc, ss8_view_bytes("abcd", 3)));
+    TEST_ASSERT_FALSE(ss8_view_equals(abc, ss8_view_cstr("ab")));
+    TEST_ASSERT_FALSE(ss8_view_equals(abc, ss8_view_cstr("abd")));
+
+    TEST_ASSERT_TRUE(ss8_view_starts_with(abc, ss8_view_cstr("")));
+    TEST_ASSERT_TRUE(ss8_view_starts_with(abc, ss8_view_cstr("ab")));
+    TEST_ASSERT_TRUE(ss8_view_starts_with(abc, abc));
+    TEST_ASSERT_FALSE(ss8_view_starts_with(abc, ss8_view_cstr("b")));
+    TEST_ASSERT_FALSE(ss8_view_starts_with(abc, ss8_view_cstr("abcd")));
+
+    TEST_ASSERT_TRUE(ss8_view_ends_with(abc, ss8_view_cstr("")));
+    TEST_ASSERT_TRUE(ss8_view_ends_with(abc, ss8_view_cstr("bc")));
+    TEST_ASSERT_TRUE(ss8_view_ends_with(abc, abc));
+    TEST_ASSERT_FALSE(ss8_view_ends_with(abc, ss8_view_cstr("b")));
+    TEST_ASSERT_FALSE(ss8_view_ends_with(abc, ss8_view_cstr("zabc")));
+}
+
+void test_view_find(void) {
+    // The view excludes the surrounding "xx" so that matches there are not
+    // found.
+    ss8view const h = ss8_view_bytes("xxabcabcxx" + 2, 6);
+    TEST_ASSERT_EQUAL_size_t(1, ss8_view_find(h, 0, ss8_view_cstr("bc")));
+    TEST_ASSERT_EQUAL_size_t(4, ss8_view_find(h, 2, ss8_view_cstr("bc")));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX,
+                             ss8_view_find(h, 5, ss8_view_cstr("bc")));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX,
+                             ss8_view_find(h, 0, ss8_view_cstr("cx")));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_view_find(h, 3, ss8_view_cstr("")));
+    TEST_ASSERT_EQUAL_size_t(6, ss8_view_find(h, 6, ss8_view_cstr("")));
+
+    TEST_ASSERT_EQUAL_size_t(2, ss8_view_find_ch(h, 0, 'c'));
+    TEST_ASSERT_EQUAL_size_t(5, ss8_view_find_ch(h, 3, 'c'));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_view_find_ch(h, 0, 'x'));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_view_find_ch(h, 6, 'a'));
+
+    TEST_ASSERT_EQUAL_size_t(4, ss8_view_rfind(h, 6, ss8_view_cstr("bc")));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_view_rfind(h, 3, ss8_view_cstr("bc")));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX,
+                             ss8_view_rfind(h, 0, ss8_view_cstr("bc")));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX,
+                             ss8_view_rfind(h, 6, ss8_view_cstr("xa")));
+    TEST_ASSERT_EQUAL_size_t(2, ss8_view_rfind(h, 2, ss8_view_cstr("")));
+
+    TEST_ASSERT_EQUAL_size_t(3, ss8_view_rfind_ch(h, 6, 'a'));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_view_rfind_ch(h, 2, 'a'));
+    TEST_ASSERT_EQUAL_size_t(SIZE_MAX, ss8_view_rfind_ch(h, 6, 'x'));
+}
+
+void test_view_strip(void) {
+    ss8view const ws = ss8_view_cstr(" \t");
+    ss8view const v = ss8_view_cstr(" \t a b \t");
+    TEST_ASSERT_VIEW("a b \t", ss8_view_lstrip(v, ws));
+    TEST_ASSERT_VIEW(" \t a b", ss8_view_rstrip(v, ws));
+    TEST_ASSERT_VIEW("a b", ss8_view_strip(v, ws));
+    TEST_ASSERT_VIEW(" \t a b \t", ss8_view_strip(v, ss8_view_cstr("")));
+    TEST_ASSERT_VIEW("", ss8_view_lstrip(ss8_view_cstr(" \t"), ws));
+    TEST_ASSERT_VIEW("", ss8_view_rstrip(ss8_view_cstr(" \t"), ws));
+    TEST_ASSERT_VIEW("", ss8_view_strip(ss8_view_cstr(" \t"), ws));
+    TEST_ASSERT_VIEW("", ss8_view_strip(ss8_view_cstr(""), ws));
+
+    // Long enough for the vectorized kernels.
+    char buf[100];
+    memset(buf, ' ', sizeof(buf));
+    buf[40] = 'a';
+    buf[60] = 'b';
+    ss8view const s = ss8_view_strip(ss8_view_bytes(buf, sizeof(buf)), ws);
+    TEST_ASSERT_EQUAL_PTR(buf + 40, s.ptr);
+    TEST_ASSERT_EQUAL_size_t(21, s.len);
+}
+
+void test_cat_many(void) {
+    ss8str s;
+    ss8_init_copy_cstr(&s, "a");
+    ss8view pieces[3];
+    pieces[0] = ss8_view_cstr("bc");
+    pieces[1] = ss8_view_cstr("");
+    pieces[2] = ss8_view_bytes("d\0e", 3);
+
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_cat_many(&s, pieces, 0));
+    TEST_ASSERT_EXACT_SS8STR("a", &s);
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_cat_many(&s, pieces, 3));
+    TEST_ASSERT_EQUAL_size_t(6, ss8_len(&s));
+    TEST_ASSERT_EQUAL_MEMORY("abcd\0e", ss8_cstr(&s), 7);
+
+    // Growing from short to long mode allocates once, to the exact length.
+    char buf[100];
+    make_test_string(buf, sizeof(buf));
+    ss8view longpieces[4];
+    for (size_t i = 0; i < 4; ++i)
+        longpieces[i] = ss8_view_bytes(buf + 25 * i, 25);
+    ss8_clear(&s);
+    ss8_cat_many(&s, longpieces, 4);
+    TEST_ASSERT_EQUAL_size_t(100, ss8_len(&s));
+    TEST_ASSERT_ALLOCATED_size_t(100, ss8_capacity(&s));
+    TEST_ASSERT_EQUAL_MEMORY(buf, ss8_cstr(&s), 100);
+    TEST_ASSERT_EQUAL_CHAR('\0', ss8_cstr(&s)[100]);
+
+    ss8_destroy(&s);
+}
+
+void test_join(void) {
+    ss8str s, sep;
+    ss8_init_copy_cstr(&s, "garbage");
+    ss8_init_copy_cstr(&sep, ", ");
+    ss8view pieces[3];
+    pieces[0] = ss8_view_cstr("a");
+    pieces[1] = ss8_view_cstr("");
+    pieces[2] = ss8_view_cstr("bc");
+
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_join(&s, pieces, 3, &sep));
+    TEST_ASSERT_EXACT_SS8STR("a, , bc", &s);
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_join_cstr(&s, pieces, 2, "--"));
+    TEST_ASSERT_EXACT_SS8STR("a--", &s);
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_join_bytes(&s, pieces + 2, 1, "-", 1));
+    TEST_ASSERT_EXACT_SS8STR("bc", &s);
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_join_ch(&s, pieces, 3, '/'));
+    TEST_ASSERT_EXACT_SS8STR("a//bc", &s);
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_join_ch(&s, pieces, 0, '/'));
+    TEST_ASSERT_EXACT_SS8STR("", &s);
+
+    char buf[100];
+    make_test_string(buf, sizeof(buf));
+    ss8view longpieces[10];
+    for (size_t i = 0; i < 10; ++i)
+        longpieces[i] = ss8_view_bytes(buf + 10 * i, 10);
+    ss8_join_ch(&s, longpieces, 10, '\n');
+    TEST_ASSERT_EQUAL_size_t(109, ss8_len(&s));
+    for (size_t i = 0; i < 10; ++i)
+        TEST_ASSERT_EQUAL_MEMORY(buf + 10 * i, ss8_cstr(&s) + 11 * i, 10);
+    for (size_t i = 0; i < 9; ++i)
+        TEST_ASSERT_EQUAL_CHAR('\n', ss8_cstr(&s)[11 * i + 10]);
+    TEST_ASSERT_EQUAL_CHAR('\0', ss8_cstr(&s)[109]);
+
+    ss8_destroy(&sep);
+    ss8_destroy(&s);
+}
+
+// Bracket and concatenate the remaining fields of *sp.
+ss8str *split_fields(ss8str *dest, ss8_split *sp) {
+    ss8_clear(dest);
+    ss8view field;
+    while (ss8_split_next(sp, &field)) {
+        ss8_cat_ch(dest, '[');
+        ss8_cat_view(dest, field);
+        ss8_cat_ch(dest, ']');
+    }
+    TEST_ASSERT_FALSE(ss8_split_next(sp, &field));
+    return dest;
+}
+
+void test_split(void) {
+    ss8str s, d, out;
+    ss8_init(&s);
+    ss8_init_copy_cstr(&d, "::");
+    ss8_init(&out);
+    ss8_split sp;
+
+    ss8_split_init_ch(&sp, &s, ',');
+    TEST_ASSERT_EXACT_SS8STR("[]", split_fields(&out, &sp));
+
+    ss8_copy_cstr(&s, ",a,,bc,");
+    ss8_split_init_ch(&sp, &s, ',');
+    TEST_ASSERT_EXACT_SS8STR("[][a][][bc][]", split_fields(&out, &sp));
+
+    ss8_charset set;
+    ss8_charset_init_cstr(&set, ",;");
+    ss8_copy_cstr(&s, "a;b,,c");
+    ss8_split_init_set(&sp, &s, &set);
+    TEST_ASSERT_EXACT_SS8STR("[a][b][][c]", split_fields(&out, &sp));
+
+    ss8_copy_cstr(&s, "a::b:::c::");
+    ss8_split_init(&sp, &s, &d);
+    TEST_ASSERT_EXACT_SS8STR("[a][b][:c][]", split_fields(&out, &sp));
+    ss8_split_init_cstr(&sp, &s, ":::");
+    TEST_ASSERT_EXACT_SS8STR("[a::b][c::]", split_fields(&out, &sp));
+    ss8_split_init_bytes(&sp, &s, "b:::c::x", 7);
+    TEST_ASSERT_EXACT_SS8STR("[a::][]", split_fields(&out, &sp));
+    ss8_split_init_cstr(&sp, &s, "a::b:::c::x");
+    TEST_ASSERT_EXACT_SS8STR("[a::b:::c::]", split_fields(&out, &sp));
+
+    // Fields view the split string itself.
+    ss8_copy_cstr(&s, "key=value");
+    ss8_split_init_ch(&sp, &s, '=');
+    ss8view field;
+    TEST_ASSERT_TRUE(ss8_split_next(&sp, &field));
+    TEST_ASSERT_EQUAL_PTR(ss8_cstr(&s), field.ptr);
+    TEST_ASSERT_TRUE(ss8_split_next(&sp, &field));
+    TEST_ASSERT_EQUAL_PTR(ss8_cstr(&s) + 4, field.ptr);
+    TEST_ASSERT_VIEW("value", field);
+
+    ss8_destroy(&out);
+    ss8_destroy(&d);
+    ss8_destroy(&s);
+}
+
+void test_split_options(void) {
+    ss8str s, out;
+    ss8_init_copy_cstr(&s, ",,a,,b,c,,");
+    ss8_init(&out);
+    ss8_split sp;
+
+    ss8_split_init_ch(&sp, &s, ',');
+    ss8_split_skip_empty(&sp);
+    TEST_ASSERT_EXACT_SS8STR("[a][b][c]", split_fields(&out, &sp));
+
+    ss8_split_init_ch(&sp, &s, ',');
+    ss8_split_limit(&sp, 3);
+    TEST_ASSERT_EXACT_SS8STR("[][][a][,b,c,,]", split_fields(&out, &sp));
+
+    ss8_split_init_ch(&sp, &s, ',');
+    ss8_split_limit(&sp, 0);
+    TEST_ASSERT_EXACT_SS8STR("[,,a,,b,c,,]", split_fields(&out, &sp));
+
+    // Skipped empty fields do not count toward the limit, and delimiters
+    // before the remainder are skipped.
+    ss8_split_init_ch(&sp, &s, ',');
+    ss8_split_skip_empty(&sp);
+    ss8_split_limit(&sp, 1);
+    TEST_ASSERT_EXACT_SS8STR("[a][b,c,,]", split_fields(&out, &sp));
+
+    ss8_split_init_ch(&sp, &s, ',');
+    ss8_split_skip_empty(&sp);
+    ss8_split_limit(&sp, 3);
+    TEST_ASSERT_EXACT_SS8STR("[a][b][c]", split_fields(&out, &sp));
+
+    ss8_copy_cstr(&s, "--a----b--");
+    ss8_split_init_cstr(&sp, &s, "--");
+    ss8_split_skip_empty(&sp);
+    ss8_split_limit(&sp, 1);
+    TEST_ASSERT_EXACT_SS8STR("[a][b--]", split_fields(&out, &sp));
+
+    ss8_copy_cstr(&s, ",,");
+    ss8_split_init_ch(&sp, &s, ',');
+    ss8_split_skip_empty(&sp);
+    TEST_ASSERT_EXACT_SS8STR("", split_fields(&out, &sp));
+    ss8_split_init_ch(&sp, &s, ',');
+    ss8_split_skip_empty(&sp);
+    ss8_split_limit(&sp, 0);
+    TEST_ASSERT_EXACT_SS8STR("", split_fields(&out, &sp));
+
+    ss8_destroy(&out);
+    ss8_destroy(&s);
+}
+
+void test_split_long(void) {
+    // Long enough for the vectorized kernels.
+    ss8str s, out, expected;
+    ss8_init(&s);
+    ss8_init(&out);
+    ss8_init(&expected);
+    ss8_charset set;
+    ss8_charset_init_cstr(&set, " \n");
+    for (int i = 0; i < 200; ++i) {
+        ss8_cat_cstr(&s, "field");
+        ss8_cat_ch_n(&s, 'x', (size_t)(i % 37));
+        ss8_cat_ch(&s, i % 3 == 0 ? '\n' : ' ');
+        ss8_cat_cstr(&expected, "[field");
+        ss8_cat_ch_n(&expected, 'x', (size_t)(i % 37));
+        ss8_cat_ch(&expected, ']');
+    }
+    ss8_split sp;
+    ss8_split_init_set(&sp, &s, &set);
+    ss8_cat_cstr(&expected, "[]");
+    TEST_ASSERT_EQUAL_STRING(ss8_cstr(&expected),
+                             ss8_cstr(split_fields(&out, &sp)));
+
+    ss8_destroy(&expected);
+    ss8_destroy(&out);
+    ss8_destroy(&s);
+}
+
+void test_split_into(void) {
+    ss8str s, d;
+    ss8_init_copy_cstr(&s, ",a;;bc,");
+    ss8_init_copy_cstr(&d, ",;");
+    size_t offsets[16];
+
+    TEST_ASSERT_EQUAL_size_t(5, ss8_split_into(&s, 0, &d, offsets, 8));
+    size_t const expected[] = {0, 0, 1, 1, 3, 0, 4, 2, 7, 0};
+    TEST_ASSERT_EQUAL_MEMORY(expected, offsets, sizeof(expected));
+
+    // Fields beyond 'maxfields' are counted but not stored.
+    memset(offsets, 0, sizeof(offsets));
+    TEST_ASSERT_EQUAL_size_t(5, ss8_split_into_cstr(&s, 0, ",;", offsets, 2));
+    TEST_ASSERT_EQUAL_MEMORY(expected, offsets, 4 * sizeof(size_t));
+    TEST_ASSERT_EQUAL_size_t(0, offsets[4]);
+    TEST_ASSERT_EQUAL_size_t(5, ss8_split_into_cstr(&s, 0, ",;", NULL, 0));
+
+    // Resume after the delimiter ending the last stored field.
+    TEST_ASSERT_EQUAL_size_t(3, ss8_split_into_bytes(&s, 3, ",;", 2, offsets,
+                                                     8));
+    TEST_ASSERT_EQUAL_MEMORY(expected + 4, offsets, 6 * sizeof(size_t));
+
+    ss8_charset set;
+    ss8_charset_init_cstr(&set, "");
+    TEST_ASSERT_EQUAL_size_t(1, ss8_split_into_set(&s, 2, &set, offsets, 8));
+    TEST_ASSERT_EQUAL_size_t(2, offsets[0]);
+    TEST_ASSERT_EQUAL_size_t(5, offsets[1]);
+    TEST_ASSERT_EQUAL_size_t(1, ss8_split_into_set(&s, 7, &set, offsets, 8));
+    TEST_ASSERT_EQUAL_size_t(7, offsets[0]);
+    TEST_ASSERT_EQUAL_size_t(0, offsets[1]);
+
+    ss8_clear(&s);
+    TEST_ASSERT_EQUAL_size_t(1, ss8_split_into(&s, 0, &d, offsets, 8));
+    TEST_ASSERT_EQUAL_size_t(0, offsets[0]);
+    TEST_ASSERT_EQUAL_size_t(0, offsets[1]);
+
+    ss8_destroy(&d);
+    ss8_destroy(&s);
+}
+
+void test_split_into_long(void) {
+    // Long enough for the vectorized kernels; compare with ss8_split_next().
+    ss8str s;
+    ss8_init(&s);
+    for (int i = 0; i < 300; ++i) {
+        ss8_cat_ch_n(&s, 'x', (size_t)(i % 41));
+        ss8_cat_ch(&s, i % 5 == 0 ? (char)0x80 : ' ');
+    }
+    ss8_charset set;
+    ss8_charset_init_bytes(&set, " \x80", 2);
+    size_t offsets[2 * 301];
+    TEST_ASSERT_EQUAL_size_t(301,
+                             ss8_split_into_set(&s, 0, &set, offsets, 301));
+    ss8_split sp;
+    ss8_split_init_set(&sp, &s, &set);
+    ss8view field;
+    for (size_t i = 0; i < 301; ++i) {
+        TEST_ASSERT_TRUE(ss8_split_next(&sp, &field));
+        TEST_ASSERT_EQUAL_PTR(field.ptr, ss8_cstr(&s) + offsets[2 * i]);
+        TEST_ASSERT_EQUAL_size_t(field.len, offsets[2 * i + 1]);
+    }
+    TEST_ASSERT_FALSE(ss8_split_next(&sp, &field));
+
+    ss8_destroy(&s);
+}
+
 void test_cat_sprintf(void) {
     ss8str s;
     ss8_init(&s);
@@ -2323,6 +3879,903 @@ void test_cat_sprintf(void) {
     ss8_destroy(&s);
 }
 
+void test_builder(void) {
+    size_t const chunksize = ss8iNtErNaL_builder_chunksize;
+    ss8_builder b;
+    TEST_ASSERT_EQUAL_PTR(&b, ss8_builder_init(&b));
+    ss8str s, expected;
+    ss8_init(&s);
+    ss8_init(&expected);
+
+    TEST_ASSERT_EQUAL_size_t(0, ss8_builder_len(&b));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_builder_chunk_count(&b));
+    TEST_ASSERT_EXACT_SS8STR("", ss8_builder_flatten(&b, &s));
+
+    ss8_copy_cstr(&s, "str");
+    TEST_ASSERT_EQUAL_PTR(&b, ss8_builder_cat(&b, &s));
+    TEST_ASSERT_EQUAL_PTR(&b, ss8_builder_cat_cstr(&b, "cstr"));
+    TEST_ASSERT_EQUAL_PTR(&b, ss8_builder_cat_bytes(&b, "b\0x", 3));
+    TEST_ASSERT_EQUAL_PTR(&b, ss8_builder_cat_ch(&b, 'c'));
+    TEST_ASSERT_EQUAL_PTR(&b, ss8_builder_cat_ch_n(&b, 'n', 2));
+    TEST_ASSERT_EQUAL_size_t(13, ss8_builder_len(&b));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_builder_chunk_count(&b));
+    ss8_builder_flatten(&b, &s);
+    TEST_ASSERT_EQUAL_size_t(13, ss8_len(&s));
+    TEST_ASSERT_EQUAL_MEMORY("strcstrb\0xcnn", ss8_cstr(&s), 14);
+
+    // Appends spanning chunk boundaries.
+    char buf[1000];
+    make_test_string(buf, sizeof(buf));
+    ss8_builder_clear(&b);
+    ss8_clear(&expected);
+    while (ss8_len(&expected) < 3 * chunksize) {
+        ss8_builder_cat_bytes(&b, buf, sizeof(buf));
+        ss8_cat_bytes(&expected, buf, sizeof(buf));
+        ss8_builder_cat_ch_n(&b, 'x', 77);
+        ss8_cat_ch_n(&expected, 'x', 77);
+    }
+    ss8_builder_cat_ch_n(&b, 'y', chunksize + 5);
+    ss8_cat_ch_n(&expected, 'y', chunksize + 5);
+    size_t const len = ss8_len(&expected);
+    TEST_ASSERT_EQUAL_size_t(len, ss8_builder_len(&b));
+    // The first chunk was sized for "str" and kept by clear; chunks double.
+    size_t nchunks = 0;
+    size_t offset = 0;
+    for (size_t size = ss8iNtErNaL_builder_minchunk; offset < len;
+         ++nchunks) {
+        ss8view const chunk = ss8_builder_chunk(&b, nchunks);
+        size_t const clen = len - offset < size ? len - offset : size;
+        TEST_ASSERT_EQUAL_size_t(clen, chunk.len);
+        TEST_ASSERT_EQUAL_MEMORY(ss8_cstr(&expected) + offset, chunk.ptr,
+                                 clen);
+        offset += clen;
+        if (size < chunksize)
+            size *= 2;
+    }
+    TEST_ASSERT_EQUAL_size_t(nchunks, ss8_builder_chunk_count(&b));
+    TEST_ASSERT_TRUE(ss8_equals(&expected, ss8_builder_flatten(&b, &s)));
+
+    FILE *f = tmpfile();
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL_size_t(len, ss8_builder_fwrite(&b, f));
+    rewind(f);
+    ss8_set_len(&s, len);
+    TEST_ASSERT_EQUAL_size_t(len, fread(ss8_mutable_cstr(&s), 1, len, f));
+    TEST_ASSERT_TRUE(ss8_equals(&expected, &s));
+    fclose(f);
+
+    ss8_builder_clear(&b);
+    TEST_ASSERT_EQUAL_size_t(0, ss8_builder_len(&b));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_builder_chunk_count(&b));
+    ss8_builder_cat_cstr(&b, "again");
+    TEST_ASSERT_EXACT_SS8STR("again", ss8_builder_flatten(&b, &s));
+    ss8_builder_destroy(&b);
+
+    // The first chunk fits the first append, up to the maximum chunk size.
+    ss8_builder_init(&b);
+    ss8_builder_cat_bytes(&b, buf, sizeof(buf));
+    ss8_builder_cat_ch_n(&b, 'x', 1024 - sizeof(buf));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_builder_chunk_count(&b));
+    ss8_builder_cat_ch(&b, 'x');
+    TEST_ASSERT_EQUAL_size_t(2, ss8_builder_chunk_count(&b));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_builder_chunk(&b, 1).len);
+    ss8_builder_destroy(&b);
+
+    ss8_builder_init(&b);
+    ss8_builder_cat_ch_n(&b, 'z', 2 * chunksize + 1);
+    TEST_ASSERT_EQUAL_size_t(3, ss8_builder_chunk_count(&b));
+    TEST_ASSERT_EQUAL_size_t(chunksize, ss8_builder_chunk(&b, 0).len);
+    TEST_ASSERT_EQUAL_size_t(1, ss8_builder_chunk(&b, 2).len);
+
+    ss8_destroy(&expected);
+    ss8_destroy(&s);
+    ss8_builder_destroy(&b);
+}
+
+void test_builder_sprintf(void) {
+    size_t const chunksize = ss8iNtErNaL_builder_chunksize;
+    ss8_builder b;
+    ss8_builder_init(&b);
+    ss8str s, expected;
+    ss8_init(&s);
+    ss8_init(&expected);
+
+    TEST_ASSERT_EQUAL_PTR(&b, ss8_builder_cat_sprintf(&b, "%s-%d", "a", 1));
+    TEST_ASSERT_EQUAL_PTR(&b, ss8_builder_cat_sprintf(&b, "%s", ""));
+    TEST_ASSERT_EXACT_SS8STR("a-1", ss8_builder_flatten(&b, &s));
+
+    // Results that do not fit in the last chunk, or in any chunk.
+    ss8_builder_clear(&b);
+    ss8_builder_cat_ch_n(&b, '.', chunksize - 3);
+    ss8_cat_ch_n(&expected, '.', chunksize - 3);
+    ss8_builder_cat_sprintf(&b, "%d", 12345);
+    ss8_cat_sprintf(&expected, "%d", 12345);
+    ss8_builder_cat_sprintf(&b, "%*d", (int)(2 * chunksize), 7);
+    ss8_cat_sprintf(&expected, "%*d", (int)(2 * chunksize), 7);
+    ss8_builder_cat_ch(&b, '!');
+    ss8_cat_ch(&expected, '!');
+    TEST_ASSERT_TRUE(ss8_equals(&expected, ss8_builder_flatten(&b, &s)));
+
+    ss8_destroy(&expected);
+    ss8_destroy(&s);
+    ss8_builder_destroy(&b);
+}
+
+#ifdef SSSTR_USE_ALLOCATORS
+typedef struct {
+    size_t allocs;
+    size_t frees;
+    size_t live_bytes;
+} test_alloc_stats;
+
+static void *test_allocate(void *ctx, size_t size) {
+    test_alloc_stats *stats = (test_alloc_stats *)ctx;
+    ++stats->allocs;
+    stats->live_bytes += size;
+    return malloc(size);
+}
+
+static void *test_reallocate(void *ctx, void *ptr, size_t oldsize,
+                             size_t newsize) {
+    test_alloc_stats *stats = (test_alloc_stats *)ctx;
+    stats->live_bytes += newsize - oldsize;
+    return realloc(ptr, newsize);
+}
+
+static void test_deallocate(void *ctx, void *ptr, size_t size) {
+    test_alloc_stats *stats = (test_alloc_stats *)ctx;
+    ++stats->frees;
+    stats->live_bytes -= size;
+    free(ptr);
+}
+
+void test_init_with_allocator(void) {
+    test_alloc_stats stats = {0, 0, 0};
+    ss8_allocator const alloc = {test_allocate, test_reallocate,
+                                 test_deallocate, &stats};
+    size_t const maxshortlen = ss8iNtErNaL_shortbufsiz - 1;
+
+    ss8str s, t;
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_init_with_allocator(&s, &alloc));
+    TEST_ASSERT_EQUAL_PTR(&alloc, ss8_get_allocator(&s));
+    TEST_ASSERT_EQUAL_size_t(0, stats.allocs);
+    TEST_ASSERT_EXACT_SS8STR("", &s);
+    TEST_ASSERT_EQUAL_size_t(0, ss8_capacity(&s));
+    perturb_unused_bytes(&s);
+
+    // Nothing is allocated until the string needs storage.
+    ss8_copy_cstr(&s, "");
+    ss8_clear(&s);
+    ss8_shrink_to_fit(&s);
+    ss8_reserve(&s, 0);
+    TEST_ASSERT_EQUAL_size_t(0, stats.allocs);
+    ss8_init_with_allocator(&t, &alloc);
+    ss8_swap(&s, &t);
+    ss8_destroy(&t);
+    TEST_ASSERT_EQUAL_size_t(0, stats.allocs);
+    TEST_ASSERT_EQUAL_size_t(0, stats.frees);
+
+    ss8_copy_cstr(&s, "abc");
+    TEST_ASSERT_EXACT_SS8STR("abc", &s);
+    TEST_ASSERT_EQUAL_size_t(1, stats.allocs);
+    TEST_ASSERT_TRUE(ss8_capacity(&s) >= maxshortlen);
+    ss8_copy_ch_n(&s, 'x', 1000);
+    ss8_cat_cstr(&s, "y");
+    TEST_ASSERT_EQUAL_size_t(1001, ss8_len(&s));
+    TEST_ASSERT_EQUAL_size_t(1, stats.allocs);
+    TEST_ASSERT_TRUE(stats.live_bytes > 1001);
+    perturb_unused_bytes(&s);
+    TEST_ASSERT_EQUAL_PTR(&alloc, ss8_get_allocator(&s));
+
+    // Shrinking keeps the allocator, even when the string would fit in short
+    // mode.
+    ss8_copy_cstr(&s, "short");
+    ss8_shrink_to_fit(&s);
+    TEST_ASSERT_EXACT_SS8STR("short", &s);
+    TEST_ASSERT_EQUAL_PTR(&alloc, ss8_get_allocator(&s));
+    TEST_ASSERT_EQUAL_size_t(maxshortlen + 1, ss8_capacity(&s));
+    ss8_copy_ch_n(&s, 'z', 100);
+    TEST_ASSERT_EQUAL_PTR(&alloc, ss8_get_allocator(&s));
+
+    // Shrinking the empty string releases the buffer, but not the allocator.
+    ss8_clear(&s);
+    ss8_shrink_to_fit(&s);
+    TEST_ASSERT_EQUAL_size_t(1, stats.frees);
+    TEST_ASSERT_EQUAL_size_t(0, stats.live_bytes);
+    TEST_ASSERT_EQUAL_PTR(&alloc, ss8_get_allocator(&s));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_capacity(&s));
+    ss8_copy_ch_n(&s, 'z', 100);
+    TEST_ASSERT_EQUAL_size_t(2, stats.allocs);
+
+    // Default strings report no allocator, in either mode.
+    ss8_init(&t);
+    TEST_ASSERT_NULL(ss8_get_allocator(&t));
+    ss8_copy_ch_n(&t, 'd', 100);
+    TEST_ASSERT_NULL(ss8_get_allocator(&t));
+
+    // Copying copies only the contents; moving transfers the buffer.
+    ss8_copy(&t, &s);
+    TEST_ASSERT_NULL(ss8_get_allocator(&t));
+    TEST_ASSERT_TRUE(ss8_equals(&s, &t));
+    ss8_move(&t, &s);
+    TEST_ASSERT_EQUAL_PTR(&alloc, ss8_get_allocator(&t));
+    TEST_ASSERT_NULL(ss8_get_allocator(&s));
+    ss8_move(&t, &s);
+    TEST_ASSERT_EQUAL_size_t(2, stats.frees);
+    TEST_ASSERT_EQUAL_size_t(0, stats.live_bytes);
+
+    ss8_init_with_allocator(&s, &alloc);
+    ss8_copy_ch_n(&s, 'w', 100);
+    ss8_destroy(&s);
+    ss8_destroy(&t);
+    TEST_ASSERT_EQUAL_size_t(3, stats.allocs);
+    TEST_ASSERT_EQUAL_size_t(3, stats.frees);
+    TEST_ASSERT_EQUAL_size_t(0, stats.live_bytes);
+}
+
+void test_move_between_allocators(void) {
+    test_alloc_stats stats1 = {0, 0, 0};
+    test_alloc_stats stats2 = {0, 0, 0};
+    ss8_allocator const alloc1 = {test_allocate, test_reallocate,
+                                  test_deallocate, &stats1};
+    ss8_allocator const alloc2 = {test_allocate, test_reallocate,
+                                  test_deallocate, &stats2};
+
+    // The destination's buffer goes back to its own allocator, and the
+    // destination takes on the source's allocator along with its buffer.
+    ss8str s, t;
+    ss8_init_with_allocator(&s, &alloc1);
+    ss8_init_with_allocator(&t, &alloc2);
+    ss8_copy_ch_n(&s, 's', 100);
+    ss8_copy_ch_n(&t, 't', 200);
+    ss8_move(&s, &t);
+    TEST_ASSERT_EQUAL_PTR(&alloc2, ss8_get_allocator(&s));
+    TEST_ASSERT_EQUAL_size_t(200, ss8_len(&s));
+    TEST_ASSERT_EQUAL_CHAR('t', ss8_back(&s));
+    TEST_ASSERT_EQUAL_size_t(1, stats1.frees);
+    TEST_ASSERT_EQUAL_size_t(0, stats1.live_bytes);
+    TEST_ASSERT_EQUAL_size_t(0, stats2.frees);
+
+    // The moved-from string is left with the default allocator.
+    TEST_ASSERT_NULL(ss8_get_allocator(&t));
+    ss8_cat_ch_n(&s, 'u', 1000);
+    TEST_ASSERT_EQUAL_size_t(1, stats2.allocs);
+    ss8_destroy(&t);
+    ss8_destroy(&s);
+    TEST_ASSERT_EQUAL_size_t(1, stats2.frees);
+    TEST_ASSERT_EQUAL_size_t(0, stats2.live_bytes);
+
+    // Likewise for a source that has not yet allocated.
+    ss8_init_with_allocator(&s, &alloc1);
+    ss8_init_with_allocator(&t, &alloc2);
+    ss8_copy_ch_n(&s, 's', 100);
+    ss8_move(&s, &t);
+    TEST_ASSERT_EQUAL_PTR(&alloc2, ss8_get_allocator(&s));
+    TEST_ASSERT_EXACT_SS8STR("", &s);
+    ss8_copy_cstr(&s, "abc");
+    TEST_ASSERT_EQUAL_size_t(2, stats1.allocs);
+    TEST_ASSERT_EQUAL_size_t(2, stats1.frees);
+    TEST_ASSERT_EQUAL_size_t(2, stats2.allocs);
+    ss8_destroy(&t);
+    ss8_destroy(&s);
+    TEST_ASSERT_EQUAL_size_t(2, stats2.frees);
+    TEST_ASSERT_EQUAL_size_t(0, stats2.live_bytes);
+}
+#endif
+
+void test_buffer_cache(void) {
+    ss8str s;
+    ss8_init_copy_ch_n(&s, 'a', 100);
+    char const *buf = ss8_cstr(&s);
+    ss8_destroy(&s);
+
+    // A buffer of a nearby size is taken from the same size class.
+    ss8_init_copy_ch_n(&s, 'b', 120);
+#ifdef SSSTR_USE_BUFFER_CACHE
+    TEST_ASSERT_EQUAL_PTR(buf, ss8_cstr(&s));
+    // The capacity covers the whole size class.
+    TEST_ASSERT_EQUAL_size_t(127, ss8_capacity(&s));
+#else
+    (void)buf;
+#endif
+    TEST_ASSERT_ALLOCATED_size_t(120, ss8_capacity(&s));
+
+    // Growing within the size class keeps the buffer.
+    buf = ss8_cstr(&s);
+    ss8_reserve(&s, 127);
+#ifdef SSSTR_USE_BUFFER_CACHE
+    TEST_ASSERT_EQUAL_PTR(buf, ss8_cstr(&s));
+#endif
+    TEST_ASSERT_ALLOCATED_size_t(127, ss8_capacity(&s));
+    ss8_cat_ch_n(&s, 'c', 7);
+
+    // Growing into a larger class, and beyond the largest, keeps the data.
+    ss8_cat_ch_n(&s, 'd', 200);
+    ss8_cat_ch_n(&s, 'e', 1000);
+    TEST_ASSERT_EQUAL_size_t(1327, ss8_len(&s));
+    TEST_ASSERT_EQUAL_CHAR('b', ss8_at(&s, 119));
+    TEST_ASSERT_EQUAL_CHAR('c', ss8_at(&s, 126));
+    TEST_ASSERT_EQUAL_CHAR('d', ss8_at(&s, 326));
+    TEST_ASSERT_EQUAL_CHAR('e', ss8_at(&s, 1326));
+
+    // Shrinking back into the cached range.
+    ss8_set_len(&s, 300);
+    ss8_shrink_to_fit(&s);
+    TEST_ASSERT_EQUAL_size_t(300, ss8_len(&s));
+    TEST_ASSERT_EQUAL_CHAR('d', ss8_at(&s, 299));
+    ss8_set_len(&s, 3);
+    ss8_shrink_to_fit(&s);
+    TEST_ASSERT_EQUAL_STRING("bbb", ss8_cstr(&s));
+    ss8_destroy(&s);
+
+    // Freed buffers stay in this thread's cache (and would be leaked if the
+    // thread exited) until the cache is flushed.
+#ifdef SSSTR_USE_BUFFER_CACHE
+    ss8iNtErNaL_bufcache const *cache = &ss8iNtErNaL_the_bufcache;
+    size_t ncached = 0;
+    for (size_t i = 0; i < ss8iNtErNaL_bufcache_nclasses; ++i)
+        ncached += cache->iNtErNaL_counts[i];
+    TEST_ASSERT_TRUE(ncached > 0);
+#endif
+    ss8_flush_buffer_cache();
+#ifdef SSSTR_USE_BUFFER_CACHE
+    for (size_t i = 0; i < ss8iNtErNaL_bufcache_nclasses; ++i) {
+        TEST_ASSERT_NULL(cache->iNtErNaL_heads[i]);
+        TEST_ASSERT_EQUAL_size_t(0, cache->iNtErNaL_counts[i]);
+    }
+#endif
+    ss8_flush_buffer_cache();
+}
+
+void test_usable_size(void) {
+    ss8str s;
+    ss8_init(&s);
+    ss8_reserve(&s, 1000);
+    size_t const cap = ss8_capacity(&s);
+    TEST_ASSERT_ALLOCATED_size_t(1000, cap);
+#ifdef SSSTR_MALLOC_USABLE_SIZE
+    // The capacity covers the whole block.
+    TEST_ASSERT_EQUAL_size_t(SSSTR_MALLOC_USABLE_SIZE(s.iNtErNaL_L.ptr),
+                             cap + 1);
+#endif
+
+    // Filling the capacity does not reallocate.
+    char const *buf = ss8_cstr(&s);
+    ss8_cat_ch_n(&s, '+', cap);
+    TEST_ASSERT_EQUAL_PTR(buf, ss8_cstr(&s));
+    TEST_ASSERT_EQUAL_size_t(cap, ss8_capacity(&s));
+
+    // Shrinking still gives the exact length.
+    ss8_set_len(&s, 900);
+    ss8_shrink_to_fit(&s);
+    TEST_ASSERT_EQUAL_size_t(900, ss8_capacity(&s));
+    ss8_destroy(&s);
+}
+
+#ifdef SSSTR_USE_ALLOCATORS
+void test_arena(void) {
+    ss8_arena a;
+    TEST_ASSERT_EQUAL_PTR(&a, ss8_arena_init(&a));
+    TEST_ASSERT_EQUAL_PTR(&a, ss8_arena_clear(&a));
+
+    ss8str s;
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_init_in_arena(&s, &a));
+    TEST_ASSERT_EQUAL_PTR(ss8_arena_allocator(&a), ss8_get_allocator(&s));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_len(&s));
+
+    // The last allocation grows and shrinks in place.
+    ss8_copy_ch_n(&s, 'a', 1000);
+    char const *buf = ss8_cstr(&s);
+    ss8_cat_ch_n(&s, 'b', 1000);
+    TEST_ASSERT_EQUAL_PTR(buf, ss8_cstr(&s));
+    ss8_set_len(&s, 10);
+    ss8_shrink_to_fit(&s);
+    TEST_ASSERT_EQUAL_PTR(buf, ss8_cstr(&s));
+    TEST_ASSERT_EQUAL_STRING("aaaaaaaaaa", ss8_cstr(&s));
+
+    // Otherwise growth moves the string.
+    ss8str t;
+    ss8_init_in_arena(&t, &a);
+    ss8_copy_cstr(&t, "t");
+    ss8_cat_ch_n(&s, 'c', 100);
+    TEST_ASSERT_TRUE(buf != ss8_cstr(&s));
+    TEST_ASSERT_EQUAL_size_t(110, ss8_len(&s));
+    TEST_ASSERT_EQUAL_CHAR('a', ss8_at(&s, 9));
+    TEST_ASSERT_EQUAL_CHAR('c', ss8_at(&s, 109));
+    TEST_ASSERT_EQUAL_STRING("t", ss8_cstr(&t));
+
+    // Destroying the last allocation makes room for the next.
+    buf = ss8_cstr(&s);
+    ss8_destroy(&s);
+    ss8_init_in_arena(&s, &a);
+    ss8_copy_cstr(&s, "next");
+    TEST_ASSERT_EQUAL_PTR(buf, ss8_cstr(&s));
+
+    // Strings larger than a chunk, and many strings spanning chunks.
+    ss8_copy_ch_n(&s, 'x', 100000);
+    ss8str many[100];
+    for (size_t i = 0; i < 100; ++i) {
+        ss8_init_in_arena(&many[i], &a);
+        ss8_copy_ch_n(&many[i], (char)('0' + i % 10), 100 + i);
+    }
+    for (size_t i = 0; i < 100; ++i) {
+        TEST_ASSERT_EQUAL_size_t(100 + i, ss8_len(&many[i]));
+        TEST_ASSERT_EQUAL_CHAR((char)('0' + i % 10), ss8_back(&many[i]));
+    }
+    TEST_ASSERT_EQUAL_size_t(100000, ss8_len(&s));
+    TEST_ASSERT_EQUAL_STRING("t", ss8_cstr(&t));
+
+    // Moving to and from arena strings carries the allocator.
+    ss8str u;
+    ss8_init_copy_cstr(&u, "heap");
+    ss8_move(&t, &u);
+    TEST_ASSERT_NULL(ss8_get_allocator(&t));
+    ss8_destroy(&t);
+    ss8_destroy(&u);
+
+    // Release everything without destroying the strings.
+    ss8_arena_clear(&a);
+    ss8_init_in_arena(&s, &a);
+    ss8_copy_cstr(&s, "reused");
+    TEST_ASSERT_EQUAL_STRING("reused", ss8_cstr(&s));
+    ss8_arena_destroy(&a);
+}
+#endif
+
+void test_rope(void) {
+    ss8_rope r;
+    TEST_ASSERT_EQUAL_PTR(&r, ss8_rope_init(&r));
+    ss8str s;
+    ss8_init(&s);
+
+    TEST_ASSERT_EQUAL_size_t(0, ss8_rope_len(&r));
+    TEST_ASSERT_EXACT_SS8STR("", ss8_rope_flatten(&r, &s));
+
+    TEST_ASSERT_EQUAL_PTR(&r, ss8_rope_copy_cstr(&r, "hello"));
+    TEST_ASSERT_EQUAL_PTR(&r, ss8_rope_insert_cstr(&r, 5, " world"));
+    TEST_ASSERT_EQUAL_PTR(&r, ss8_rope_insert_bytes(&r, 0, "\0", 1));
+    ss8_copy_cstr(&s, ",");
+    TEST_ASSERT_EQUAL_PTR(&r, ss8_rope_insert(&r, 6, &s));
+    TEST_ASSERT_EQUAL_size_t(13, ss8_rope_len(&r));
+    ss8_rope_flatten(&r, &s);
+    TEST_ASSERT_EQUAL_size_t(13, ss8_len(&s));
+    TEST_ASSERT_EQUAL_MEMORY("\0hello, world", ss8_cstr(&s), 14);
+    TEST_ASSERT_EQUAL_CHAR('\0', ss8_rope_at(&r, 0));
+    TEST_ASSERT_EQUAL_CHAR('w', ss8_rope_at(&r, 8));
+
+    TEST_ASSERT_EQUAL_PTR(&r, ss8_rope_erase(&r, 0, 1));
+    TEST_ASSERT_EQUAL_PTR(&r, ss8_rope_erase(&r, 5, 100));
+    TEST_ASSERT_EQUAL_PTR(&r, ss8_rope_erase(&r, 5, 0));
+    TEST_ASSERT_EXACT_SS8STR("hello", ss8_rope_flatten(&r, &s));
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_rope_copy_substr(&s, &r, 1, 3));
+    TEST_ASSERT_EXACT_SS8STR("ell", &s);
+    TEST_ASSERT_EXACT_SS8STR("lo", ss8_rope_copy_substr(&s, &r, 3, 100));
+    TEST_ASSERT_EXACT_SS8STR("", ss8_rope_copy_substr(&s, &r, 5, 1));
+
+    ss8_copy_cstr(&s, "abc");
+    ss8_rope_copy(&r, &s);
+    ss8_rope_cursor cur;
+    TEST_ASSERT_EQUAL_PTR(&cur, ss8_rope_cursor_init(&cur, &r, 1));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_rope_cursor_pos(&cur));
+    TEST_ASSERT_EQUAL_INT('b', ss8_rope_cursor_next(&cur));
+    TEST_ASSERT_EQUAL_INT('c', ss8_rope_cursor_next(&cur));
+    TEST_ASSERT_EQUAL_INT(EOF, ss8_rope_cursor_next(&cur));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_rope_cursor_pos(&cur));
+
+    TEST_ASSERT_EQUAL_PTR(&r, ss8_rope_clear(&r));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_rope_len(&r));
+    ss8view chunk;
+    ss8_rope_cursor_init(&cur, &r, 0);
+    TEST_ASSERT_FALSE(ss8_rope_cursor_next_chunk(&cur, &chunk));
+
+    ss8_destroy(&s);
+    ss8_rope_destroy(&r);
+}
+
+// Return the number of pieces in *rope.
+static size_t rope_piece_count(ss8_rope const *rope) {
+    ss8_rope_cursor cur;
+    ss8_rope_cursor_init(&cur, rope, 0);
+    ss8view chunk;
+    size_t count = 0;
+    while (ss8_rope_cursor_next_chunk(&cur, &chunk))
+        ++count;
+    return count;
+}
+
+void test_rope_erase_joins_pieces(void) {
+    size_t const maxpiece = ss8iNtErNaL_rope_maxpiece;
+    char buf[4 * ss8iNtErNaL_rope_maxpiece];
+    make_test_string(buf, sizeof(buf));
+    ss8_rope r;
+    ss8_rope_init(&r);
+    ss8_rope_copy_bytes(&r, buf, sizeof(buf));
+    size_t len = sizeof(buf);
+    ss8str s;
+    ss8_init(&s);
+    TEST_ASSERT_EQUAL_size_t(4, rope_piece_count(&r));
+
+    // Within a piece: the shrunken piece is too big to join a full neighbor.
+    ss8_rope_erase(&r, 10, maxpiece - 20);
+    memmove(buf + 10, buf + maxpiece - 10, len - (maxpiece - 10));
+    len -= maxpiece - 20;
+    TEST_ASSERT_EQUAL_size_t(4, rope_piece_count(&r));
+    // Within the next piece: now the two small pieces are joined.
+    ss8_rope_erase(&r, 30, maxpiece - 20);
+    memmove(buf + 30, buf + maxpiece + 10, len - (maxpiece + 10));
+    len -= maxpiece - 20;
+    TEST_ASSERT_EQUAL_size_t(3, rope_piece_count(&r));
+    ss8_rope_flatten(&r, &s);
+    TEST_ASSERT_EQUAL_size_t(len, ss8_len(&s));
+    TEST_ASSERT_EQUAL_MEMORY(buf, ss8_cstr(&s), len);
+
+    // Across pieces: the remnants are joined to each other and to the first.
+    ss8_rope_erase(&r, 45, 2 * maxpiece - 10);
+    memmove(buf + 45, buf + 2 * maxpiece + 35, len - (2 * maxpiece + 35));
+    len -= 2 * maxpiece - 10;
+    TEST_ASSERT_EQUAL_size_t(1, rope_piece_count(&r));
+    ss8_rope_flatten(&r, &s);
+    TEST_ASSERT_EQUAL_size_t(len, ss8_len(&s));
+    TEST_ASSERT_EQUAL_MEMORY(buf, ss8_cstr(&s), len);
+
+    ss8_destroy(&s);
+    ss8_rope_destroy(&r);
+}
+
+void test_rope_random_edits(void) {
+    // Compare against the same edits applied to an ss8str.
+    char buf[3000];
+    make_test_string(buf, sizeof(buf));
+    ss8_rope r;
+    ss8_rope_init(&r);
+    ss8str expected, s;
+    ss8_init(&expected);
+    ss8_init(&s);
+
+    uint32_t rng = 12345;
+    for (int i = 0; i < 2000; ++i) {
+        rng = rng * 1103515245u + 12345u;
+        size_t const pos = (rng >> 8) % (ss8_len(&expected) + 1);
+        rng = rng * 1103515245u + 12345u;
+        size_t const n = (rng >> 8) % (i % 10 == 0 ? sizeof(buf) : 20);
+        if (i % 3 == 2) {
+            ss8_rope_erase(&r, pos, n);
+            ss8_erase(&expected, pos, n);
+        } else {
+            ss8_rope_insert_bytes(&r, pos, buf, n);
+            ss8_insert_bytes(&expected, pos, buf, n);
+        }
+        TEST_ASSERT_EQUAL_size_t(ss8_len(&expected), ss8_rope_len(&r));
+    }
+    size_t const len = ss8_len(&expected);
+    TEST_ASSERT_TRUE(len > 10000);
+    TEST_ASSERT_TRUE(ss8_equals(&expected, ss8_rope_flatten(&r, &s)));
+
+    for (size_t i = 0; i < len; i += 97)
+        TEST_ASSERT_EQUAL_CHAR(ss8_at(&expected, i), ss8_rope_at(&r, i));
+
+    ss8str sub;
+    ss8_init(&sub);
+    for (size_t start = 0; start < len; start += 1999) {
+        ss8_copy_substr(&sub, &expected, start, 5000);
+        ss8_rope_copy_substr(&s, &r, start, 5000);
+        TEST_ASSERT_TRUE(ss8_equals(&sub, &s));
+    }
+    ss8_destroy(&sub);
+
+    // Iterate by chunk and by byte from the middle.
+    ss8_rope_cursor cur;
+    ss8_rope_cursor_init(&cur, &r, len / 2);
+    ss8view chunk;
+    ss8_clear(&s);
+    while (ss8_rope_cursor_next_chunk(&cur, &chunk)) {
+        TEST_ASSERT_TRUE(chunk.len > 0);
+        ss8_cat_view(&s, chunk);
+    }
+    TEST_ASSERT_EQUAL_size_t(len, ss8_rope_cursor_pos(&cur));
+    TEST_ASSERT_EQUAL_size_t(len - len / 2, ss8_len(&s));
+    TEST_ASSERT_EQUAL_MEMORY(ss8_cstr(&expected) + len / 2, ss8_cstr(&s),
+                             ss8_len(&s));
+    ss8_rope_cursor_init(&cur, &r, len / 2);
+    for (size_t i = len / 2; i < len; ++i) {
+        TEST_ASSERT_EQUAL_INT((unsigned char)ss8_at(&expected, i),
+                              ss8_rope_cursor_next(&cur));
+    }
+    TEST_ASSERT_EQUAL_INT(EOF, ss8_rope_cursor_next(&cur));
+
+    ss8_destroy(&s);
+    ss8_destroy(&expected);
+    ss8_rope_destroy(&r);
+}
+
+void test_gapbuf(void) {
+    ss8_gapbuf gb;
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_init(&gb));
+    ss8str s;
+    ss8_init(&s);
+
+    TEST_ASSERT_EQUAL_size_t(0, ss8_gapbuf_len(&gb));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_gapbuf_cursor(&gb));
+    TEST_ASSERT_EXACT_SS8STR("", ss8_gapbuf_flatten(&gb, &s));
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_set_cursor(&gb, 0));
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_erase_before(&gb, 1));
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_erase_after(&gb, 1));
+
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_copy_cstr(&gb, "helo"));
+    TEST_ASSERT_EQUAL_size_t(4, ss8_gapbuf_cursor(&gb));
+    ss8_gapbuf_set_cursor(&gb, 2);
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_insert_ch(&gb, 'l'));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_gapbuf_cursor(&gb));
+    ss8_gapbuf_set_cursor(&gb, 5);
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_insert_cstr(&gb, " world"));
+    ss8_gapbuf_set_cursor(&gb, 0);
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_insert_bytes(&gb, "\0", 1));
+    ss8_copy_cstr(&s, ",");
+    ss8_gapbuf_set_cursor(&gb, 6);
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_insert(&gb, &s));
+    TEST_ASSERT_EQUAL_size_t(13, ss8_gapbuf_len(&gb));
+    ss8_gapbuf_flatten(&gb, &s);
+    TEST_ASSERT_EQUAL_size_t(13, ss8_len(&s));
+    TEST_ASSERT_EQUAL_MEMORY("\0hello, world", ss8_cstr(&s), 14);
+    TEST_ASSERT_EQUAL_CHAR('\0', ss8_gapbuf_at(&gb, 0));
+    TEST_ASSERT_EQUAL_CHAR('o', ss8_gapbuf_at(&gb, 5));
+    TEST_ASSERT_EQUAL_CHAR(',', ss8_gapbuf_at(&gb, 6));
+    TEST_ASSERT_EQUAL_CHAR('d', ss8_gapbuf_at(&gb, 12));
+
+    ss8_gapbuf_set_cursor(&gb, 1);
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_erase_before(&gb, 5));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_gapbuf_cursor(&gb));
+    ss8_gapbuf_set_cursor(&gb, 7);
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_erase_after(&gb, 100));
+    ss8_gapbuf_set_cursor(&gb, 6);
+    ss8_gapbuf_erase_before(&gb, 1);
+    ss8_gapbuf_erase_after(&gb, 1);
+    TEST_ASSERT_EXACT_SS8STR("hello", ss8_gapbuf_flatten(&gb, &s));
+
+    ss8_copy_cstr(&s, "abc");
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_copy(&gb, &s));
+    TEST_ASSERT_EXACT_SS8STR("abc", ss8_gapbuf_flatten(&gb, &s));
+    TEST_ASSERT_EQUAL_PTR(&gb, ss8_gapbuf_clear(&gb));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_gapbuf_len(&gb));
+
+    ss8_destroy(&s);
+    ss8_gapbuf_destroy(&gb);
+}
+
+void test_gapbuf_random_edits(void) {
+    // Compare against the same edits applied to an ss8str.
+    char buf[300];
+    make_test_string(buf, sizeof(buf));
+    ss8_gapbuf gb;
+    ss8_gapbuf_init(&gb);
+    ss8str expected, s;
+    ss8_init(&expected);
+    ss8_init(&s);
+
+    size_t cursor = 0;
+    uint32_t rng = 12345;
+    for (int i = 0; i < 3000; ++i) {
+        rng = rng * 1103515245u + 12345u;
+        uint32_t const r = rng >> 8;
+        size_t const n = r % (i % 20 == 0 ? sizeof(buf) : 5);
+        switch (i % 8) {
+        case 0: // Jump
+            cursor = r % (ss8_len(&expected) + 1);
+            ss8_gapbuf_set_cursor(&gb, cursor);
+            break;
+        case 1: // Backspace
+            if (cursor < n) {
+                ss8_erase(&expected, 0, cursor);
+                cursor = 0;
+            } else {
+                cursor -= n;
+                ss8_erase(&expected, cursor, n);
+            }
+            ss8_gapbuf_erase_before(&gb, n);
+            break;
+        case 2: // Delete
+            ss8_erase(&expected, cursor, n);
+            ss8_gapbuf_erase_after(&gb, n);
+            break;
+        case 3: // Type
+            ss8_insert_ch(&expected, cursor++, buf[n]);
+            ss8_gapbuf_insert_ch(&gb, buf[n]);
+            break;
+        default: // Paste
+            ss8_insert_bytes(&expected, cursor, buf, n);
+            cursor += n;
+            ss8_gapbuf_insert_bytes(&gb, buf, n);
+            break;
+        }
+        TEST_ASSERT_EQUAL_size_t(cursor, ss8_gapbuf_cursor(&gb));
+        TEST_ASSERT_EQUAL_size_t(ss8_len(&expected), ss8_gapbuf_len(&gb));
+    }
+    size_t const len = ss8_len(&expected);
+    TEST_ASSERT_TRUE(len > 1000);
+    TEST_ASSERT_TRUE(ss8_equals(&expected, ss8_gapbuf_flatten(&gb, &s)));
+    for (size_t i = 0; i < len; ++i)
+        TEST_ASSERT_EQUAL_CHAR(ss8_at(&expected, i), ss8_gapbuf_at(&gb, i));
+
+    ss8_destroy(&s);
+    ss8_destroy(&expected);
+    ss8_gapbuf_destroy(&gb);
+}
+
+void test_streambuf(void) {
+    ss8_streambuf sb;
+    TEST_ASSERT_EQUAL_PTR(&sb, ss8_streambuf_init(&sb));
+    ss8str s;
+    ss8_init(&s);
+
+    TEST_ASSERT_EQUAL_size_t(0, ss8_streambuf_len(&sb));
+    TEST_ASSERT_VIEW("", ss8_streambuf_peek(&sb));
+    TEST_ASSERT_EQUAL_PTR(&sb, ss8_streambuf_consume(&sb, 1));
+
+    ss8_copy_cstr(&s, "abc");
+    TEST_ASSERT_EQUAL_PTR(&sb, ss8_streambuf_append(&sb, &s));
+    TEST_ASSERT_EQUAL_PTR(&sb, ss8_streambuf_append_cstr(&sb, "def"));
+    TEST_ASSERT_EQUAL_PTR(&sb, ss8_streambuf_append_bytes(&sb, "g\0", 2));
+    TEST_ASSERT_EQUAL_size_t(8, ss8_streambuf_len(&sb));
+    ss8view v = ss8_streambuf_peek(&sb);
+    TEST_ASSERT_EQUAL_size_t(8, v.len);
+    TEST_ASSERT_EQUAL_MEMORY("abcdefg\0", v.ptr, 8);
+
+    TEST_ASSERT_EQUAL_PTR(&sb, ss8_streambuf_consume(&sb, 2));
+    TEST_ASSERT_EQUAL_size_t(6, ss8_streambuf_len(&sb));
+    v = ss8_streambuf_peek(&sb);
+    TEST_ASSERT_EQUAL_MEMORY("cdefg\0", v.ptr, 6);
+    ss8_streambuf_consume(&sb, 0);
+    ss8_streambuf_append_cstr(&sb, "h");
+    ss8_streambuf_consume(&sb, 5);
+    v = ss8_streambuf_peek(&sb);
+    TEST_ASSERT_EQUAL_MEMORY("\0h", v.ptr, 2);
+    ss8_streambuf_consume(&sb, 100);
+    TEST_ASSERT_VIEW("", ss8_streambuf_peek(&sb));
+    ss8_streambuf_append_cstr(&sb, "x");
+    TEST_ASSERT_VIEW("x", ss8_streambuf_peek(&sb));
+    TEST_ASSERT_EQUAL_PTR(&sb, ss8_streambuf_clear(&sb));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_streambuf_len(&sb));
+
+    ss8_destroy(&s);
+    ss8_streambuf_destroy(&sb);
+}
+
+void test_streambuf_stream(void) {
+    // Consume newline-terminated messages from input that arrives in chunks
+    // not aligned to the messages, and check that the buffer stays bounded.
+    ss8_streambuf sb;
+    ss8_streambuf_init(&sb);
+    ss8str input, output;
+    ss8_init(&input);
+    ss8_init(&output);
+    for (int i = 0; i < 20000; ++i)
+        ss8_cat_sprintf(&input, "message %d\n", i);
+
+    size_t maxcap = 0;
+    size_t const inlen = ss8_len(&input);
+    for (size_t pos = 0; pos < inlen; pos += 37) {
+        ss8_streambuf_append_bytes(&sb, ss8_cstr(&input) + pos,
+                                   inlen - pos < 37 ? inlen - pos : 37);
+        for (;;) {
+            ss8view const v = ss8_streambuf_peek(&sb);
+            size_t const nl = ss8_view_find_ch(v, 0, '\n');
+            if (nl == SIZE_MAX)
+                break;
+            ss8_cat_view(&output, ss8_view_slice(v, 0, nl + 1));
+            ss8_streambuf_consume(&sb, nl + 1);
+        }
+        if (ss8_capacity(&sb.iNtErNaL_buf) > maxcap)
+            maxcap = ss8_capacity(&sb.iNtErNaL_buf);
+    }
+    TEST_ASSERT_EQUAL_size_t(0, ss8_streambuf_len(&sb));
+    TEST_ASSERT_TRUE(ss8_equals(&input, &output));
+    TEST_ASSERT_TRUE(maxcap <= 4 * ss8iNtErNaL_streambuf_minwaste);
+
+    ss8_destroy(&output);
+    ss8_destroy(&input);
+    ss8_streambuf_destroy(&sb);
+}
+
+void test_ring(void) {
+    ss8_ring ring;
+    TEST_ASSERT_EQUAL_PTR(&ring, ss8_ring_init(&ring, 8));
+    ss8str s;
+    ss8_init(&s);
+    ss8view rspans[2];
+    ss8_ring_span wspans[2];
+
+    TEST_ASSERT_EQUAL_size_t(0, ss8_ring_len(&ring));
+    TEST_ASSERT_EQUAL_size_t(8, ss8_ring_capacity(&ring));
+    TEST_ASSERT_EQUAL_size_t(8, ss8_ring_space(&ring));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_ring_read_spans(&ring, rspans));
+    TEST_ASSERT_EQUAL_size_t(1, ss8_ring_write_spans(&ring, wspans));
+    TEST_ASSERT_EQUAL_size_t(8, wspans[0].len);
+    TEST_ASSERT_EQUAL_size_t(0, wspans[1].len);
+
+    TEST_ASSERT_EQUAL_size_t(3, ss8_ring_push_cstr(&ring, "abc"));
+    ss8_copy_cstr(&s, "de");
+    TEST_ASSERT_EQUAL_size_t(2, ss8_ring_push(&ring, &s));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_ring_push_bytes(&ring, "fghij", 5));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_ring_push_bytes(&ring, "x", 1));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_ring_space(&ring));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_ring_write_spans(&ring, wspans));
+    TEST_ASSERT_EXACT_SS8STR("abcdefgh", ss8_ring_flatten(&ring, &s));
+
+    char buf[8];
+    TEST_ASSERT_EQUAL_size_t(2, ss8_ring_pop_bytes(&ring, buf, 2));
+    TEST_ASSERT_EQUAL_MEMORY("ab", buf, 2);
+    TEST_ASSERT_EQUAL_PTR(&ring, ss8_ring_consume(&ring, 3));
+    TEST_ASSERT_EQUAL_size_t(3, ss8_ring_len(&ring));
+
+    // Wrap around.
+    TEST_ASSERT_EQUAL_size_t(1, ss8_ring_write_spans(&ring, wspans));
+    TEST_ASSERT_EQUAL_size_t(5, wspans[0].len);
+    memcpy(wspans[0].ptr, "12345", 5);
+    TEST_ASSERT_EQUAL_PTR(&ring, ss8_ring_commit(&ring, 5));
+    TEST_ASSERT_EQUAL_size_t(2, ss8_ring_read_spans(&ring, rspans));
+    TEST_ASSERT_VIEW("fgh", rspans[0]);
+    TEST_ASSERT_VIEW("12345", rspans[1]);
+    TEST_ASSERT_EXACT_SS8STR("fgh12345", ss8_ring_flatten(&ring, &s));
+    TEST_ASSERT_EQUAL_PTR(&s, ss8_ring_pop(&ring, &s, 4));
+    TEST_ASSERT_EXACT_SS8STR("fgh1", &s);
+    TEST_ASSERT_EQUAL_size_t(1, ss8_ring_read_spans(&ring, rspans));
+    TEST_ASSERT_VIEW("2345", rspans[0]);
+    TEST_ASSERT_EQUAL_size_t(2, ss8_ring_write_spans(&ring, wspans));
+    TEST_ASSERT_EQUAL_size_t(3, wspans[0].len);
+    TEST_ASSERT_EQUAL_size_t(1, wspans[1].len);
+    memcpy(wspans[0].ptr, "678", 3);
+    memcpy(wspans[1].ptr, "9", 1);
+    ss8_ring_commit(&ring, 4);
+    TEST_ASSERT_EXACT_SS8STR("23456789", ss8_ring_flatten(&ring, &s));
+    TEST_ASSERT_EXACT_SS8STR("23456789", ss8_ring_pop(&ring, &s, 100));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_ring_len(&ring));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_ring_pop_bytes(&ring, buf, 1));
+
+    // Emptying rewinds, so that the free space is contiguous.
+    TEST_ASSERT_EQUAL_size_t(1, ss8_ring_write_spans(&ring, wspans));
+    TEST_ASSERT_EQUAL_size_t(8, wspans[0].len);
+    ss8_ring_push_cstr(&ring, "x");
+    TEST_ASSERT_EQUAL_PTR(&ring, ss8_ring_clear(&ring));
+    TEST_ASSERT_EQUAL_size_t(0, ss8_ring_len(&ring));
+
+    ss8_destroy(&s);
+    ss8_ring_destroy(&ring);
+}
+
+void test_ring_stream(void) {
+    // Pass data through a small ring in chunks of varying size.
+    char buf[3000];
+    make_test_string(buf, sizeof(buf));
+    ss8_ring ring;
+    ss8_ring_init(&ring, 97);
+    ss8str out, piece;
+    ss8_init(&out);
+    ss8_init(&piece);
+
+    size_t in = 0;
+    uint32_t rng = 1;
+    while (ss8_len(&out) < sizeof(buf)) {
+        rng = rng * 1103515245u + 12345u;
+        size_t const n = (rng >> 8) % 150;
+        if (rng & 0x10000) {
+            size_t const want = n < sizeof(buf) - in ? n : sizeof(buf) - in;
+            size_t const space = ss8_ring_space(&ring);
+            size_t const pushed = ss8_ring_push_bytes(&ring, buf + in, want);
+            TEST_ASSERT_EQUAL_size_t(want < space ? want : space, pushed);
+            in += pushed;
+        } else {
+            ss8_ring_pop(&ring, &piece, n);
+            ss8_cat(&out, &piece);
+        }
+        TEST_ASSERT_EQUAL_size_t(in - ss8_len(&out), ss8_ring_len(&ring));
+    }
+    TEST_ASSERT_EQUAL_MEMORY(buf, ss8_cstr(&out), sizeof(buf));
+
+    ss8_destroy(&piece);
+    ss8_destroy(&out);
+    ss8_ring_destroy(&ring);
+}
+
 int main(void) {
     UNITY_BEGIN();
     RUN_TEST(test_size);
@@ -2338,7 +4791,10 @@ int main(void) {
     RUN_TEST(test_set_len);
     RUN_TEST(test_set_len_to_cstrlen);
     RUN_TEST(test_three_halves);
+    RUN_TEST(test_growcap_policy);
     RUN_TEST(test_grow_len);
+    RUN_TEST(test_growth_policy);
+    RUN_TEST(test_no_buffer_is_per_string);
     RUN_TEST(test_shrink_to_fit_short_to_short);
     RUN_TEST(test_shrink_to_fit_long_to_short);
     RUN_TEST(test_shrink_to_fit_long_to_long);
@@ -2375,17 +4831,40 @@ int main(void) {
     RUN_TEST(test_equals);
     RUN_TEST(test_equals_ch);
     RUN_TEST(test_find_bytes);
+#if defined(SSSTR_USE_SSSE3) || defined(SSSTR_USE_AVX2)
+    RUN_TEST(test_simd_tier);
+#endif
+    RUN_TEST(test_find_bytes_long);
+    RUN_TEST(test_twoway);
+    RUN_TEST(test_find_bytes_worst_case);
     RUN_TEST(test_find);
     RUN_TEST(test_find_ch);
     RUN_TEST(test_find_not_ch);
     RUN_TEST(test_rfind_bytes);
+    RUN_TEST(test_rfind_bytes_long);
+    RUN_TEST(test_rtwoway);
+    RUN_TEST(test_rfind_bytes_worst_case);
     RUN_TEST(test_rfind);
+    RUN_TEST(test_searcher);
+    RUN_TEST(test_searcher_long);
+    RUN_TEST(test_multisearch);
+    RUN_TEST(test_multisearch_long);
+    RUN_TEST(test_replace_all);
+    RUN_TEST(test_replace_all_long);
+    RUN_TEST(test_replace_all_ch);
     RUN_TEST(test_rfind_ch);
     RUN_TEST(test_rfind_not_ch);
+    RUN_TEST(test_count);
+    RUN_TEST(test_count_ch_long);
+    RUN_TEST(test_find_all);
+    RUN_TEST(test_find_all_long);
+    RUN_TEST(test_charset);
     RUN_TEST(test_find_first_of);
     RUN_TEST(test_find_first_not_of);
     RUN_TEST(test_find_last_of);
     RUN_TEST(test_find_last_not_of);
+    RUN_TEST(test_find_of_long);
+    RUN_TEST(test_find_of_set);
     RUN_TEST(test_starts_with_bytes);
     RUN_TEST(test_starts_with);
     RUN_TEST(test_ends_with_bytes);
@@ -2393,6 +4872,55 @@ int main(void) {
     RUN_TEST(test_contains);
     RUN_TEST(test_strip);
     RUN_TEST(test_strip_ch);
+    RUN_TEST(test_view);
+    RUN_TEST(test_view_cmp);
+    RUN_TEST(test_view_find);
+    RUN_TEST(test_view_strip);
+    RUN_TEST(test_cat_many);
+    RUN_TEST(test_join);
+    RUN_TEST(test_split);
+    RUN_TEST(test_split_options);
+    RUN_TEST(test_split_long);
+    RUN_TEST(test_split_into);
+    RUN_TEST(test_split_into_long);
     RUN_TEST(test_cat_sprintf);
+    RUN_TEST(test_builder);
+    RUN_TEST(test_builder_sprintf);
+#ifdef SSSTR_USE_ALLOCATORS
+    RUN_TEST(test_init_with_allocator);
+    RUN_TEST(test_move_between_allocators);
+#endif
+    RUN_TEST(test_buffer_cache);
+    RUN_TEST(test_usable_size);
+#ifdef SSSTR_USE_ALLOCATORS
+    RUN_TEST(test_arena);
+#endif
+    RUN_TEST(test_rope);
+    RUN_TEST(test_rope_erase_joins_pieces);
+    RUN_TEST(test_rope_random_edits);
+    RUN_TEST(test_gapbuf);
+    RUN_TEST(test_gapbuf_random_edits);
+    RUN_TEST(test_streambuf);
+    RUN_TEST(test_streambuf_stream);
+    RUN_TEST(test_ring);
+    RUN_TEST(test_ring_stream);
+
+#if defined(SSSTR_USE_SSSE3) || defined(SSSTR_USE_AVX2)
+    // Repeat the kernel tests with lower tiers forced.
+    for (simd_tier = 1; simd_tier >= 0; --simd_tier) {
+        RUN_TEST(test_find_bytes_long);
+        RUN_TEST(test_find_bytes_worst_case);
+        RUN_TEST(test_rfind_bytes_long);
+        RUN_TEST(test_rfind_bytes_worst_case);
+        RUN_TEST(test_searcher_long);
+        RUN_TEST(test_multisearch_long);
+        RUN_TEST(test_count_ch_long);
+        RUN_TEST(test_find_all_long);
+        RUN_TEST(test_find_of_long);
+        RUN_TEST(test_find_of_set);
+        RUN_TEST(test_split_long);
+        RUN_TEST(test_split_into_long);
+    }
+#endif
     return UNITY_END();
 }
@@ -1034,6 +1034,32 @@ void test_find(void) {
     ss8_destroy(&s);
 }
 
+void test_multisearch(void) {
+    ss8str s;
+    ss8_init(&s);
+    ss8_multisearch ms;
+    ss8_multisearch_init(&ms);
+    ss8_multisearch_add_cstr(&ms, "x");
+
+    EXPECTING_ASSERTION_FAILURE {
+        ss8_multisearch_find(&ms, &s, 0, NULL);
+        TEST_FAIL_MESSAGE("failed to detect uncompiled multisearch");
+    }
+
+    ss8_multisearch_compile(&ms);
+    EXPECTING_ASSERTION_FAILURE {
+        ss8_multisearch_find(&ms, &s, 1, NULL);
+        TEST_FAIL_MESSAGE("failed to detect out-of-bounds start");
+    }
+    EXPECTING_ASSERTION_FAILURE {
+        ss8_multisearch_find_all(&ms, &s, 1, NULL, NULL);
+        TEST_FAIL_MESSAGE("failed to detect out-of-bounds start");
+    }
+
+    ss8_multisearch_destroy(&ms);
+    ss8_destroy(&s);
+}
+
 void test_find_first_last_of(void) {
     ss8str s;
     ss8_init(&s);
@@ -1493,6 +1519,7 @@ int main(void) {
     RUN_TEST(test_replace);
     RUN_TEST(test_cmp_equals);
     RUN_TEST(test_find);
+    RUN_TEST(test_multisearch);
     RUN_TEST(test_find_first_last_of);
     RUN_TEST(test_starts_ends_contains);
     RUN_TEST(test_strip);
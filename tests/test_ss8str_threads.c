@@ -0,0 +1,57 @@
+/*
+ * This file is part of the Ssstr string library.
+ * Copyright 2022-2023 Board of Regents of the University of Wisconsin System
+ * SPDX-License-Identifier: MIT
+ */
+
+// Tests that distinct strings can be used concurrently from different threads.
+// These are most useful when built with -fsanitize=thread.
+
+#include "ss8str.h"
+
+#include <unity.h>
+
+#include <pthread.h>
+#include <stdint.h>
+
+enum { nthreads = 4, niters = 10000 };
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void *use_strings_without_buffer(void *arg) {
+    uintptr_t failures = 0;
+    (void)arg;
+    for (int i = 0; i < niters; ++i) {
+        ss8str s;
+        ss8_init(&s);
+        ss8_set_growth_policy(&s, SS8_GROWTH_DOUBLE);
+        ss8_clear(&s);
+        ss8_set_len(&s, 0);
+        ss8_copy_bytes(&s, "", 0);
+        ss8_mutable_cstr(&s)[0] = '\0';
+        if (ss8_capacity(&s) != 0 || ss8_cstr(&s)[0] != '\0')
+            ++failures;
+        ss8_destroy(&s);
+    }
+    return (void *)failures;
+}
+
+void test_strings_without_buffer(void) {
+    pthread_t threads[nthreads];
+    for (int i = 0; i < nthreads; ++i)
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[i], NULL,
+                                                use_strings_without_buffer,
+                                                NULL));
+    for (int i = 0; i < nthreads; ++i) {
+        void *failures;
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(threads[i], &failures));
+        TEST_ASSERT_EQUAL_PTR(NULL, failures);
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_strings_without_buffer);
+    return UNITY_END();
+}